@@ -0,0 +1,263 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "auth_manager.h"
+#include "database.h"
+#include "security_logger.h"
+
+using namespace std;
+
+// Генератор нагрузки на путь аутентификации: синтезирует пользователей и
+// атакующие IP, прогоняет фазы смешанной нагрузки через AuthManager и
+// пишет пропускную способность и перцентили задержки в JSON.
+//
+// Использование:
+//   auth_load_bench [--users N] [--ips N] [--ops N] [--rate R] [--output F]
+// --rate задаёт целевую частоту попыток в секунду (0 — без ограничения).
+// Задержка отсчитывается от запланированного момента запуска, поэтому
+// отставание генератора не скрывает очередь (coordinated omission).
+
+namespace {
+
+struct Config {
+  size_t users = 2000;
+  size_t attackerIPs = 256;
+  size_t opsPerPhase = 20000;
+  double rate = 0;
+  string output = "auth_load_bench.json";
+};
+
+struct Attempt {
+  string login;
+  string password;
+  string ip;
+};
+
+struct PhaseResult {
+  string name;
+  size_t operations = 0;
+  double seconds = 0;
+  vector<double> latencies;  // Наносекунды
+  map<string, size_t> outcomes;
+};
+
+string userLogin(size_t index) { return "user" + to_string(index); }
+string userPassword(size_t index) { return "Pw" + to_string(index) + "!Aa"; }
+
+string legitIP(size_t index) {
+  return "192.168." + to_string((index >> 8) & 255) + "." +
+         to_string(index & 255);
+}
+
+string attackerIP(size_t index) {
+  return "10." + to_string((index >> 16) & 255) + "." +
+         to_string((index >> 8) & 255) + "." + to_string(index & 255);
+}
+
+double percentile(const vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+
+PhaseResult runPhase(const string& name, AuthManager& authManager,
+                     const Config& config,
+                     const function<Attempt(size_t)>& generate) {
+  PhaseResult result;
+  result.name = name;
+  result.latencies.reserve(config.opsPerPhase);
+
+  // Попытки генерируются заранее, чтобы не измерять генератор
+  vector<Attempt> attempts;
+  attempts.reserve(config.opsPerPhase);
+  for (size_t i = 0; i < config.opsPerPhase; ++i) attempts.push_back(generate(i));
+
+  auto phaseStart = chrono::steady_clock::now();
+  for (size_t i = 0; i < attempts.size(); ++i) {
+    auto scheduled = chrono::steady_clock::now();
+    if (config.rate > 0) {
+      scheduled = phaseStart + chrono::duration_cast<chrono::nanoseconds>(
+                                   chrono::duration<double>(i / config.rate));
+      this_thread::sleep_until(scheduled);
+    }
+
+    const Attempt& attempt = attempts[i];
+    LoginResult login =
+        authManager.attemptLogin(attempt.login, attempt.password, attempt.ip);
+
+    result.latencies.push_back(
+        chrono::duration<double, nano>(chrono::steady_clock::now() - scheduled)
+            .count());
+    result.outcomes[loginStatusLabel(login.status)]++;
+  }
+  result.seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - phaseStart).count();
+  result.operations = attempts.size();
+  sort(result.latencies.begin(), result.latencies.end());
+  return result;
+}
+
+void writeJson(const string& filename, const Config& config,
+               const vector<PhaseResult>& phases) {
+  ofstream out(filename);
+  out << "{\n  \"benchmark\": \"auth_load\",\n";
+  out << "  \"config\": {\"users\": " << config.users
+      << ", \"attacker_ips\": " << config.attackerIPs
+      << ", \"ops_per_phase\": " << config.opsPerPhase
+      << ", \"target_rate\": " << config.rate << "},\n";
+  out << "  \"phases\": [\n";
+  for (size_t p = 0; p < phases.size(); ++p) {
+    const PhaseResult& phase = phases[p];
+    out << "    {\"name\": \"" << phase.name << "\", \"operations\": "
+        << phase.operations << ", \"seconds\": " << phase.seconds
+        << ", \"throughput_ops\": " << phase.operations / phase.seconds
+        << ",\n     \"latency_ns\": {\"p50\": "
+        << percentile(phase.latencies, 0.50)
+        << ", \"p99\": " << percentile(phase.latencies, 0.99)
+        << ", \"p999\": " << percentile(phase.latencies, 0.999)
+        << ", \"max\": " << percentile(phase.latencies, 1.0) << "},\n";
+
+    out << "     \"outcomes\": {";
+    bool first = true;
+    for (const auto& [status, count] : phase.outcomes) {
+      out << (first ? "" : ", ") << "\"" << status << "\": " << count;
+      first = false;
+    }
+    out << "},\n";
+
+    // Гистограмма с корзинами по степеням двойки (верхняя граница, нс)
+    out << "     \"histogram\": [";
+    size_t index = 0;
+    first = true;
+    for (double bound = 64; index < phase.latencies.size(); bound *= 2) {
+      size_t count = 0;
+      while (index < phase.latencies.size() && phase.latencies[index] <= bound) {
+        ++count;
+        ++index;
+      }
+      if (count == 0) continue;
+      out << (first ? "" : ", ") << "{\"le_ns\": " << bound
+          << ", \"count\": " << count << "}";
+      first = false;
+    }
+    out << "]}" << (p + 1 < phases.size() ? "," : "") << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+bool parseArgs(int argc, char* argv[], Config& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--users") == 0)
+      config.users = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--ips") == 0)
+      config.attackerIPs = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--ops") == 0)
+      config.opsPerPhase = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--rate") == 0)
+      config.rate = atof(argv[i + 1]);
+    else if (strcmp(argv[i], "--output") == 0)
+      config.output = argv[i + 1];
+    else
+      return false;
+  }
+  return config.users > 0 && config.attackerIPs > 0 && config.opsPerPhase > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  if (!parseArgs(argc, argv, config)) {
+    cerr << "Использование: auth_load_bench [--users N] [--ips N] [--ops N] "
+            "[--rate R] [--output F]"
+         << endl;
+    return 1;
+  }
+
+  char dirTemplate[] = "/tmp/auth_load_XXXXXX";
+  if (!mkdtemp(dirTemplate)) {
+    cerr << "Не удалось создать временный каталог" << endl;
+    return 1;
+  }
+  string dir = dirTemplate;
+
+  vector<PhaseResult> phases;
+  {
+    UserDatabase userDB(dir + "/users.dat");
+    SecurityLogger logger(dir + "/security.log");
+    AuthManager authManager(userDB, logger);
+
+    for (size_t i = 0; i < config.users; ++i) {
+      userDB.addUser(userLogin(i), userPassword(i), Role::USER);
+    }
+
+    mt19937_64 rng(2024);
+    auto randomUser = [&]() { return rng() % config.users; };
+
+    // Легитимные входы с собственных адресов пользователей
+    phases.push_back(runPhase("valid_logins", authManager, config, [&](size_t) {
+      size_t user = randomUser();
+      return Attempt{userLogin(user), userPassword(user), legitIP(user)};
+    }));
+
+    // Опечатки в пароле: одиночные ошибки, блокировок почти нет
+    phases.push_back(
+        runPhase("wrong_passwords", authManager, config, [&](size_t) {
+          size_t user = randomUser();
+          return Attempt{userLogin(user), userPassword(user) + "x",
+                         legitIP(user)};
+        }));
+
+    // Перебор несуществующих логинов с множества атакующих адресов
+    phases.push_back(runPhase("spraying", authManager, config, [&](size_t i) {
+      return Attempt{"ghost" + to_string(i), "Spring2024!",
+                     attackerIP(rng() % config.attackerIPs)};
+    }));
+
+    // Шторм блокировок: несколько аккаунтов под атакой с немногих IP
+    phases.push_back(
+        runPhase("lockout_storm", authManager, config, [&](size_t) {
+          size_t victim = rng() % 16;
+          return Attempt{userLogin(victim), "guess" + to_string(rng() % 1000),
+                         attackerIP(rng() % 8)};
+        }));
+
+    // Смесь: 70% легитимных входов, 20% опечаток, 10% атак
+    phases.push_back(runPhase("mixed", authManager, config, [&](size_t i) {
+      size_t roll = rng() % 10;
+      size_t user = randomUser();
+      if (roll < 7)
+        return Attempt{userLogin(user), userPassword(user), legitIP(user)};
+      if (roll < 9)
+        return Attempt{userLogin(user), userPassword(user) + "x",
+                       legitIP(user)};
+      return Attempt{"ghost" + to_string(i), "Password1!",
+                     attackerIP(rng() % config.attackerIPs)};
+    }));
+  }
+
+  for (const PhaseResult& phase : phases) {
+    cout << phase.name << ": " << phase.operations / phase.seconds
+         << " оп/с, p50=" << percentile(phase.latencies, 0.50)
+         << " нс, p99=" << percentile(phase.latencies, 0.99)
+         << " нс, p999=" << percentile(phase.latencies, 0.999) << " нс" << endl;
+  }
+
+  writeJson(config.output, config, phases);
+  cout << "Результаты записаны в " << config.output << endl;
+
+  unlink((dir + "/security.log").c_str());
+  rmdir(dir.c_str());
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "auth_manager.h"
+#include "database.h"
+#include "security_logger.h"
+
+using namespace std;
+
+// Сравнение распределений задержки проверки пароля для существующих
+// (hit) и несуществующих (miss) логинов. Замеры чередуются случайно, чтобы
+// дрейф частоты процессора одинаково влиял на обе выборки.
+//
+// На сотнях тысяч замеров KS-критерий находит разницу в единицы наносекунд,
+// поэтому вердикт выносится тестом эквивалентности: 95% бутстреп-интервалы
+// отношения miss/hit для p50 и p99 должны лежать в пределах ±5%.
+// Использование: auth_timing_bench [пользователей] [замеров]
+
+namespace {
+
+double percentile(const vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0;
+  size_t index = static_cast<size_t>(p * (sorted.size() - 1));
+  return sorted[index];
+}
+
+// Статистика Колмогорова-Смирнова для двух отсортированных выборок
+double ksStatistic(const vector<double>& a, const vector<double>& b) {
+  size_t i = 0, j = 0;
+  double maxDiff = 0;
+  while (i < a.size() && j < b.size()) {
+    double value = min(a[i], b[j]);
+    while (i < a.size() && a[i] <= value) ++i;
+    while (j < b.size() && b[j] <= value) ++j;
+    double diff = fabs(double(i) / a.size() - double(j) / b.size());
+    maxDiff = max(maxDiff, diff);
+  }
+  return maxDiff;
+}
+
+// Бутстреп-интервал (95%) для отношения перцентилей miss/hit
+void bootstrapRatio(const vector<double>& hits, const vector<double>& misses,
+                    double p, mt19937_64& rng, double& low, double& high) {
+  const int ROUNDS = 200;
+  vector<double> ratios, sampleA, sampleB;
+  for (int round = 0; round < ROUNDS; ++round) {
+    sampleA.resize(hits.size());
+    sampleB.resize(misses.size());
+    for (auto& value : sampleA) value = hits[rng() % hits.size()];
+    for (auto& value : sampleB) value = misses[rng() % misses.size()];
+    size_t ia = static_cast<size_t>(p * (sampleA.size() - 1));
+    size_t ib = static_cast<size_t>(p * (sampleB.size() - 1));
+    nth_element(sampleA.begin(), sampleA.begin() + ia, sampleA.end());
+    nth_element(sampleB.begin(), sampleB.begin() + ib, sampleB.end());
+    ratios.push_back(sampleB[ib] / sampleA[ia]);
+  }
+  sort(ratios.begin(), ratios.end());
+  low = ratios[ROUNDS * 25 / 1000];
+  high = ratios[ROUNDS * 975 / 1000];
+}
+
+void printPath(const string& name, const vector<double>& sorted) {
+  cout << name << ": p50=" << percentile(sorted, 0.50)
+       << " нс, p99=" << percentile(sorted, 0.99)
+       << " нс, p99.9=" << percentile(sorted, 0.999) << " нс" << endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t userCount = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000;
+  size_t samples = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+
+  char dirTemplate[] = "/tmp/auth_timing_XXXXXX";
+  if (!mkdtemp(dirTemplate)) {
+    cerr << "Не удалось создать временный каталог" << endl;
+    return 1;
+  }
+  string dir = dirTemplate;
+
+  UserDatabase userDB(dir + "/users.dat");
+  SecurityLogger logger(dir + "/security.log");
+  AuthManager authManager(userDB, logger);
+
+  for (size_t i = 0; i < userCount; ++i) {
+    userDB.addUser("user" + to_string(i), "Password" + to_string(i) + "!",
+                   Role::USER);
+  }
+
+  mt19937_64 rng(42);
+  vector<double> hits, misses;
+  hits.reserve(samples / 2 + 1);
+  misses.reserve(samples / 2 + 1);
+
+  // Прогрев кэшей и предсказателя переходов
+  for (size_t i = 0; i < 10000; ++i) {
+    authManager.verifyCredentials(userDB.getUser("user0"), "warmup");
+  }
+
+  size_t accepted = 0;
+  for (size_t i = 0; i < samples; ++i) {
+    bool hit = rng() & 1;
+    size_t index = rng() % userCount;
+    // Несуществующие логины отличаются от настоящих одним символом, так что
+    // их хэш и сравнение в индексе пользователей стоят столько же
+    string login = "user" + to_string(index) + (hit ? "" : "_");
+    string password = "Wrong" + to_string(index) + "!";
+
+    auto start = chrono::steady_clock::now();
+    optional<UserInfo> userInfo = userDB.getUser(login);
+    accepted += authManager.verifyCredentials(userInfo, password);
+    auto elapsed = chrono::duration<double, nano>(
+                       chrono::steady_clock::now() - start)
+                       .count();
+    (hit ? hits : misses).push_back(elapsed);
+  }
+
+  sort(hits.begin(), hits.end());
+  sort(misses.begin(), misses.end());
+
+  cout << "Пользователей: " << userCount << ", замеров: " << samples
+       << " (hit " << hits.size() << ", miss " << misses.size() << ")" << endl;
+  printPath("Существующий логин   ", hits);
+  printPath("Несуществующий логин ", misses);
+
+  // Критическое значение KS-критерия для уровня значимости 0.05
+  double d = ksStatistic(hits, misses);
+  double critical =
+      1.358 * sqrt(double(hits.size() + misses.size()) /
+                   (double(hits.size()) * misses.size()));
+  cout << "KS-статистика D=" << d << " (критическое значение " << critical
+       << " при alpha=0.05)" << endl;
+
+  const double MARGIN = 0.05;
+  bool equivalent = true;
+  for (double p : {0.50, 0.99}) {
+    double low, high;
+    bootstrapRatio(hits, misses, p, rng, low, high);
+    bool inside = low >= 1 - MARGIN && high <= 1 + MARGIN;
+    equivalent = equivalent && inside;
+    cout << "Отношение miss/hit p" << p * 100 << ": "
+         << percentile(misses, p) / percentile(hits, p) << " (95% ДИ " << low
+         << " - " << high << ")" << (inside ? "" : " вне допуска") << endl;
+  }
+  cout << (equivalent ? "Пути hit и miss статистически неразличимы"
+                      : "Пути hit и miss различимы")
+       << endl;
+
+  if (accepted != 0) cout << "Неожиданно принятых паролей: " << accepted << endl;
+
+  unlink((dir + "/security.log").c_str());
+  rmdir(dir.c_str());
+  return equivalent ? 0 : 2;
+}
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "big_integer.h"
+
+using namespace std;
+
+// Факториал и перевод в десятичную строку для BigInteger: время n! и
+// toString, затем сверка с простыми методами — факториалы до 20 с long
+// long, «разделяй и властвуй» с последовательным делением на 10^9,
+// умножение и деление Кнута через тождество a = q·b + r.
+//
+// Использование: big_integer_bench [n] [потоков]   (по умолчанию 100000, 0)
+
+namespace {
+
+// Старшие цифры 100000! для проверки результата по умолчанию
+const char* const FACTORIAL_100000_PREFIX =
+    "2824229407960347874293421578024535518477494926091224850578918086542977";
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+BigInteger randomInteger(mt19937_64& rng, size_t digits) {
+  string text(digits, '0');
+  text[0] = static_cast<char>('1' + rng() % 9);
+  for (size_t i = 1; i < digits; ++i) text[i] = static_cast<char>('0' + rng() % 10);
+  if (rng() % 2) text.insert(text.begin(), '-');
+  BigInteger value;
+  string error;
+  BigInteger::fromString(text, value, error);
+  return value;
+}
+
+// Последовательный перевод делением на 10^9 — эталон для toString
+string naiveToString(const BigInteger& value) {
+  if (value.isZero()) return "0";
+  BigInteger rest = value.isNegative() ? -value : value;
+  const BigInteger base(1000000000);
+  string digits;
+  while (!rest.isZero()) {
+    BigInteger quotient, remainder;
+    BigInteger::divide(rest, base, quotient, remainder);
+    long long chunk = remainder.isZero() ? 0 : remainder.getLimbs()[0];
+    for (int i = 0; i < 9; ++i) {
+      digits.push_back(static_cast<char>('0' + chunk % 10));
+      chunk /= 10;
+    }
+    rest = quotient;
+  }
+  while (digits.size() > 1 && digits.back() == '0') digits.pop_back();
+  if (value.isNegative()) digits.push_back('-');
+  return string(digits.rbegin(), digits.rend());
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t n = argc > 1 ? static_cast<uint32_t>(strtoul(argv[1], nullptr, 10))
+                        : 100000;
+  unsigned threads =
+      argc > 2 ? static_cast<unsigned>(strtoul(argv[2], nullptr, 10)) : 0;
+
+  auto start = chrono::steady_clock::now();
+  BigInteger value = BigInteger::factorial(n, threads);
+  double factorialSeconds = secondsSince(start);
+
+  start = chrono::steady_clock::now();
+  string digits = value.toString(threads);
+  double conversionSeconds = secondsSince(start);
+
+  size_t trailingZeros = digits.size() - 1 - digits.find_last_not_of('0');
+  cout << n << "!: " << digits.size() << " цифр, " << trailingZeros
+       << " нулей в конце, " << value.bitLength() << " бит" << endl;
+  cout << "  начало: " << digits.substr(0, 40) << "..." << endl;
+  cout << "  факториал: " << factorialSeconds * 1000 << " мс" << endl;
+  cout << "  toString:  " << conversionSeconds * 1000 << " мс" << endl;
+
+  bool allMatch = true;
+  if (n == 100000 &&
+      digits.compare(0, strlen(FACTORIAL_100000_PREFIX),
+                     FACTORIAL_100000_PREFIX) != 0) {
+    cout << "ОШИБКА: старшие цифры 100000! не совпадают" << endl;
+    allMatch = false;
+  }
+
+  long long expected = 1;
+  for (uint32_t i = 0; i <= 20; ++i) {
+    if (i > 1) expected *= i;
+    if (BigInteger::factorial(i).toString() != to_string(expected)) {
+      cout << "ОШИБКА: " << i << "! не совпадает с long long" << endl;
+      allMatch = false;
+    }
+  }
+
+  mt19937_64 rng(39);
+  size_t checks = 0;
+  for (size_t digitsCount : {1, 9, 10, 50, 400, 1000, 5000, 20000, 60000}) {
+    for (int round = 0; round < 3; ++round) {
+      BigInteger a = randomInteger(rng, digitsCount);
+      BigInteger b = randomInteger(rng, digitsCount / 2 + 1 + rng() % 50);
+
+      string text = a.toString(threads);
+      BigInteger parsed;
+      string error;
+      bool ok = text == naiveToString(a) &&
+                BigInteger::fromString(text, parsed, error) && parsed == a;
+
+      BigInteger quotient, remainder;
+      BigInteger::divide(a * b, b, quotient, remainder);
+      ok = ok && quotient == a && remainder.isZero();
+
+      BigInteger::divide(a, b, quotient, remainder);
+      BigInteger absRemainder = remainder.isNegative() ? -remainder : remainder;
+      BigInteger absB = b.isNegative() ? -b : b;
+      ok = ok && quotient * b + remainder == a && absRemainder < absB;
+
+      if (!ok) {
+        cout << "ОШИБКА: несовпадение для числа из " << digitsCount << " цифр"
+             << endl;
+        allMatch = false;
+      }
+      ++checks;
+    }
+  }
+
+  cout << "Сверка с простыми методами: " << checks << " чисел, "
+       << (allMatch ? "расхождений нет" : "есть расхождения") << endl;
+  return allMatch ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "batch_processor.h"
+#include "calculator_engine.h"
+#include "expression_engine.h"
+
+using namespace std;
+
+// Сравнение CalculatorEngine::calculateBatch с циклом по calculate /
+// calculateAdvanced: совпадение результатов и статусов по битам и скорость.
+// Четверть делителей — нули, четверть аргументов корня и логарифма —
+// отрицательные, чтобы путь ошибок тоже попадал в замер. Перед замером
+// проверяются входы, на которых ядра уже ошибались.
+//
+// Использование: calculator_batch_bench [элементов]
+
+namespace {
+
+bool sameValue(double x, double y) {
+  return (isnan(x) && isnan(y)) || memcmp(&x, &y, sizeof(double)) == 0;
+}
+
+// Каждый вход должен завершиться ошибкой, а не результатом
+bool checkRegressions(CalculatorEngine& engine) {
+  BatchProcessor processor(engine, Role::ADMIN);
+  ExpressionEngine expressions(Role::ADMIN);
+  bool ok = true;
+
+  // from_chars принимает "nan"; факториал приводил NaN к int
+  for (const string line : {"! nan", "! -nan", "! inf"}) {
+    string out;
+    BatchStats stats;
+    processor.evaluateLines(line.data(), line.data() + line.size(), out,
+                            stats);
+    cout << "  пакет \"" << line << "\": " << out;
+    ok = ok && stats.errors == 1;
+  }
+  for (const char* source : {"fact(pow(-1, 0.5))",
+                             "fact(pow(0, -1) - pow(0, -1))"}) {
+    auto result = expressions.evaluate(source);
+    cout << "  выражение " << source << ": "
+         << (result.success ? to_string(result.value) : result.errorMessage)
+         << endl;
+    ok = ok && !result.success;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 1000000;
+
+  mt19937_64 rng(38);
+  uniform_real_distribution<double> values(-100.0, 100.0);
+  vector<double> a(count), b(count), out(count);
+  vector<uint8_t> status(count);
+  for (size_t i = 0; i < count; ++i) {
+    a[i] = values(rng);
+    b[i] = rng() % 4 == 0 ? 0.0 : values(rng) / 10;
+  }
+
+  CalculatorEngine engine;
+  cout << "Ядро: " << CalculatorEngine::batchKernelName() << ", элементов: "
+       << count << endl;
+
+  bool allMatch = checkRegressions(engine);
+  if (!allMatch) cout << "Регрессия: ошибочный вход дал результат" << endl;
+  for (char op : {'+', '-', '*', '/', '^', 's', 'l'}) {
+    bool unary = op == 's' || op == 'l';
+
+    auto start = chrono::steady_clock::now();
+    engine.calculateBatch(op, a, b, out, status);
+    double batchSeconds =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    size_t mismatches = 0;
+    for (size_t i = 0; i < count; ++i) {
+      auto result = unary ? engine.calculateAdvanced(op, a[i])
+                          : engine.calculate(op, a[i], b[i]);
+      bool same = result.success == (status[i] == CalculatorEngine::BATCH_OK);
+      if (result.success) {
+        same = same && sameValue(result.value, out[i]);
+      } else {
+        same = same && result.errorMessage ==
+                           CalculatorEngine::batchStatusMessage(op, status[i]);
+      }
+      mismatches += !same;
+    }
+    double scalarSeconds =
+        chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    allMatch = allMatch && mismatches == 0;
+    cout << "  " << op << ": пакетно " << count / batchSeconds / 1e6
+         << " млн/с, поэлементно " << count / scalarSeconds / 1e6
+         << " млн/с, ускорение " << scalarSeconds / batchSeconds
+         << "x, расхождений: " << mismatches << endl;
+  }
+  return allMatch ? 0 : 1;
+}
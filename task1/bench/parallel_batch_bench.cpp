@@ -0,0 +1,121 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "parallel_batch.h"
+
+using namespace std;
+
+// Параллельный пакетный режим против последовательного на одном файле:
+// вывод при любом числе потоков должен совпадать байт в байт, а время
+// каждой стадии показывает, где конвейер упирается — в вычисление, в
+// запись или в ожидание соседней стадии.
+//
+// Использование: parallel_batch_bench [строк] [потоков] [фрагмент, КБ]
+
+namespace {
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Смесь всех операций с ошибками, комментариями и пустыми строками
+void writeInput(const string& path, size_t lines) {
+  static const char* const templates[] = {"+ %g %g", "- %g %g", "* %g %g",
+                                          "/ %g %g", "^ %g %g", "! %g",
+                                          "s %g",    "l %g"};
+  mt19937_64 rng(43);
+  uniform_real_distribution<double> value(-50, 200);
+  ofstream out(path);
+  char buffer[96];
+  for (size_t i = 0; i < lines; ++i) {
+    if (i % 97 == 0) {
+      out << "# комментарий\n\n";
+    } else if (i % 89 == 0) {
+      out << "x 1 2\n";
+    } else {
+      const char* pattern = templates[rng() % size(templates)];
+      double a = pattern[0] == '!' ? double(rng() % 180) : value(rng);
+      snprintf(buffer, sizeof(buffer), pattern, a, value(rng) / 10);
+      out << buffer << '\n';
+    }
+  }
+}
+
+string readFile(const string& path) {
+  ifstream in(path);
+  ostringstream content;
+  content << in.rdbuf();
+  return content.str();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t lines = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+  unsigned maxThreads = argc > 2 ? static_cast<unsigned>(atoi(argv[2]))
+                                 : max(2u, thread::hardware_concurrency());
+  size_t chunkSize = argc > 3 ? strtoull(argv[3], nullptr, 10) << 10
+                              : ParallelBatchPipeline::DEFAULT_CHUNK_SIZE;
+
+  string prefix = "/tmp/parallel_batch_bench." + to_string(getpid());
+  string inputPath = prefix + ".in";
+  string outputPath = prefix + ".out";
+  writeInput(inputPath, lines);
+
+  CalculatorEngine engine;
+  BatchProcessor processor(engine, Role::ADMIN);
+
+  int inputFd = open(inputPath.c_str(), O_RDONLY);
+  int outputFd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  BatchStats sequential;
+  string error;
+  auto start = chrono::steady_clock::now();
+  bool ok = processor.run(inputFd, outputFd, sequential, error);
+  double sequentialSeconds = secondsSince(start);
+  close(inputFd);
+  close(outputFd);
+  string expected = readFile(outputPath);
+
+  cout << lines << " строк, " << sequential.bytesIn / (1 << 20)
+       << " МБ, фрагмент " << chunkSize / 1024 << " КБ" << endl;
+  cout << "Последовательно: " << sequentialSeconds * 1000 << " мс ("
+       << sequential.lines / sequentialSeconds / 1e6 << " млн/с)" << endl;
+
+  bool allMatch = ok;
+  for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+    outputFd = open(outputPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ParallelBatchPipeline pipeline(processor, threads, chunkSize);
+    PipelineStats stats;
+    ok = pipeline.run(inputPath, outputFd, stats, error);
+    close(outputFd);
+    bool match = ok && readFile(outputPath) == expected &&
+                 stats.totals.lines == sequential.lines &&
+                 stats.totals.errors == sequential.errors;
+    allMatch = allMatch && match;
+
+    cout << threads << " потоков: " << stats.wallSeconds * 1000 << " мс ("
+         << stats.totals.lines / stats.wallSeconds / 1e6 << " млн/с, "
+         << sequentialSeconds / stats.wallSeconds << "x), фрагментов "
+         << stats.chunks << ", перехвачено " << stats.steals << ", буфер "
+         << stats.maxBuffered << (match ? "" : " — ВЫВОД РАСХОДИТСЯ") << endl;
+    cout << "  разбиение " << stats.splitSeconds * 1000 << " мс, ожидание "
+         << "чтения " << stats.readerWaitSeconds * 1000 << " мс, вычисление "
+         << stats.evaluateSeconds * 1000 << " мс, запись "
+         << stats.writeSeconds * 1000 << " мс, ожидание записи "
+         << stats.writerWaitSeconds * 1000 << " мс" << endl;
+  }
+
+  unlink(inputPath.c_str());
+  unlink(outputPath.c_str());
+  if (!error.empty()) cout << error << endl;
+  cout << (allMatch ? "Вывод совпадает" : "ОШИБКА: вывод расходится") << endl;
+  return allMatch ? 0 : 1;
+}
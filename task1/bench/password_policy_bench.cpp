@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "password_policy.h"
+
+using namespace std;
+
+// Сравнение PasswordPolicy::validatePassword с прежней реализацией на
+// std::regex: совпадение вердиктов и пропускная способность.
+// Использование: password_policy_bench [кандидатов] [кандидатов для regex]
+
+namespace {
+
+// Прежняя реализация проверки классов символов (эталон)
+PasswordPolicy::ValidationResult legacyValidate(const string& password) {
+  if (password.length() < 8) {
+    return {false, "Пароль должен содержать не менее 8 символов"};
+  }
+  if (!regex_search(password, regex("[A-ZА-Я]"))) {
+    return {false, "Пароль должен содержать заглавные буквы"};
+  }
+  if (!regex_search(password, regex("[a-zа-я]"))) {
+    return {false, "Пароль должен содержать строчные буквы"};
+  }
+  if (!regex_search(password, regex("[0-9]"))) {
+    return {false, "Пароль должен содержать цифры"};
+  }
+  if (!regex_search(password,
+                    regex("[!@#$%^&*()_+\\-=\\[\\]{};':\"\\\\|,.<>\\/?]"))) {
+    return {false, "Пароль должен содержать специальные символы"};
+  }
+  return {true, ""};
+}
+
+vector<string> generateCandidates(size_t count, mt19937_64& rng) {
+  static const vector<string> cyrillic = {"А", "Я", "Ж", "а", "я", "ж", "ё"};
+  vector<string> candidates;
+  candidates.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    size_t length = 4 + rng() % 20;
+    string candidate;
+    for (size_t k = 0; k < length; ++k) {
+      if (rng() % 20 == 0) {
+        candidate += cyrillic[rng() % cyrillic.size()];
+      } else {
+        candidate += static_cast<char>(0x20 + rng() % 95);  // Печатный ASCII
+      }
+    }
+    candidates.push_back(candidate);
+  }
+  return candidates;
+}
+
+bool isAscii(const string& text) {
+  return all_of(text.begin(), text.end(),
+                [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t count = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+  size_t regexCount = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100000;
+  regexCount = min(regexCount, count);
+
+  mt19937_64 rng(7);
+  vector<string> candidates = generateCandidates(count, rng);
+  PasswordPolicy policy;
+
+  // Сравнение классов символов: проверка распространённых
+  // последовательностей одинакова в обеих версиях и сюда не входит
+  size_t asciiMismatches = 0, utf8Differences = 0;
+  for (size_t i = 0; i < regexCount; ++i) {
+    auto expected = legacyValidate(candidates[i]);
+    auto actual = policy.validatePassword(candidates[i]);
+    // Оценка стойкости выставляется только после проверки классов
+    bool actualClassesOk =
+        actual.isValid || actual.score >= 0 ||
+        actual.message.find("распространённую") != string::npos;
+    bool same = expected.isValid == actualClassesOk &&
+                (expected.isValid || expected.message == actual.message);
+    if (!same) {
+      if (isAscii(candidates[i]))
+        asciiMismatches++;
+      else
+        utf8Differences++;
+    }
+  }
+
+  auto start = chrono::steady_clock::now();
+  size_t legacyValid = 0;
+  for (size_t i = 0; i < regexCount; ++i) {
+    legacyValid += legacyValidate(candidates[i]).isValid;
+  }
+  double legacySeconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  start = chrono::steady_clock::now();
+  size_t valid = 0;
+  for (const string& candidate : candidates) {
+    valid += policy.validatePassword(candidate).isValid;
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  start = chrono::steady_clock::now();
+  size_t classBits = 0;
+  for (const string& candidate : candidates) {
+    classBits += CharClassifier::classify(candidate);
+  }
+  double classifySeconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << "Сверено с regex: " << regexCount << " кандидатов, расхождений "
+       << "на ASCII: " << asciiMismatches
+       << ", на UTF-8 (исправленная кириллица): " << utf8Differences << endl;
+  cout << "std::regex:        " << regexCount / legacySeconds / 1e6
+       << " млн проверок/с (" << legacyValid << " без замечаний)" << endl;
+  cout << "validatePassword:  " << count / seconds / 1e6 << " млн проверок/с ("
+       << valid << " надёжных)" << endl;
+  cout << "CharClassifier:    " << count / classifySeconds / 1e6
+       << " млн строк/с (" << classBits << ")" << endl;
+  return asciiMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rate_limiter.h"
+
+using namespace std;
+
+// Нагрузочный тест RateLimiter: несколько потоков проверяют случайные ключи
+// из общего пула. Использование: rate_limiter_bench [потоки] [проверок на поток]
+int main(int argc, char* argv[]) {
+  unsigned threadCount = argc > 1 ? atoi(argv[1]) : thread::hardware_concurrency();
+  size_t checksPerThread = argc > 2 ? strtoull(argv[2], nullptr, 10) : 5000000;
+  if (threadCount == 0) threadCount = 1;
+
+  const size_t KEY_COUNT = 100000;
+  vector<string> keys;
+  keys.reserve(KEY_COUNT);
+  for (size_t i = 0; i < KEY_COUNT; ++i) {
+    keys.push_back("10." + to_string((i >> 16) & 255) + "." +
+                   to_string((i >> 8) & 255) + "." + to_string(i & 255));
+  }
+
+  // Проверка семантики: ровно limit событий подряд, затем отказ
+  RateLimiter sanity({5, 60}, 1024);
+  int allowed = 0;
+  for (int i = 0; i < 10; ++i) allowed += sanity.tryAcquire("probe");
+  cout << "Проверка лимита 5/60с: разрешено " << allowed << " из 10" << endl;
+
+  RateLimiter limiter({20, 60}, 1 << 18);
+  vector<thread> workers;
+  vector<size_t> allowedPerThread(threadCount, 0);
+
+  auto start = chrono::steady_clock::now();
+  for (unsigned t = 0; t < threadCount; ++t) {
+    workers.emplace_back([&, t]() {
+      uint64_t state = 0x9e3779b97f4a7c15ULL * (t + 1);
+      size_t localAllowed = 0;
+      for (size_t i = 0; i < checksPerThread; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        localAllowed += limiter.tryAcquire(keys[state % KEY_COUNT]);
+      }
+      allowedPerThread[t] = localAllowed;
+    });
+  }
+  for (auto& worker : workers) worker.join();
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  size_t totalChecks = checksPerThread * threadCount;
+  size_t totalAllowed = 0;
+  for (size_t value : allowedPerThread) totalAllowed += value;
+
+  cout << "Потоков: " << threadCount << endl;
+  cout << "Проверок: " << totalChecks << " за " << seconds << " с" << endl;
+  cout << "Пропускная способность: " << totalChecks / seconds / 1e6
+       << " млн проверок/с" << endl;
+  cout << "Разрешено: " << totalAllowed << ", переполнений таблицы: "
+       << limiter.getOverflowCount() << endl;
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "calculator_engine.h"
+
+using namespace std;
+
+// Кэш результатов целочисленного режима на повторяющейся нагрузке: входы
+// факториала и степени выбираются по закону Ципфа из ограниченного набора,
+// как при воспроизведении реальных запросов. Сравнивается время с кэшем и
+// без него, затем тот же поток запросов идёт из нескольких потоков с
+// изоляцией по пользователям.
+//
+// Использование: result_cache_bench [запросов] [память кэша, МБ] [потоков]
+
+namespace {
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Индексы 0..n-1 с вероятностью ~ 1/(i+1)
+vector<size_t> zipfIndices(size_t count, size_t n, uint64_t seed) {
+  vector<double> cumulative(n);
+  double sum = 0;
+  for (size_t i = 0; i < n; ++i) cumulative[i] = sum += 1.0 / double(i + 1);
+  mt19937_64 rng(seed);
+  uniform_real_distribution<double> uniform(0, sum);
+  vector<size_t> indices(count);
+  for (size_t& index : indices) {
+    index = static_cast<size_t>(
+        lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) -
+        cumulative.begin());
+  }
+  return indices;
+}
+
+void printStats(const ResultCacheStats& stats) {
+  size_t lookups = stats.hits + stats.misses;
+  cout << "  попаданий " << stats.hits << " из " << lookups << " ("
+       << (lookups ? 100.0 * stats.hits / lookups : 0) << "%), вытеснений "
+       << stats.evictions << ", записей " << stats.entries << ", "
+       << stats.bytes / 1024 << " КБ" << endl;
+}
+
+// Запросы i, i + step, ...: нечётные входы — факториал, чётные — 3^k.
+// Возвращает суммарное число цифр для сверки.
+size_t runRequests(CalculatorEngine& engine, const vector<size_t>& indices,
+                   size_t first, size_t step, uint32_t scope) {
+  size_t digits = 0;
+  for (size_t i = first; i < indices.size(); i += step) {
+    size_t index = indices[i];
+    auto result =
+        index % 2
+            ? engine.calculateInteger('!', to_string(500 + index * 10), "",
+                                      scope)
+            : engine.calculateInteger('^', "3", to_string(5000 + index * 50),
+                                      scope);
+    digits += result.value.size();
+  }
+  return digits;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t requests = argc > 1 ? strtoull(argv[1], nullptr, 10) : 3000;
+  size_t budgetMb = argc > 2 ? strtoull(argv[2], nullptr, 10) : 32;
+  unsigned threads = argc > 3 ? static_cast<unsigned>(atoi(argv[3]))
+                              : max(2u, thread::hardware_concurrency());
+
+  vector<size_t> indices = zipfIndices(requests, 400, 41);
+
+  CalculatorEngine plain;
+  auto start = chrono::steady_clock::now();
+  size_t expected = runRequests(plain, indices, 0, 1, 0);
+  double plainSeconds = secondsSince(start);
+
+  ResultCacheConfig config;
+  config.memoryBudget = budgetMb << 20;
+  CalculatorEngine cached;
+  cached.enableResultCache(config);
+  start = chrono::steady_clock::now();
+  size_t actual = runRequests(cached, indices, 0, 1, 0);
+  double cachedSeconds = secondsSince(start);
+  bool allMatch = expected == actual;
+
+  cout << requests << " запросов, 400 различных входов, кэш " << budgetMb
+       << " МБ" << endl;
+  cout << "Без кэша: " << plainSeconds * 1000 << " мс, с кэшем: "
+       << cachedSeconds * 1000 << " мс (ускорение "
+       << plainSeconds / cachedSeconds << "x)" << endl;
+  printStats(cached.getCacheStats());
+
+  // Каждый поток — отдельный пользователь со своей областью кэша
+  config.isolateUsers = true;
+  CalculatorEngine isolated;
+  isolated.enableResultCache(config);
+  vector<size_t> digits(threads);
+  vector<thread> workers;
+  start = chrono::steady_clock::now();
+  for (unsigned t = 0; t < threads; ++t) {
+    workers.emplace_back([&, t] {
+      uint32_t scope = isolated.cacheScope("user" + to_string(t));
+      digits[t] = runRequests(isolated, indices, t, threads, scope);
+    });
+  }
+  for (thread& worker : workers) worker.join();
+  double isolatedSeconds = secondsSince(start);
+  size_t total = 0;
+  for (size_t count : digits) total += count;
+  allMatch = allMatch && total == expected;
+
+  cout << threads << " пользователей в своих потоках: "
+       << isolatedSeconds * 1000 << " мс" << endl;
+  printStats(isolated.getCacheStats());
+
+  cout << (allMatch ? "Результаты совпадают" : "ОШИБКА: результаты расходятся")
+       << endl;
+  return allMatch ? 0 : 1;
+}
@@ -0,0 +1,426 @@
+#include <stdlib.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "calculator_engine.h"
+#include "database.h"
+#include "expression_engine.h"
+#include "hash_generator.h"
+#include "password_policy.h"
+#include "security_logger.h"
+
+using namespace std;
+
+// Микробенчмарки всех подсистем: хэширование паролей, база пользователей
+// (загрузка, сохранение, поиск) на 1 тыс. — 10 млн записей, проверка
+// политики паролей, журнал безопасности и операции калькулятора.
+//
+// Каждый случай сначала подбирает число итераций так, чтобы повтор длился
+// не меньше --min-time, затем прогревается и измеряется --repetitions раз.
+// Итог — среднее, медиана, разброс и крайние значения в нс на операцию;
+// таблица печатается в stderr, полный отчёт пишется в JSON.
+//
+// Использование:
+//   secure_calc_bench [--filter подстрока] [--repetitions N] [--min-time мс]
+//                     [--warmup мс] [--max-users N] [--output F|-]
+// База на 10 млн пользователей занимает в памяти около 3 ГБ, поэтому по
+// умолчанию размеры ограничены миллионом: --max-users 10000000.
+
+namespace {
+
+struct Config {
+  string filter;
+  size_t repetitions = 10;
+  double minTimeMs = 20;
+  double warmupMs = 50;
+  size_t maxUsers = 1000000;
+  string output = "secure_calc_bench.json";
+};
+
+struct CaseResult {
+  string group;
+  string name;
+  string params;
+  size_t iterations = 0;
+  vector<double> nsPerOp;  // По одному значению на повтор
+  double mean = 0;
+  double median = 0;
+  double stddev = 0;
+};
+
+// Результаты складываются сюда, чтобы компилятор не выбросил вычисления
+volatile size_t sink = 0;
+
+using Clock = chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Долгие случаи (загрузка большой базы) ограничены бюджетом времени, но
+// повторяются не меньше MIN_REPETITIONS раз
+const size_t MIN_REPETITIONS = 3;
+const double CASE_BUDGET_SECONDS = 10;
+
+class Runner {
+ public:
+  explicit Runner(const Config& config) : config(config) {}
+
+  // body(n) выполняет операцию n раз
+  void run(const string& group, const string& name, const string& params,
+           const function<void(size_t)>& body) {
+    string fullName = group + "/" + name + (params.empty() ? "" : "/") + params;
+    if (!config.filter.empty() && fullName.find(config.filter) == string::npos) {
+      return;
+    }
+
+    // Подбор числа итераций на повтор
+    double minTime = config.minTimeMs / 1000;
+    size_t iterations = 1;
+    while (true) {
+      auto start = Clock::now();
+      body(iterations);
+      double seconds = secondsSince(start);
+      if (seconds >= minTime) break;
+      double scale = seconds > 0 ? minTime / seconds * 1.2 : 10;
+      iterations = static_cast<size_t>(
+          ceil(iterations * clamp(scale, 2.0, 100.0)));
+    }
+
+    auto warmupStart = Clock::now();
+    while (secondsSince(warmupStart) < config.warmupMs / 1000) body(iterations);
+
+    CaseResult result{group, name, params, iterations, {}, 0, 0, 0};
+    double spent = 0;
+    for (size_t r = 0; r < config.repetitions; ++r) {
+      if (r >= MIN_REPETITIONS && spent > CASE_BUDGET_SECONDS) break;
+      auto start = Clock::now();
+      body(iterations);
+      double seconds = secondsSince(start);
+      spent += seconds;
+      result.nsPerOp.push_back(seconds * 1e9 / iterations);
+    }
+
+    vector<double> sorted = result.nsPerOp;
+    sort(sorted.begin(), sorted.end());
+    size_t n = sorted.size();
+    for (double value : sorted) result.mean += value / n;
+    result.median = n % 2 ? sorted[n / 2]
+                          : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    for (double value : sorted) {
+      result.stddev += (value - result.mean) * (value - result.mean);
+    }
+    result.stddev = n > 1 ? sqrt(result.stddev / (n - 1)) : 0;
+
+    cerr << left << setw(44) << fullName << right << setw(14) << fixed
+         << setprecision(1) << result.median << " нс  ±" << setw(5)
+         << (result.mean > 0 ? 100 * result.stddev / result.mean : 0)
+         << "%  (" << iterations << " x " << n << ")" << endl;
+    results.push_back(std::move(result));
+  }
+
+  void writeJson(ostream& out) const {
+    out << "{\n  \"benchmark\": \"secure_calc\",\n";
+    out << "  \"config\": {\"repetitions\": " << config.repetitions
+        << ", \"min_time_ms\": " << config.minTimeMs
+        << ", \"warmup_ms\": " << config.warmupMs
+        << ", \"max_users\": " << config.maxUsers << "},\n";
+    out << "  \"results\": [\n";
+    out << setprecision(2) << fixed;
+    for (size_t i = 0; i < results.size(); ++i) {
+      const CaseResult& result = results[i];
+      auto [minimum, maximum] =
+          minmax_element(result.nsPerOp.begin(), result.nsPerOp.end());
+      out << "    {\"group\": \"" << result.group << "\", \"name\": \""
+          << result.name << "\", \"params\": \"" << result.params
+          << "\", \"iterations\": " << result.iterations
+          << ", \"repetitions\": " << result.nsPerOp.size()
+          << ",\n     \"ns_per_op\": {\"mean\": " << result.mean
+          << ", \"median\": " << result.median
+          << ", \"stddev\": " << result.stddev << ", \"min\": " << *minimum
+          << ", \"max\": " << *maximum << "}}"
+          << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+  }
+
+ private:
+  const Config& config;
+  vector<CaseResult> results;
+};
+
+// Синтетические данные с фиксированным зерном: прогоны сравнимы между собой
+class SyntheticData {
+ public:
+  explicit SyntheticData(uint64_t seed) : rng(seed) {}
+
+  static string login(size_t index) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "user%08zu", index);
+    return buffer;
+  }
+
+  // Строка в формате SecurePasswordHasher ("соль|хэш") без вычисления
+  // хэша: для базы на миллионы записей настоящее хэширование дольше самого
+  // измерения, а на разбор и поиск содержимое хэша не влияет.
+  string fakeHash() {
+    static const char HEX[] = "0123456789abcdef";
+    string hash(49, '|');
+    for (size_t i = 0; i < hash.size(); ++i) {
+      if (i != 32) hash[i] = HEX[rng() & 15];
+    }
+    return hash;
+  }
+
+  // Файл базы в формате UserDatabase, зашифрованный ключом key
+  void writeDatabase(const string& path, size_t users, const string& key) {
+    string data;
+    data.reserve(users * 64);
+    for (size_t i = 0; i < users; ++i) {
+      data += login(i);
+      data += i % 100 == 0 ? ":2:" : ":1:";
+      data += i % 50 == 0 ? "0:" : "1:";
+      data += fakeHash();
+      data += '\n';
+    }
+    for (size_t i = 0; i < data.size(); ++i) data[i] ^= key[i % key.size()];
+    ofstream(path, ios::binary) << data;
+  }
+
+  // Пароли трёх видов: случайные стойкие, слабые шаблонные и короткие
+  vector<string> passwords(const string& kind, size_t count) {
+    static const char* const WORDS[] = {"password", "qwerty", "dragon",
+                                        "monkey",   "letmein", "sunshine"};
+    static const char SYMBOLS[] = "!@#$%^&*";
+    vector<string> result;
+    for (size_t i = 0; i < count; ++i) {
+      string password;
+      if (kind == "strong") {
+        for (int j = 0; j < 14; ++j) {
+          password += static_cast<char>(j % 4 == 0   ? 'A' + rng() % 26
+                                        : j % 4 == 1 ? '0' + rng() % 10
+                                        : j % 4 == 2 ? SYMBOLS[rng() % 8]
+                                                     : 'a' + rng() % 26);
+        }
+      } else if (kind == "weak") {
+        password = WORDS[rng() % size(WORDS)] + to_string(rng() % 1000);
+        password[0] = static_cast<char>(toupper(password[0]));
+        password += '!';
+      } else {
+        password = "Ab1!" + to_string(rng() % 100);
+      }
+      result.push_back(password);
+    }
+    return result;
+  }
+
+ private:
+  mt19937_64 rng;
+};
+
+void benchHasher(Runner& runner) {
+  const string password = "Correct-Horse-42";
+  const string stored = SecurePasswordHasher::hashPassword(password);
+
+  runner.run("hasher", "generate_salt", "", [](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + SecurePasswordHasher::generateSalt().size();
+    }
+  });
+  runner.run("hasher", "hash_password", "", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + SecurePasswordHasher::hashPassword(password).size();
+    }
+  });
+  runner.run("hasher", "verify_password", "match", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + SecurePasswordHasher::verifyPassword(password, stored);
+    }
+  });
+  runner.run("hasher", "verify_password", "mismatch", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + SecurePasswordHasher::verifyPassword("wrong", stored);
+    }
+  });
+}
+
+void benchDatabase(Runner& runner, const Config& config, const string& dir) {
+  const string key = "secure_calc_bench_key";
+  for (size_t users = 1000; users <= config.maxUsers; users *= 10) {
+    SyntheticData data(users);
+    string path = dir + "/users_" + to_string(users) + ".dat";
+    data.writeDatabase(path, users, key);
+    string params = "users=" + to_string(users);
+
+    UserDatabase userDB(path);
+    runner.run("database", "load", params, [&](size_t n) {
+      for (size_t i = 0; i < n; ++i) sink = sink + userDB.loadUsers(key);
+    });
+    runner.run("database", "save", params, [&](size_t n) {
+      for (size_t i = 0; i < n; ++i) sink = sink + userDB.saveUsers(key);
+    });
+
+    // Логины для поиска выбираются заранее, чтобы не измерять генератор
+    mt19937_64 rng(users);
+    vector<string> present, missing;
+    for (size_t i = 0; i < 4096; ++i) {
+      present.push_back(SyntheticData::login(rng() % users));
+      missing.push_back(SyntheticData::login(users + rng() % users));
+    }
+    runner.run("database", "lookup_hit", params, [&](size_t n) {
+      for (size_t i = 0; i < n; ++i) {
+        sink = sink + userDB.userExists(present[i & 4095]);
+      }
+    });
+    runner.run("database", "lookup_miss", params, [&](size_t n) {
+      for (size_t i = 0; i < n; ++i) {
+        sink = sink + userDB.userExists(missing[i & 4095]);
+      }
+    });
+
+    filesystem::remove(path);
+  }
+}
+
+void benchPolicy(Runner& runner) {
+  PasswordPolicy policy;
+  SyntheticData data(45);
+  for (const char* kind : {"strong", "weak", "short"}) {
+    vector<string> passwords = data.passwords(kind, 1024);
+    runner.run("policy", "validate_password", kind, [&](size_t n) {
+      for (size_t i = 0; i < n; ++i) {
+        sink = sink + policy.validatePassword(passwords[i & 1023]).isValid;
+      }
+    });
+  }
+}
+
+void benchLogger(Runner& runner, const string& dir) {
+  SecurityLogger logger(dir + "/security.log");
+  runner.run("logger", "log_security_event", "", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      logger.logSecurityEvent("Benchmark event", "iteration");
+    }
+  });
+  runner.run("logger", "log_login_failure", "", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      logger.logLoginFailure("user00000042", "10.0.0.1", "bad password");
+    }
+  });
+}
+
+void benchCalculator(Runner& runner) {
+  CalculatorEngine engine;
+  for (char op : {'+', '/', '^'}) {
+    runner.run("calculator", "calculate", string(1, op), [&](size_t n) {
+      double a = 1.5;
+      for (size_t i = 0; i < n; ++i) {
+        auto result = engine.calculate(op, a, 1.000001);
+        a = result.success ? fmod(result.value, 1000) + 1.5 : 1.5;
+      }
+      sink = sink + static_cast<size_t>(a);
+    });
+  }
+  for (char op : {'!', 's', 'l'}) {
+    runner.run("calculator", "calculate_advanced", string(1, op),
+               [&](size_t n) {
+                 for (size_t i = 0; i < n; ++i) {
+                   auto result =
+                       engine.calculateAdvanced(op, double(i % 170 + 1));
+                   sink = sink + result.success;
+                 }
+               });
+  }
+
+  runner.run("calculator", "integer", "1000!", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + engine.calculateInteger('!', "1000", "").value.size();
+    }
+  });
+  string digits(2000, '7');
+  runner.run("calculator", "integer", "2000x2000_digits", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + engine.calculateInteger('*', digits, digits).value.size();
+    }
+  });
+
+  ExpressionEngine expressions(Role::ADMIN);
+  runner.run("calculator", "expression", "cached", [&](size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      sink = sink + expressions.evaluate("(2 + 3) * 4 - sqrt(16)").success;
+    }
+  });
+}
+
+bool parseArgs(int argc, char* argv[], Config& config) {
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--filter") == 0)
+      config.filter = argv[i + 1];
+    else if (strcmp(argv[i], "--repetitions") == 0)
+      config.repetitions = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--min-time") == 0)
+      config.minTimeMs = atof(argv[i + 1]);
+    else if (strcmp(argv[i], "--warmup") == 0)
+      config.warmupMs = atof(argv[i + 1]);
+    else if (strcmp(argv[i], "--max-users") == 0)
+      config.maxUsers = strtoull(argv[i + 1], nullptr, 10);
+    else if (strcmp(argv[i], "--output") == 0)
+      config.output = argv[i + 1];
+    else
+      return false;
+  }
+  return argc % 2 == 1 && config.repetitions > 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  if (!parseArgs(argc, argv, config)) {
+    cerr << "Использование: secure_calc_bench [--filter S] [--repetitions N] "
+            "[--min-time мс] [--warmup мс] [--max-users N] [--output F|-]"
+         << endl;
+    return 1;
+  }
+
+  char dirTemplate[] = "/tmp/secure_calc_bench_XXXXXX";
+  if (!mkdtemp(dirTemplate)) {
+    cerr << "Не удалось создать временный каталог" << endl;
+    return 1;
+  }
+  string dir = dirTemplate;
+
+  // UserDatabase сообщает о каждой загрузке и сохранении в cout: на время
+  // измерений вывод отключается
+  streambuf* stdoutBuffer = cout.rdbuf(nullptr);
+
+  Runner runner(config);
+  benchHasher(runner);
+  benchDatabase(runner, config, dir);
+  benchPolicy(runner);
+  benchLogger(runner, dir);
+  benchCalculator(runner);
+
+  cout.rdbuf(stdoutBuffer);
+  filesystem::remove_all(dir);
+
+  if (config.output == "-") {
+    runner.writeJson(cout);
+  } else {
+    ofstream out(config.output);
+    runner.writeJson(out);
+    cerr << "Отчёт: " << config.output << endl;
+  }
+  return 0;
+}
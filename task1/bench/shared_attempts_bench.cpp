@@ -0,0 +1,203 @@
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "auth_manager.h"
+#include "database.h"
+#include "security_logger.h"
+#include "shared_attempt_table.h"
+
+using namespace std;
+
+// Общая таблица попыток под нагрузкой из нескольких процессов.
+//
+// 1. Процессы одновременно учитывают неудачи по одному общему ключу и по
+//    своим ключам; итоговый счётчик общего ключа сверяется с числом
+//    операций (ни одно обновление не должно потеряться).
+// 2. Каждый процесс подбирает пароль к одному аккаунту через AuthManager.
+//    С собственными счётчиками процессов число проверенных догадок растёт
+//    с числом процессов, с общей таблицей оно ограничено порогом
+//    блокировки аккаунта.
+//
+// Использование: shared_attempts_bench [--processes N] [--ops N]
+
+namespace {
+
+struct Config {
+  int processes = 4;
+  size_t ops = 200000;
+};
+
+bool parseArgs(int argc, char* argv[], Config& config) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--processes") == 0 && i + 1 < argc) {
+      config.processes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--ops") == 0 && i + 1 < argc) {
+      config.ops = strtoull(argv[++i], nullptr, 10);
+    } else {
+      return false;
+    }
+  }
+  return config.processes > 0;
+}
+
+// Запускает body в processes дочерних процессах; коды выхода — в codes
+bool runProcesses(int processes, const function<int(int)>& body,
+                  vector<int>& codes) {
+  vector<pid_t> children;
+  for (int i = 0; i < processes; ++i) {
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) _exit(body(i));
+    children.push_back(pid);
+  }
+  codes.clear();
+  for (pid_t pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    codes.push_back(WIFEXITED(status) ? WEXITSTATUS(status) : -1);
+  }
+  return true;
+}
+
+bool runCounters(const Config& config, const string& name) {
+  auto start = chrono::steady_clock::now();
+  vector<int> codes;
+  bool spawned = runProcesses(
+      config.processes,
+      [&](int index) {
+        SharedAttemptTable table;
+        string error;
+        if (!table.open(name, SharedAttemptTable::DEFAULT_CAPACITY, error)) {
+          return 1;
+        }
+        string prefix = to_string(index);
+        prefix.insert(prefix.begin(), 'p');
+        prefix += '-';
+        for (size_t i = 0; i < config.ops; ++i) {
+          time_t now = time(nullptr);
+          table.registerFailure(SharedAttemptTable::Kind::ACCOUNT, "victim",
+                                UINT_MAX, 0, now);
+          table.registerFailure(SharedAttemptTable::Kind::IP,
+                                prefix + to_string(i % 1024), UINT_MAX, 0,
+                                now);
+        }
+        return 0;
+      },
+      codes);
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  if (!spawned) {
+    cerr << "Ошибка fork" << endl;
+    return false;
+  }
+  for (int code : codes) {
+    if (code != 0) {
+      cerr << "Процесс не подключился к таблице" << endl;
+      return false;
+    }
+  }
+
+  SharedAttemptTable table;
+  string error;
+  SharedAttemptTable::Entry entry{};
+  if (!table.open(name, SharedAttemptTable::DEFAULT_CAPACITY, error) ||
+      !table.lookup(SharedAttemptTable::Kind::ACCOUNT, "victim", entry)) {
+    cerr << "Не удалось прочитать общий ключ: " << error << endl;
+    return false;
+  }
+  uint64_t expected = uint64_t(config.processes) * config.ops;
+  SharedAttemptTable::Stats stats = table.getStats();
+  cout << "Счётчики: " << config.processes << " процессов, "
+       << 2 * expected / seconds / 1e6 << " млн операций/с" << endl;
+  cout << "  общий ключ: " << entry.attempts << " из " << expected
+       << (entry.attempts == expected ? " (совпадает)" : " (ПОТЕРИ)") << endl;
+  cout << "  занято слотов: " << stats.occupied << "/" << stats.capacity
+       << ", вытеснений: " << stats.evictions << endl;
+  return entry.attempts == expected;
+}
+
+// Число догадок, дошедших до проверки пароля, во всех процессах
+int runGuessing(const Config& config, const string& dir, const string& name) {
+  vector<int> codes;
+  runProcesses(
+      config.processes,
+      [&](int index) {
+        SharedAttemptTable table;
+        UserDatabase userDB(dir + "/users.dat");
+        SecurityLogger logger(dir + "/security.log");
+        AuthManager authManager(userDB, logger);
+        userDB.addUser("victim", "Victim123!", Role::USER);
+        string error;
+        if (!name.empty()) {
+          if (!table.open(name, SharedAttemptTable::DEFAULT_CAPACITY, error)) {
+            return 255;
+          }
+          authManager.attachSharedAttempts(&table);
+        }
+
+        // Каждый процесс — со своего адреса, чтобы мешала только
+        // блокировка аккаунта
+        string ip = "10.0.0." + to_string(index + 1);
+        int verified = 0;
+        for (int i = 0; i < 20; ++i) {
+          LoginResult result = authManager.attemptLogin(
+              "victim", "guess" + to_string(i), ip);
+          if (result.status == LoginStatus::INVALID_CREDENTIALS ||
+              result.status == LoginStatus::ACCOUNT_LOCKED_NOW) {
+            ++verified;
+          }
+        }
+        return verified;
+      },
+      codes);
+
+  int total = 0;
+  for (int code : codes) total += code;
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  if (!parseArgs(argc, argv, config)) {
+    cerr << "Использование: shared_attempts_bench [--processes N] [--ops N]"
+         << endl;
+    return 1;
+  }
+
+  char dirTemplate[] = "/tmp/shared_attempts_XXXXXX";
+  if (!mkdtemp(dirTemplate)) {
+    cerr << "Не удалось создать временный каталог" << endl;
+    return 1;
+  }
+  string dir = dirTemplate;
+  string name = "/secure_calc_bench." + to_string(getpid());
+
+  bool ok = runCounters(config, name);
+  shm_unlink(name.c_str());
+
+  string guessName = name + ".guess";
+  int local = runGuessing(config, dir, "");
+  int shared = runGuessing(config, dir, guessName);
+  shm_unlink(guessName.c_str());
+  cout << "Проверено догадок одного пароля из " << config.processes
+       << " процессов: свои счётчики — " << local << ", общая таблица — "
+       << shared << endl;
+
+  error_code ignored;
+  filesystem::remove_all(dir, ignored);
+  return ok ? 0 : 1;
+}
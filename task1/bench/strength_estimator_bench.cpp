@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "strength_estimator.h"
+
+using namespace std;
+
+// Пропускная способность StrengthEstimator на одном ядре и распределение
+// оценок. Без списка паролей генерирует синтетическую смесь: словарные
+// слова с заглавными буквами, leetspeak и цифрами, клавиатурные дорожки,
+// даты и случайные строки.
+//
+// Использование: strength_estimator_bench [--passwords F] [--table T] [--count N]
+
+namespace {
+
+vector<string> generatePasswords(size_t count, mt19937_64& rng) {
+  const vector<string> words = {"password", "dragon",  "monkey", "sunshine",
+                                "princess", "football", "master", "welcome",
+                                "shadow",   "letmein",  "summer", "admin"};
+  const vector<string> walks = {"qwerty", "asdfgh", "zxcvbn", "1qaz2wsx",
+                                "qazwsx", "poiuyt", "147258", "741852"};
+  const string alphabet =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789!@#$%^&*";
+
+  vector<string> passwords;
+  passwords.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    string password;
+    switch (rng() % 5) {
+      case 0: {  // Слово + цифры + символ, первая буква заглавная
+        password = words[rng() % words.size()];
+        password[0] = password[0] - 'a' + 'A';
+        password += to_string(rng() % 100) + "!";
+        break;
+      }
+      case 1: {  // Leetspeak
+        password = words[rng() % words.size()];
+        for (char& c : password) {
+          if (c == 'a') c = '@';
+          if (c == 'o') c = '0';
+          if (c == 'e') c = '3';
+        }
+        password += to_string(1950 + rng() % 75);
+        break;
+      }
+      case 2:  // Клавиатурная дорожка
+        password = walks[rng() % walks.size()] + walks[rng() % walks.size()];
+        break;
+      case 3:  // Дата рождения с именем
+        password = words[rng() % words.size()] +
+                   to_string(10 + rng() % 18) + "0" + to_string(1 + rng() % 9) +
+                   to_string(1960 + rng() % 60);
+        break;
+      default: {  // Случайная строка 8..16 символов
+        size_t length = 8 + rng() % 9;
+        for (size_t k = 0; k < length; ++k) {
+          password += alphabet[rng() % alphabet.size()];
+        }
+      }
+    }
+    passwords.push_back(password);
+  }
+  return passwords;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  string passwordsFile, tableFile;
+  size_t count = 1000000;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--passwords") == 0) {
+      passwordsFile = argv[i + 1];
+    } else if (strcmp(argv[i], "--table") == 0) {
+      tableFile = argv[i + 1];
+    } else if (strcmp(argv[i], "--count") == 0) {
+      count = strtoull(argv[i + 1], nullptr, 10);
+    } else {
+      cerr << "Использование: strength_estimator_bench [--passwords F] "
+              "[--table T] [--count N]"
+           << endl;
+      return 1;
+    }
+  }
+
+  StrengthEstimator estimator;
+  string error;
+  if (!tableFile.empty() && !estimator.loadTable(tableFile, error)) {
+    cerr << "Ошибка: " << error << endl;
+    return 1;
+  }
+
+  vector<string> passwords;
+  if (!passwordsFile.empty()) {
+    ifstream input(passwordsFile);
+    if (!input.is_open()) {
+      cerr << "Не удалось открыть " << passwordsFile << endl;
+      return 1;
+    }
+    string line;
+    while (getline(input, line)) {
+      if (!line.empty()) passwords.push_back(line);
+    }
+  } else {
+    mt19937_64 rng(36);
+    passwords = generatePasswords(count, rng);
+  }
+
+  // Прогрев: таблицы графов клавиатуры и кэши
+  for (size_t i = 0; i < min<size_t>(passwords.size(), 10000); ++i) {
+    estimator.estimate(passwords[i]);
+  }
+
+  size_t scores[5] = {};
+  double totalLog10 = 0;
+  auto start = chrono::steady_clock::now();
+  for (const string& password : passwords) {
+    StrengthEstimator::Estimate estimate = estimator.estimate(password);
+    scores[estimate.score]++;
+    totalLog10 += estimate.guessesLog10;
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  cout << "Паролей: " << passwords.size() << ", словарь: "
+       << estimator.getTable().entryCount() << " слов ("
+       << (estimator.getTable().isMapped() ? "файл" : "встроенный") << ")"
+       << endl;
+  cout << "Пропускная способность: " << passwords.size() / seconds
+       << " паролей/с на ядро (цель: 100000)" << endl;
+  cout << "Средний log10(попыток): " << totalLog10 / passwords.size() << endl;
+  for (int s = 0; s < 5; ++s) {
+    cout << "  оценка " << s << ": " << scores[s] << endl;
+  }
+
+  for (const char* sample :
+       {"Password1!", "p@ssw0rd", "qwerty123", "Tr0ub4dor&3", "19.05.1990",
+        "correcthorsebatterystaple", "xK#9vL!2qR@7mZ"}) {
+    StrengthEstimator::Estimate estimate = estimator.estimate(sample);
+    cout << "  " << sample << ": log10=" << estimate.guessesLog10
+         << ", оценка " << estimate.score << endl;
+  }
+  return 0;
+}
@@ -0,0 +1,155 @@
+#include <malloc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "database.h"
+#include "user_store.h"
+
+using namespace std;
+
+// Память и скорость поиска учётных записей: прежняя раскладка
+// map<string, UserInfo> против UserStore на одних и тех же пользователях.
+// Память считается по куче malloc (mallinfo2) до и после построения, так
+// что в неё входят узлы дерева, строки и запас векторов.
+//
+// Использование: user_store_bench [--users N] [--lookups N]
+
+namespace {
+
+volatile size_t sink;
+
+struct Config {
+  size_t users = 10000000;
+  size_t lookups = 1000000;
+};
+
+string login(size_t index) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "user%08zu", index);
+  return buffer;
+}
+
+// Хэш в формате SecurePasswordHasher, однозначно заданный номером
+string fakeHash(size_t index) {
+  static const char HEX[] = "0123456789abcdef";
+  mt19937_64 rng(index);
+  string hash(49, '|');
+  uint64_t bits = 0;
+  for (size_t i = 0; i < hash.size(); ++i) {
+    if (i % 16 == 0) bits = rng();
+    if (i != 32) hash[i] = HEX[(bits >> (4 * (i % 16))) & 15];
+  }
+  return hash;
+}
+
+size_t heapBytes() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+double secondsSince(chrono::steady_clock::time_point start) {
+  return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Логины для поиска: половина существует, половина нет
+vector<string> lookupKeys(const Config& config) {
+  mt19937_64 rng(7);
+  vector<string> keys;
+  keys.reserve(4096);
+  for (size_t i = 0; i < 4096; ++i) {
+    size_t index = rng() % config.users;
+    keys.push_back(i % 2 ? login(index) : login(index) + "_");
+  }
+  return keys;
+}
+
+void report(const char* name, size_t users, size_t bytes, double buildSeconds,
+            double lookupNs) {
+  cout << name << ": " << double(bytes) / users << " байт на пользователя ("
+       << bytes / (1 << 20) << " МиБ), построение " << buildSeconds
+       << " с, поиск " << lookupNs << " нс" << endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (strcmp(argv[i], "--users") == 0) {
+      config.users = strtoull(argv[i + 1], nullptr, 10);
+    } else if (strcmp(argv[i], "--lookups") == 0) {
+      config.lookups = strtoull(argv[i + 1], nullptr, 10);
+    } else {
+      cerr << "Использование: user_store_bench [--users N] [--lookups N]"
+           << endl;
+      return 1;
+    }
+  }
+  if (config.users == 0) return 1;
+  vector<string> keys = lookupKeys(config);
+  cout << "Пользователей: " << config.users << endl;
+
+  double mapBytesPerUser;
+  {
+    size_t before = heapBytes();
+    auto start = chrono::steady_clock::now();
+    map<string, UserInfo> users;
+    for (size_t i = 0; i < config.users; ++i) {
+      users[login(i)] = {fakeHash(i), Role::USER, true, 0};
+    }
+    double build = secondsSince(start);
+    size_t bytes = heapBytes() - before;
+
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < config.lookups; ++i) {
+      sink = sink + (users.find(keys[i & 4095]) != users.end());
+    }
+    report("map<string, UserInfo>", config.users, bytes, build,
+           secondsSince(start) * 1e9 / config.lookups);
+    mapBytesPerUser = double(bytes) / config.users;
+  }
+
+  size_t before = heapBytes();
+  auto start = chrono::steady_clock::now();
+  UserStore store;
+  for (size_t i = 0; i < config.users; ++i) {
+    store.insert(login(i), fakeHash(i), static_cast<uint8_t>(Role::USER), true,
+                 0);
+  }
+  // Как после UserDatabase::loadUsers
+  store.shrinkToFit();
+  double build = secondsSince(start);
+  size_t bytes = heapBytes() - before;
+
+  start = chrono::steady_clock::now();
+  for (size_t i = 0; i < config.lookups; ++i) {
+    sink = sink + (store.find(keys[i & 4095]) != UserStore::NOT_FOUND);
+  }
+  report("UserStore", config.users, bytes, build,
+         secondsSince(start) * 1e9 / config.lookups);
+  cout << "Экономия памяти: "
+       << mapBytesPerUser / (double(bytes) / config.users)
+       << " раза (арена и массивы: " << store.memoryBytes() / (1 << 20)
+       << " МиБ)" << endl;
+
+  // Хэши восстанавливаются из двоичного вида без потерь
+  mt19937_64 rng(11);
+  for (size_t i = 0; i < 10000; ++i) {
+    size_t index = rng() % config.users;
+    uint32_t id = store.find(login(index));
+    if (id == UserStore::NOT_FOUND ||
+        store.passwordHash(id) != fakeHash(index)) {
+      cerr << "Запись " << login(index) << " повреждена" << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#ifndef ATTEMPT_TABLE_H
+#define ATTEMPT_TABLE_H
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Компактная запись о попытках входа: 16 байт, логин хранится только хэшем
+struct AttemptRecord {
+  uint64_t keyHash;     // 0 — свободная запись
+  uint32_t unlockTime;  // Время разблокировки (секунды Unix)
+  uint16_t attempts;
+  uint8_t referenced;  // Бит обращения для алгоритма CLOCK
+  uint8_t reserved;
+};
+
+// Таблица попыток фиксированного размера. Наборно-ассоциативная организация:
+// ключ попадает в набор из 4 записей (ровно одна кэш-линия), внутри набора
+// замещение выполняется по CLOCK. Память ограничена сверху при любом числе
+// различных логинов, поиск — O(1).
+class AttemptTable {
+ public:
+  static const size_t WAYS = 4;
+
+  struct Stats {
+    size_t capacity;
+    size_t occupied;
+    uint64_t evictions;
+    uint64_t lockedEvictions;  // Вытеснено записей с активной блокировкой
+  };
+
+ private:
+  struct alignas(64) Set {
+    AttemptRecord records[WAYS];
+  };
+
+  unique_ptr<Set[]> sets;
+  vector<uint8_t> clockHands;
+  size_t setMask;
+  uint64_t seed;
+  size_t occupied = 0;
+  uint64_t evictions = 0;
+  uint64_t lockedEvictions = 0;
+
+  uint64_t hashLogin(const string& login) const {
+    uint64_t x = std::hash<string>{}(login) ^ seed;
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x ? x : 1;
+  }
+
+  Set& setFor(uint64_t keyHash) { return sets[keyHash & setMask]; }
+
+  static bool isLocked(const AttemptRecord& record, time_t now) {
+    return record.unlockTime > now;
+  }
+
+  // Выбор жертвы по CLOCK; заблокированные записи получают второй шанс
+  AttemptRecord& chooseVictim(Set& set, size_t setIndex, time_t now) {
+    uint8_t& hand = clockHands[setIndex];
+    for (size_t step = 0; step < 2 * WAYS; ++step) {
+      AttemptRecord& record = set.records[hand];
+      hand = (hand + 1) % WAYS;
+      if (record.referenced || isLocked(record, now)) {
+        record.referenced = 0;
+        continue;
+      }
+      return record;
+    }
+    // Все записи набора заблокированы: жёсткий потолок памяти важнее
+    AttemptRecord& record = set.records[hand];
+    hand = (hand + 1) % WAYS;
+    lockedEvictions++;
+    return record;
+  }
+
+ public:
+  // capacity округляется вверх до кратного WAYS степени двойки
+  explicit AttemptTable(size_t capacity = 65536) {
+    size_t setCount = 1;
+    while (setCount * WAYS < capacity) setCount <<= 1;
+    setMask = setCount - 1;
+    sets.reset(new Set[setCount]());
+    clockHands.assign(setCount, 0);
+
+    random_device rd;
+    seed = (uint64_t(rd()) << 32) | rd();
+  }
+
+  AttemptRecord* find(const string& login) {
+    uint64_t keyHash = hashLogin(login);
+    Set& set = setFor(keyHash);
+    for (AttemptRecord& record : set.records) {
+      if (record.keyHash == keyHash) {
+        record.referenced = 1;
+        return &record;
+      }
+    }
+    return nullptr;
+  }
+
+  AttemptRecord& findOrInsert(const string& login, time_t now) {
+    uint64_t keyHash = hashLogin(login);
+    size_t setIndex = keyHash & setMask;
+    Set& set = sets[setIndex];
+
+    AttemptRecord* freeRecord = nullptr;
+    for (AttemptRecord& record : set.records) {
+      if (record.keyHash == keyHash) {
+        record.referenced = 1;
+        return record;
+      }
+      if (!freeRecord && record.keyHash == 0) freeRecord = &record;
+    }
+
+    AttemptRecord* target = freeRecord;
+    if (target) {
+      occupied++;
+    } else {
+      target = &chooseVictim(set, setIndex, now);
+      evictions++;
+    }
+    *target = {keyHash, 0, 0, 1, 0};
+    return *target;
+  }
+
+  Stats getStats() const {
+    return {(setMask + 1) * WAYS, occupied, evictions, lockedEvictions};
+  }
+
+  size_t memoryBytes() const {
+    return (setMask + 1) * (sizeof(Set) + sizeof(uint8_t));
+  }
+};
+
+#endif
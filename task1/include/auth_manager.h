@@ -4,44 +4,99 @@
 #define AUTH_MANAGER_H
 
 #include <ctime>
-#include <map>
+#include <optional>
 #include <string>
 
+#include "attempt_table.h"
 #include "database.h"
+#include "deadline_scheduler.h"
+#include "rate_limiter.h"
 #include "security_logger.h"
+#include "shared_attempt_table.h"
 
 using namespace std;
 
-struct LockInfo {
-  int attempts;
-  time_t unlockTime;
-};
-
 struct UserSession {
   string username;
   Role role;
   string ipAddress;
 };
 
+// Итог попытки входа (для неинтерактивного использования и тестов нагрузки)
+enum class LoginStatus {
+  SUCCESS,              // Вход выполнен (или предварительная проверка пройдена)
+  IP_LOCKED,            // IP заблокирован
+  RATE_LIMITED,         // Превышена частота попыток
+  ACCOUNT_LOCKED,       // Аккаунт уже заблокирован
+  ACCOUNT_DISABLED,     // Учетная запись отключена администратором
+  INVALID_CREDENTIALS,  // Неверный логин или пароль
+  ACCOUNT_LOCKED_NOW    // Неверный пароль, аккаунт только что заблокирован
+};
+
+// Имя результата для метрик и отчётов ("success", "ip_locked", ...)
+const char* loginStatusLabel(LoginStatus status);
+
+struct LoginResult {
+  LoginStatus status;
+  UserSession session;
+  int attemptsLeft;  // Для INVALID_CREDENTIALS
+  int retryAfter;    // Секунд до снятия блокировки или ограничения
+};
+
 class AuthManager {
  private:
   UserDatabase& userDB;
   SecurityLogger& securityLogger;
-  map<string, LockInfo> loginAttempts;
+  // Собственные счётчики процесса — запасной вариант для AuthManager без
+  // общей таблицы (бенчмарки, встраивание). SecureCalculator без общей
+  // таблицы не запускается, и в нём loginAttempts остаётся пустой
+  AttemptTable loginAttempts;
+  // Общие для всех процессов счётчики; если подключены, loginAttempts не
+  // используется
+  SharedAttemptTable* sharedAttempts = nullptr;
+  DeadlineScheduler lockTimer;
+  AttemptThrottle attemptThrottle;
+  // Хэш-приманка в формате настоящих хэшей: для неизвестного логина
+  // проверка пароля выполняется против него и стоит столько же
+  string decoyHash;
 
   const int MAX_ACCOUNT_ATTEMPTS = 3;
   const int ACCOUNT_LOCK_TIME = 30;
   const int MAX_IP_ATTEMPTS = 10;
   const int IP_LOCK_TIME = 60;
 
-  bool isAccountLocked(const string& login);
+  bool isAccountLocked(const string& login, int& remaining);
+  void reportLoginFailure(const LoginResult& result);
   void showIPLockInfo(const string& ip);
+  void waitForIPUnlock(const string& ip);
   string getClientIP();
 
  public:
   AuthManager(UserDatabase& db, SecurityLogger& logger);
   UserSession authenticate();
+
+  // Счётчики попыток аккаунтов и IP из общей таблицы вместо собственных
+  void attachSharedAttempts(SharedAttemptTable* table);
+
+  // Проверки до ввода пароля: блокировки IP/аккаунта, частота, активность
+  LoginResult checkLoginAllowed(const string& login, const string& ip);
+  // Проверка пароля и учёт результата
+  LoginResult completeLogin(const string& login, const string& password,
+                            const string& ip);
+  // Полная попытка входа без диалога с пользователем
+  LoginResult attemptLogin(const string& login, const string& password,
+                           const string& ip);
+  bool verifyCredentials(const optional<UserInfo>& userInfo,
+                         const string& password);
   void resetAttempts(const string& login, const string& ip);
+  // Статистика собственной таблицы; при подключённой общей не отражает
+  // реальных попыток (см. getSharedAttempts)
+  AttemptTable::Stats getAttemptTableStats() const {
+    return loginAttempts.getStats();
+  }
+  const SharedAttemptTable* getSharedAttempts() const {
+    return sharedAttempts;
+  }
 };
 
 string getRoleName(Role role);
@@ -0,0 +1,60 @@
+#pragma once
+
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+#include "calculator_engine.h"
+
+using namespace std;
+
+// Неинтерактивный режим калькулятора: одна операция на строку.
+//   <операция> <число> [<число>]     например: "+ 2 3", "! 10", "s 2"
+// Пустые строки и строки с '#' в начале пропускаются. На каждую операцию
+// выводится одна строка: результат в кратчайшей точной записи или
+// "ОШИБКА: <текст>". Права роли проверяются для каждой операции.
+//
+// Числа разбираются std::from_chars, результаты пишутся std::to_chars в
+// переиспользуемый буфер: без потоков ввода-вывода, локали и выделений
+// памяти на строку.
+struct BatchStats {
+  size_t lines = 0;   // Вычисленных операций
+  size_t errors = 0;  // Из них с ошибкой
+  size_t bytesIn = 0;
+  size_t bytesOut = 0;
+};
+
+class BatchProcessor {
+ public:
+  static constexpr size_t READ_BUFFER_SIZE = 1 << 20;
+  static constexpr size_t WRITE_BUFFER_SIZE = 1 << 20;
+
+  BatchProcessor(CalculatorEngine& engine, Role role);
+
+  // Вычисляет все строки из [begin, end) и дописывает результаты в out.
+  // Последняя строка может не заканчиваться '\n'. Потокобезопасна: состояние
+  // объекта не меняется.
+  void evaluateLines(const char* begin, const char* end, string& out,
+                     BatchStats& stats) const;
+
+  // Читает inputFd блоками READ_BUFFER_SIZE до конца и пишет в outputFd;
+  // false и error при ошибке ввода-вывода. Строка длиннее READ_BUFFER_SIZE
+  // не вычисляется и даёт одну ошибку.
+  bool run(int inputFd, int outputFd, BatchStats& stats, string& error);
+
+  // Полная запись с повтором после EINTR и частичных записей
+  static bool writeAll(int fd, const char* data, size_t size, string& error);
+
+ private:
+  CalculatorEngine& calculatorEngine;
+  // Разрешена ли операция роли сессии: индекс — символ операции
+  array<bool, 256> allowed{};
+
+  void evaluateLine(const char* begin, const char* end, string& out,
+                    BatchStats& stats) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#ifndef BIG_INTEGER_H
+#define BIG_INTEGER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Целое произвольной точности: знак + модуль в разрядах по 32 бита
+// (младший разряд первым, без ведущих нулей).
+//
+// Умножение — Карацуба выше порога, деление — алгоритм D Кнута.
+// Факториал считается бинарным разбиением произведения, перевод в
+// десятичную строку — «разделяй и властвуй» по степеням 10^(9·2^k) с
+// делением Барретта. Для больших операндов ветви рекурсии выполняются
+// в нескольких потоках (threads == 0 — по числу ядер).
+class BigInteger {
+ public:
+  using Limbs = vector<uint32_t>;
+
+  BigInteger() = default;
+  BigInteger(long long value);
+
+  // Десятичная запись с необязательным знаком
+  static bool fromString(const string& text, BigInteger& result,
+                         string& error);
+  string toString(unsigned threads = 0) const;
+
+  static BigInteger factorial(uint32_t n, unsigned threads = 0);
+  static BigInteger power(const BigInteger& base, uint32_t exponent);
+
+  // Деление с усечением к нулю (как для встроенных целых); false при b == 0
+  static bool divide(const BigInteger& a, const BigInteger& b,
+                     BigInteger& quotient, BigInteger& remainder);
+
+  friend BigInteger operator+(const BigInteger& a, const BigInteger& b);
+  friend BigInteger operator-(const BigInteger& a, const BigInteger& b);
+  friend BigInteger operator*(const BigInteger& a, const BigInteger& b);
+  friend bool operator==(const BigInteger& a, const BigInteger& b);
+  friend bool operator<(const BigInteger& a, const BigInteger& b);
+
+  BigInteger operator-() const;
+
+  bool isZero() const { return limbs.empty(); }
+  bool isNegative() const { return negative; }
+  size_t bitLength() const;
+  const Limbs& getLimbs() const { return limbs; }
+
+  // Умножение двух модулей (Карацуба, параллельно на верхних уровнях)
+  static Limbs multiply(const Limbs& a, const Limbs& b, unsigned threads = 1);
+
+ private:
+  bool negative = false;
+  Limbs limbs;
+
+  BigInteger(Limbs magnitude, bool isNegative);
+  void normalize();
+};
+
+#endif
@@ -0,0 +1,296 @@
+#pragma once
+
+#ifndef BREACH_FILTER_H
+#define BREACH_FILTER_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Xor-фильтр (Graf & Lemire, 2019) по хэшам утёкших паролей.
+//
+// Каждый ключ отображается в три ячейки из трёх равных блоков; в ячейках
+// хранятся 16-битные отпечатки, XOR которых равен отпечатку ключа.
+// Размер: 1.23 * n + 32 ячеек по 2 байта, т.е. около 2.46 байта на пароль.
+// Ложноположительные срабатывания: 2^-16 ≈ 0.0015% (1 из 65536 надёжных
+// паролей будет отклонён). Ложноотрицательных срабатываний нет.
+//
+// Пароли нормализуются перед хэшированием: обрезаются концевые пробельные
+// символы и ASCII-буквы приводятся к нижнему регистру, так что варианты
+// «Password» и «password» считаются одним паролем.
+//
+// Формат файла: BreachFilterHeader, затем 3 * blockLength отпечатков uint16_t
+// (little-endian). Файл отображается в память, загрузка почти бесплатна.
+
+struct BreachFilterHeader {
+  char magic[8];
+  uint64_t seed;
+  uint64_t entries;
+  uint64_t blockLength;
+};
+
+class BreachFilterFormat {
+ public:
+  static constexpr char MAGIC[8] = {'B', 'R', 'F', 'L', 'T', 'X', '1', '6'};
+
+  static string normalize(const string& password) {
+    size_t end = password.size();
+    while (end > 0 && isspace(static_cast<unsigned char>(password[end - 1]))) {
+      --end;
+    }
+    string normalized = password.substr(0, end);
+    for (char& c : normalized) {
+      if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+    }
+    return normalized;
+  }
+
+  // Стабильный между сборками хэш: FNV-1a с финальным перемешиванием
+  static uint64_t hashPassword(const string& password) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (unsigned char c : normalize(password)) {
+      hash ^= c;
+      hash *= 0x100000001b3ULL;
+    }
+    return mix(hash);
+  }
+
+  static uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+  }
+
+  static uint16_t fingerprint(uint64_t hash) {
+    return static_cast<uint16_t>(hash ^ (hash >> 32));
+  }
+
+  static uint64_t slot(uint64_t hash, int index, uint64_t blockLength) {
+    uint64_t rotated = index == 0 ? hash : (hash << (21 * index)) |
+                                               (hash >> (64 - 21 * index));
+    // Быстрое приведение к диапазону [0, blockLength) без деления;
+    // blockLength < 2^32, поэтому произведение помещается в 64 бита
+    uint64_t reduced =
+        (uint64_t(static_cast<uint32_t>(rotated)) * blockLength) >> 32;
+    return reduced + index * blockLength;
+  }
+};
+
+// Построение фильтра (офлайн, см. tools/breach_filter_builder.cpp)
+class BreachFilterBuilder {
+ public:
+  // hashes будут отсортированы и очищены от дублей
+  static bool build(vector<uint64_t>& hashes, const string& outputPath,
+                    string& error) {
+    sort(hashes.begin(), hashes.end());
+    hashes.erase(unique(hashes.begin(), hashes.end()), hashes.end());
+
+    uint64_t capacity = 32 + (hashes.size() * 123 + 99) / 100;
+    uint64_t blockLength = capacity / 3 + 1;
+    if (blockLength >= (uint64_t(1) << 32)) {
+      error = "слишком много паролей для одного фильтра";
+      return false;
+    }
+    vector<uint16_t> fingerprints;
+
+    const int MAX_ATTEMPTS = 64;
+    uint64_t seed = 0x5eed5eed5eed5eedULL;
+    bool built = false;
+    for (int attempt = 0; attempt < MAX_ATTEMPTS && !built; ++attempt) {
+      seed = BreachFilterFormat::mix(seed + attempt + 1);
+      built = tryBuild(hashes, seed, blockLength, fingerprints);
+    }
+    if (!built) {
+      error = "не удалось построить фильтр (слишком много коллизий)";
+      return false;
+    }
+
+    // Работающие процессы держат фильтр отображённым (MAP_SHARED):
+    // усечение файла на месте обрушило бы их по SIGBUS, поэтому новая
+    // версия пишется рядом и подменяет старую переименованием
+    string temporary = outputPath + ".tmp";
+    {
+      ofstream out(temporary, ios::binary | ios::trunc);
+      if (!out.is_open()) {
+        error = "не удалось открыть файл для записи: " + temporary;
+        return false;
+      }
+      BreachFilterHeader header = {};
+      memcpy(header.magic, BreachFilterFormat::MAGIC, sizeof(header.magic));
+      header.seed = seed;
+      header.entries = hashes.size();
+      header.blockLength = blockLength;
+      out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      out.write(reinterpret_cast<const char*>(fingerprints.data()),
+                fingerprints.size() * sizeof(uint16_t));
+      out.flush();
+      if (!out) {
+        error = "ошибка записи в файл: " + temporary;
+        remove(temporary.c_str());
+        return false;
+      }
+    }
+    if (rename(temporary.c_str(), outputPath.c_str()) != 0) {
+      error = "не удалось переименовать " + temporary + ": " + strerror(errno);
+      remove(temporary.c_str());
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  static bool tryBuild(const vector<uint64_t>& hashes, uint64_t seed,
+                       uint64_t blockLength, vector<uint16_t>& fingerprints) {
+    uint64_t size = 3 * blockLength;
+    vector<uint64_t> xorMask(size, 0);
+    vector<uint32_t> counts(size, 0);
+
+    for (uint64_t key : hashes) {
+      uint64_t hash = BreachFilterFormat::mix(key + seed);
+      for (int i = 0; i < 3; ++i) {
+        uint64_t index = BreachFilterFormat::slot(hash, i, blockLength);
+        xorMask[index] ^= hash;
+        counts[index]++;
+      }
+    }
+
+    // Отслаивание: ячейка с единственным ключом однозначно задаёт его
+    vector<uint64_t> queue;
+    for (uint64_t i = 0; i < size; ++i) {
+      if (counts[i] == 1) queue.push_back(i);
+    }
+
+    vector<pair<uint64_t, uint64_t>> stack;  // (хэш ключа, ячейка)
+    stack.reserve(hashes.size());
+    while (!queue.empty()) {
+      uint64_t index = queue.back();
+      queue.pop_back();
+      if (counts[index] != 1) continue;
+
+      uint64_t hash = xorMask[index];
+      stack.push_back({hash, index});
+      for (int i = 0; i < 3; ++i) {
+        uint64_t other = BreachFilterFormat::slot(hash, i, blockLength);
+        xorMask[other] ^= hash;
+        if (--counts[other] == 1) queue.push_back(other);
+      }
+    }
+    if (stack.size() != hashes.size()) return false;
+
+    fingerprints.assign(size, 0);
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+      uint64_t hash = it->first;
+      uint16_t value = BreachFilterFormat::fingerprint(hash);
+      for (int i = 0; i < 3; ++i) {
+        uint64_t index = BreachFilterFormat::slot(hash, i, blockLength);
+        if (index != it->second) value ^= fingerprints[index];
+      }
+      fingerprints[it->second] = value;
+    }
+    return true;
+  }
+};
+
+// Проверка пароля по отображённому в память фильтру: O(1), три обращения
+class BreachFilter {
+ private:
+  void* mapping = nullptr;
+  size_t mappingSize = 0;
+  const uint16_t* fingerprints = nullptr;
+  BreachFilterHeader header = {};
+
+ public:
+  BreachFilter() = default;
+  BreachFilter(const BreachFilter&) = delete;
+  BreachFilter& operator=(const BreachFilter&) = delete;
+  ~BreachFilter() { close(); }
+
+  bool open(const string& path, string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      error = "не удалось открыть фильтр: " + path;
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < sizeof(BreachFilterHeader)) {
+      ::close(fd);
+      error = "некорректный размер файла фильтра: " + path;
+      return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      error = "не удалось отобразить фильтр в память: " + path;
+      return false;
+    }
+
+    // blockLength проверяется до умножения: иначе поддельный заголовок
+    // переполнил бы 3 * blockLength и прошёл сравнение размеров. Нулевой
+    // блок пропустил бы проверку и дал бы чтение за концом отображения.
+    memcpy(&header, data, sizeof(header));
+    uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+    bool sizeValid = header.blockLength > 0 &&
+                     header.blockLength < (uint64_t(1) << 32) &&
+                     header.blockLength <= fileSize / (3 * sizeof(uint16_t)) &&
+                     fileSize == sizeof(header) + 3 * header.blockLength *
+                                                      sizeof(uint16_t);
+    if (memcmp(header.magic, BreachFilterFormat::MAGIC, sizeof(header.magic)) !=
+            0 ||
+        !sizeValid) {
+      munmap(data, info.st_size);
+      error = "файл не является фильтром утечек: " + path;
+      return false;
+    }
+
+    mapping = data;
+    mappingSize = info.st_size;
+    fingerprints = reinterpret_cast<const uint16_t*>(
+        static_cast<const char*>(data) + sizeof(header));
+    return true;
+  }
+
+  void close() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+    fingerprints = nullptr;
+  }
+
+  bool isLoaded() const { return mapping != nullptr; }
+  uint64_t entryCount() const { return header.entries; }
+  size_t sizeBytes() const { return mappingSize; }
+
+  bool contains(const string& password) const {
+    if (!fingerprints) return false;
+    uint64_t hash = BreachFilterFormat::mix(
+        BreachFilterFormat::hashPassword(password) + header.seed);
+    uint16_t value = BreachFilterFormat::fingerprint(hash);
+    for (int i = 0; i < 3; ++i) {
+      value ^= fingerprints[BreachFilterFormat::slot(hash, i,
+                                                     header.blockLength)];
+    }
+    return value == 0;
+  }
+};
+
+#endif
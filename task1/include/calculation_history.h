@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef CALCULATION_HISTORY_H
+#define CALCULATION_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "calculator_operations.h"
+
+using namespace std;
+
+// Запись истории: 40 байт без указателей, поэтому выгружается в файл как есть
+struct HistoryRecord {
+  double operand1;
+  double operand2;
+  double result;      // NaN при ошибке
+  int64_t timestamp;  // Секунды Unix
+  uint32_t sequence;  // Номер в сессии, с 1
+  char operation;     // Символ операции, 'e' — выражение
+  uint8_t arity;      // Число операндов: 0 у выражений
+  uint8_t status;     // HISTORY_OK, 1 + CalcError или HISTORY_EXPRESSION_ERROR
+  uint8_t reserved;
+};
+
+static_assert(sizeof(HistoryRecord) == 40);
+static_assert(is_trivially_copyable_v<HistoryRecord>);
+
+constexpr uint8_t HISTORY_OK = 0;
+constexpr uint8_t HISTORY_EXPRESSION_ERROR = 0xFF;
+
+constexpr uint8_t historyStatus(CalcError error) {
+  return static_cast<uint8_t>(1 + static_cast<uint8_t>(error));
+}
+
+const char* historyStatusMessage(uint8_t status);
+
+// История вычислений одной сессии. Записи лежат блоками по BLOCK_RECORDS в
+// монотонной арене: новый блок выделяется раз на BLOCK_RECORDS записей, а
+// после заполнения capacity самые старые записи перезаписываются по кругу,
+// так что память не превышает capacity записей. Номер записи не меняется
+// при вытеснении; вытесненные записи больше не находятся.
+//
+// Целочисленный режим не записывается: его результат не помещается в
+// запись фиксированного размера.
+class CalculationHistory {
+ public:
+  static constexpr size_t BLOCK_RECORDS = 256;
+  static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+  explicit CalculationHistory(size_t capacity = DEFAULT_CAPACITY);
+
+  void append(char operation, uint8_t arity, double operand1, double operand2,
+              double result, uint8_t status);
+
+  // Запись с номером sequence или nullptr, если её нет или она вытеснена
+  const HistoryRecord* find(uint32_t sequence) const;
+
+  size_t size() const;  // Хранимых записей
+  uint32_t lastSequence() const { return appended; }
+  uint32_t firstSequence() const {
+    return static_cast<uint32_t>(appended - size() + 1);
+  }
+  size_t getCapacity() const { return capacity; }
+
+  // Освобождает арену; нумерация продолжается
+  void clear();
+
+  // Запись от старых к новым. Формат по расширению: ".csv" — текст,
+  // иначе двоичный: HistoryFileHeader и записи как есть.
+  bool exportFile(const string& path, string& error) const;
+  bool exportCsv(const string& path, string& error) const;
+  bool exportBinary(const string& path, string& error) const;
+
+  struct HistoryFileHeader {
+    char magic[8];  // "SCHIST1"
+    uint32_t recordSize;
+    uint32_t count;
+  };
+
+ private:
+  HistoryRecord& slot(uint32_t sequence) const;
+
+  size_t capacity;
+  pmr::monotonic_buffer_resource arena;
+  vector<HistoryRecord*> blocks;
+  uint32_t appended = 0;
+  uint32_t base = 0;  // Последний номер перед clear()
+};
+
+#endif
@@ -4,9 +4,17 @@
 #define CALCULATOR_ENGINE_H
 
 #include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string_view>
+#include <unordered_map>
 
 #include "auth_manager.h"
+#include "calculator_operations.h"
+#include "result_cache.h"
 
 using namespace std;
 
@@ -15,14 +23,83 @@ class CalculatorEngine {
   static long long factorial(int n);
   static double power(double base, double exponent);
 
+  // Ограничения целочисленного режима: время и память на один запрос
+  static constexpr uint32_t MAX_INTEGER_FACTORIAL = 200000;
+  static constexpr size_t MAX_INTEGER_BITS = size_t(1) << 22;
+
+  // Минимальная роль для операции ('+', '!', '^', 's', 'l' и т.д.)
+  static Role requiredRole(char operation);
+
+  // errorMessage указывает на статическую строку (calcErrorMessage)
   struct CalculationResult {
     bool success;
     double value;
+    string_view errorMessage;
+    CalcError error;  // Имеет смысл только при success == false
+  };
+
+  // Бинарные (+ - * / ^) и унарные (! s l) операции из CalculatorOperations;
+  // ошибки возвращаются кодом, без исключений и выделения памяти
+  static CalcOutcome compute(char operation, double num1,
+                             double num2 = 0) noexcept;
+
+  CalculationResult calculate(char operation, double num1,
+                              double num2 = 0) noexcept;
+  CalculationResult calculateAdvanced(char operation, double num) noexcept;
+
+  struct IntegerResult {
+    bool success;
+    string value;  // Десятичная запись
     string errorMessage;
   };
 
-  CalculationResult calculate(char operation, double num1, double num2 = 0);
-  CalculationResult calculateAdvanced(char operation, double num);
+  // Точная целочисленная арифметика (BigInteger) над десятичными строками:
+  // + - * / % ^ и '!' (унарная, b не используется). Деление — с усечением
+  // к нулю, остаток — со знаком делимого.
+  // scope — область кэша пользователя из cacheScope (0 — общая)
+  IntegerResult calculateInteger(char operation, const string& a,
+                                 const string& b = "", uint32_t scope = 0);
+
+  // Кэш результатов целочисленного режима: ключ — область пользователя,
+  // операция и оба операнда, значение — десятичная запись результата.
+  // Вызывается до начала работы.
+  using IntegerCache = ResultCache<string, string>;
+  void enableResultCache(const ResultCacheConfig& config);
+  bool isResultCacheEnabled() const { return integerCache != nullptr; }
+  ResultCacheStats getCacheStats() const;
+
+  // Область кэша для пользователя: 0, если изоляция выключена
+  uint32_t cacheScope(const string& username);
+
+  // Код результата для каждого элемента пакетного вычисления
+  enum BatchStatus : uint8_t {
+    BATCH_OK = 0,
+    BATCH_DIVISION_BY_ZERO = 1,
+    BATCH_DOMAIN_ERROR = 2  // Корень из отрицательного, логарифм от x <= 0
+  };
+
+  // out[i] = a[i] op b[i] для операций + - * / ^ и out[i] = op(a[i]) для
+  // 's' (корень) и 'l' (логарифм), b для них не используется. Ошибки
+  // области определения не прерывают вычисление: элемент получает NaN и
+  // код в status[i]. Возвращает false при неподдерживаемой операции или
+  // несовпадении размеров. Ядро (AVX2, SSE2 или скалярное) выбирается
+  // по возможностям процессора при первом вызове.
+  bool calculateBatch(char operation, span<const double> a,
+                      span<const double> b, span<double> out,
+                      span<uint8_t> status);
+
+  static const char* batchKernelName();
+  static const char* batchStatusMessage(char operation, uint8_t status);
+
+ private:
+  IntegerResult computeInteger(char operation, const string& a,
+                               const string& b);
+
+  bool isolateUsers = false;
+  unique_ptr<IntegerCache> integerCache;
+
+  mutex scopeMutex;
+  unordered_map<string, uint32_t> scopes;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+
+#ifndef CALCULATOR_OPERATIONS_H
+#define CALCULATOR_OPERATIONS_H
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <expected>
+
+#include "database.h"
+
+using namespace std;
+
+// Ошибки вычислений: код вместо исключения, текст — статическая строка
+enum class CalcError : uint8_t {
+  DIVISION_BY_ZERO,
+  NEGATIVE_FACTORIAL,
+  LARGE_FACTORIAL,
+  NEGATIVE_SQRT,
+  NONPOSITIVE_LOG,
+  NOT_A_NUMBER,
+  UNSUPPORTED_OPERATION
+};
+
+constexpr const char* calcErrorMessage(CalcError error) noexcept {
+  switch (error) {
+    case CalcError::DIVISION_BY_ZERO:
+      return "Деление на ноль!";
+    case CalcError::NEGATIVE_FACTORIAL:
+      return "Факториал отрицательного числа не определен!";
+    case CalcError::LARGE_FACTORIAL:
+      return "Слишком большое число для факториала!";
+    case CalcError::NEGATIVE_SQRT:
+      return "Квадратный корень из отрицательного числа!";
+    case CalcError::NONPOSITIVE_LOG:
+      return "Логарифм определен только для положительных чисел!";
+    case CalcError::NOT_A_NUMBER:
+      return "Аргумент не является числом!";
+    default:
+      return "Неподдерживаемая операция!";
+  }
+}
+
+using CalcOutcome = expected<double, CalcError>;
+
+// Операции калькулятора. Каждая описывает символ, минимальную роль,
+// арность, подпись в меню и ядро apply (для унарных b не используется).
+namespace calc_ops {
+
+struct Add {
+  static constexpr char symbol = '+';
+  static constexpr Role role = Role::GUEST;
+  static constexpr uint8_t arity = 2;
+  static constexpr const char* label = "Сложение";
+  static CalcOutcome apply(double a, double b) noexcept { return a + b; }
+};
+
+struct Subtract {
+  static constexpr char symbol = '-';
+  static constexpr Role role = Role::GUEST;
+  static constexpr uint8_t arity = 2;
+  static constexpr const char* label = "Вычитание";
+  static CalcOutcome apply(double a, double b) noexcept { return a - b; }
+};
+
+struct Multiply {
+  static constexpr char symbol = '*';
+  static constexpr Role role = Role::GUEST;
+  static constexpr uint8_t arity = 2;
+  static constexpr const char* label = "Умножение";
+  static CalcOutcome apply(double a, double b) noexcept { return a * b; }
+};
+
+struct Divide {
+  static constexpr char symbol = '/';
+  static constexpr Role role = Role::GUEST;
+  static constexpr uint8_t arity = 2;
+  static constexpr const char* label = "Деление";
+  static CalcOutcome apply(double a, double b) noexcept {
+    if (b == 0) return unexpected(CalcError::DIVISION_BY_ZERO);
+    return a / b;
+  }
+};
+
+struct Factorial {
+  static constexpr char symbol = '!';
+  static constexpr Role role = Role::USER;
+  static constexpr uint8_t arity = 1;
+  static constexpr const char* label = "Факториал (только целые числа)";
+  // 170! — последний факториал, помещающийся в double
+  static constexpr int MAX_ARGUMENT = 170;
+
+  static CalcOutcome apply(double a, double) noexcept {
+    // NaN не проходит ни одно сравнение, а его приведение к int — UB;
+    // после трёх проверок a лежит в [0, MAX_ARGUMENT]
+    if (isnan(a)) return unexpected(CalcError::NOT_A_NUMBER);
+    if (a < 0) return unexpected(CalcError::NEGATIVE_FACTORIAL);
+    if (a > MAX_ARGUMENT) return unexpected(CalcError::LARGE_FACTORIAL);
+    // До 20! — точно в long long, дальше с округлением в double
+    int n = static_cast<int>(a);
+    long long exact = 1;
+    for (int i = 2; i <= n && i <= 20; ++i) exact *= i;
+    double result = static_cast<double>(exact);
+    for (int i = 21; i <= n; ++i) result *= i;
+    return result;
+  }
+};
+
+struct Power {
+  static constexpr char symbol = '^';
+  static constexpr Role role = Role::ADMIN;
+  static constexpr uint8_t arity = 2;
+  static constexpr const char* label = "Возведение в степень";
+  static CalcOutcome apply(double a, double b) noexcept { return pow(a, b); }
+};
+
+struct SquareRoot {
+  static constexpr char symbol = 's';
+  static constexpr Role role = Role::ADMIN;
+  static constexpr uint8_t arity = 1;
+  static constexpr const char* label = "Квадратный корень";
+  static CalcOutcome apply(double a, double) noexcept {
+    if (a < 0) return unexpected(CalcError::NEGATIVE_SQRT);
+    return sqrt(a);
+  }
+};
+
+struct Logarithm {
+  static constexpr char symbol = 'l';
+  static constexpr Role role = Role::ADMIN;
+  static constexpr uint8_t arity = 1;
+  static constexpr const char* label = "Логарифм (натуральный)";
+  static CalcOutcome apply(double a, double) noexcept {
+    if (a <= 0) return unexpected(CalcError::NONPOSITIVE_LOG);
+    return log(a);
+  }
+};
+
+}  // namespace calc_ops
+
+// Реестр операций, собираемый на этапе компиляции. dispatch разворачивается
+// в цепочку сравнений с символами и прямые вызовы ядер; entries — таблица
+// для меню и проверки прав в порядке перечисления операций.
+template <typename... Ops>
+struct OperationRegistry {
+  struct Entry {
+    char symbol;
+    Role role;
+    uint8_t arity;
+    const char* label;
+  };
+
+  static constexpr array<Entry, sizeof...(Ops)> entries = {
+      Entry{Ops::symbol, Ops::role, Ops::arity, Ops::label}...};
+
+  static constexpr const Entry* find(char symbol) noexcept {
+    for (const Entry& entry : entries) {
+      if (entry.symbol == symbol) return &entry;
+    }
+    return nullptr;
+  }
+
+  // Неизвестные операции доступны всем: их отклонит dispatch
+  static constexpr Role requiredRole(char symbol) noexcept {
+    const Entry* entry = find(symbol);
+    return entry ? entry->role : Role::GUEST;
+  }
+
+  // Arity == 0 — операция любой арности
+  template <uint8_t Arity = 0>
+  static CalcOutcome dispatch(char symbol, double a, double b) noexcept {
+    CalcOutcome result = unexpected(CalcError::UNSUPPORTED_OPERATION);
+    ((symbol == Ops::symbol && (Arity == 0 || Arity == Ops::arity) &&
+      (result = Ops::apply(a, b), true)) ||
+     ...);
+    return result;
+  }
+
+  static constexpr bool hasUniqueSymbols() {
+    for (size_t i = 0; i < entries.size(); ++i) {
+      for (size_t j = i + 1; j < entries.size(); ++j) {
+        if (entries[i].symbol == entries[j].symbol) return false;
+      }
+    }
+    return true;
+  }
+};
+
+// Порядок определяет порядок строк в меню калькулятора
+using CalculatorOperations =
+    OperationRegistry<calc_ops::Add, calc_ops::Subtract, calc_ops::Multiply,
+                      calc_ops::Divide, calc_ops::Factorial, calc_ops::Power,
+                      calc_ops::SquareRoot, calc_ops::Logarithm>;
+
+static_assert(CalculatorOperations::hasUniqueSymbols(),
+              "символы операций должны быть уникальны");
+
+#endif
@@ -0,0 +1,130 @@
+#pragma once
+
+#ifndef CHAR_CLASSIFIER_H
+#define CHAR_CLASSIFIER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+// Однопроходная классификация символов пароля. ASCII-байты классифицируются
+// таблицей из 256 элементов, последовательности UTF-8 декодируются (заглавные
+// А-Я и строчные а-я), а сплошные ASCII-участки по 16 байт обрабатываются SSE2.
+class CharClassifier {
+ public:
+  enum : uint8_t {
+    UPPER = 1 << 0,
+    LOWER = 1 << 1,
+    DIGIT = 1 << 2,
+    SPECIAL = 1 << 3,  // !@#$%^&*()_+-=[]{};':"\|,.<>/?
+    ALL = UPPER | LOWER | DIGIT | SPECIAL
+  };
+
+  static uint8_t classify(const string& text) {
+    const unsigned char* data =
+        reinterpret_cast<const unsigned char*>(text.data());
+    size_t length = text.size();
+    size_t i = 0;
+    uint8_t classes = 0;
+
+    while (i < length && classes != ALL) {
+#ifdef __SSE2__
+      if (length - i >= 16) {
+        __m128i block =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (_mm_movemask_epi8(block) == 0) {
+          classes |= classifyAsciiBlock(block);
+          i += 16;
+          continue;
+        }
+      }
+#endif
+      unsigned char c = data[i];
+      if (c < 0x80) {
+        classes |= asciiTable()[c];
+        ++i;
+      } else {
+        classes |= classifyMultibyte(data, length, i);
+      }
+    }
+    return classes;
+  }
+
+ private:
+  static constexpr array<uint8_t, 256> buildAsciiTable() {
+    array<uint8_t, 256> table = {};
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = UPPER;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = LOWER;
+    for (int c = '0'; c <= '9'; ++c) table[c] = DIGIT;
+    for (char c : string_view("!@#$%^&*()_+-=[]{};':\"\\|,.<>/?")) {
+      table[static_cast<unsigned char>(c)] = SPECIAL;
+    }
+    return table;
+  }
+
+  static const array<uint8_t, 256>& asciiTable() {
+    static constexpr array<uint8_t, 256> table = buildAsciiTable();
+    return table;
+  }
+
+  // Декодирует одну последовательность UTF-8 начиная с позиции i и сдвигает i.
+  // Некорректные последовательности пропускаются по одному байту.
+  static uint8_t classifyMultibyte(const unsigned char* data, size_t length,
+                                   size_t& i) {
+    unsigned char lead = data[i];
+    size_t extra = (lead & 0xE0) == 0xC0   ? 1
+                   : (lead & 0xF0) == 0xE0 ? 2
+                   : (lead & 0xF8) == 0xF0 ? 3
+                                           : 0;
+    if (extra == 0 || i + extra >= length) {
+      ++i;
+      return 0;
+    }
+
+    uint32_t codepoint = lead & (0x3F >> extra);
+    for (size_t k = 1; k <= extra; ++k) {
+      unsigned char next = data[i + k];
+      if ((next & 0xC0) != 0x80) {
+        ++i;
+        return 0;
+      }
+      codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    i += extra + 1;
+
+    if (codepoint >= 0x0410 && codepoint <= 0x042F) return UPPER;  // А-Я
+    if (codepoint >= 0x0430 && codepoint <= 0x044F) return LOWER;  // а-я
+    return 0;
+  }
+
+#ifdef __SSE2__
+  // Все байты блока < 0x80, поэтому знаковые сравнения корректны
+  static uint8_t classifyAsciiBlock(__m128i block) {
+    auto inRange = [block](char low, char high) {
+      return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8(low - 1)),
+                           _mm_cmplt_epi8(block, _mm_set1_epi8(high + 1)));
+    };
+
+    uint8_t classes = 0;
+    if (_mm_movemask_epi8(inRange('A', 'Z'))) classes |= UPPER;
+    if (_mm_movemask_epi8(inRange('a', 'z'))) classes |= LOWER;
+    if (_mm_movemask_epi8(inRange('0', '9'))) classes |= DIGIT;
+
+    __m128i special = _mm_or_si128(
+        _mm_or_si128(inRange(0x21, 0x2F), inRange(0x3A, 0x40)),
+        _mm_or_si128(inRange(0x5B, 0x5F), inRange(0x7B, 0x7D)));
+    if (_mm_movemask_epi8(special)) classes |= SPECIAL;
+    return classes;
+  }
+#endif
+};
+
+#endif
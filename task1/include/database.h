@@ -3,15 +3,24 @@
 
 #include <sys/stat.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <vector>
 
+#include "file_lock.h"
 #include "hash_generator.h"
+#include "metrics.h"
+#include "shared_attempt_table.h"
+#include "trace.h"
+#include "user_store.h"
 
 using namespace std;
 
@@ -22,11 +31,14 @@ enum class Role {
   ADMIN  // Все операции + управление пользователями
 };
 
-// Структура для хранения информации о пользователе
+// Сведения о пользователе; в базе хранятся в UserStore, здесь — копия
 struct UserInfo {
   string passwordHash;
   Role role;
   bool isActive;
+  // Меняется при смене роли, статуса и пароля: токены с прежним
+  // поколением недействительны
+  uint32_t generation = 0;
 };
 
 // Структура для IP-блокировки
@@ -40,10 +52,41 @@ struct IPLockInfo {
 class UserDatabase {
  private:
   string dbFilename;
-  map<string, UserInfo> users;
+  UserStore users;
   map<string, IPLockInfo> ipLocks;     // Блокировки по IP
+  // Общие для всех процессов блокировки IP; если подключены, ipLocks не
+  // используется
+  SharedAttemptTable* sharedAttempts = nullptr;
   const int MAX_GLOBAL_ATTEMPTS = 10;  // Максимум попыток с IP
   const int GLOBAL_LOCK_TIME = 60;  // Блокировка на 1 минуту
+  const int LOCK_CLEANUP_INTERVAL = 60;  // Период очистки старых блокировок
+  time_t lastLockCleanup = 0;
+  // Источник поколений для UserInfo. Хранится в базе вместе с поколениями
+  // пользователей, иначе после перезапуска удалённый и заново созданный
+  // логин получил бы поколение, уже выданное в старых токенах
+  uint32_t generationCounter = 0;
+  inline static const string GENERATION_HEADER = "#generation";
+  // Отозванные при выходе токены: nonce -> срок действия токена. Хранятся
+  // в базе, чтобы отзыв видели процессы, запущенные с --token, и
+  // удаляются при сохранении, когда токен истёк бы и так
+  map<string, time_t> revokedTokens;
+  inline static const string REVOKED_HEADER = "#revoked";
+
+  // Изменение базы, сделанное этим процессом после загрузки или последнего
+  // сохранения. Если файл за это время сохранил другой процесс, writeUsers
+  // перечитывает его и применяет журнал заново поверх свежей версии
+  struct PendingChange {
+    enum class Kind { ADD, PASSWORD, ROLE, ACTIVE, REMOVE, REVOKE_TOKEN } kind;
+    string login;         // Для REVOKE_TOKEN — nonce токена
+    string passwordHash;  // ADD, PASSWORD
+    Role role;            // ADD, ROLE
+    bool isActive;        // ACTIVE
+    time_t expiresAt;     // REVOKE_TOKEN
+  };
+  vector<PendingChange> pendingChanges;
+  // Отпечаток содержимого файла, который этот процесс прочитал или записал
+  // последним
+  uint64_t fileDigest = 0;
 
   // Inline static константа для ключа шифрования
   inline static const string DEFAULT_ENCRYPTION_KEY = "secure_calc_key_2024!@#";
@@ -68,6 +111,10 @@ class UserDatabase {
   // Очистка старых блокировок (старше 24 часов)
   void cleanupOldLocks() {
     time_t now = time(nullptr);
+    // Полный проход по таблице не чаще раза в минуту
+    if (now - lastLockCleanup < LOCK_CLEANUP_INTERVAL) return;
+    lastLockCleanup = now;
+
     vector<string> toRemove;
 
     for (const auto& [ip, lockInfo] : ipLocks) {
@@ -81,89 +128,34 @@ class UserDatabase {
     }
   }
 
- public:
-  UserDatabase(const string& filename = "../users.dat")
-      : dbFilename(filename) {}
-
-  // Проверка блокировки IP
-  bool isIPLocked(const string& ip) {
-    cleanupOldLocks();
-
-    auto it = ipLocks.find(ip);
-    if (it != ipLocks.end()) {
-      IPLockInfo& info = it->second;
-
-      if (info.attempts >= MAX_GLOBAL_ATTEMPTS) {
-        time_t now = time(nullptr);
-        if (now < info.unlockTime) {
-          return true;
-        } else {
-          // Время блокировки истекло, сбрасываем счетчик
-          info.attempts = 0;
-        }
-      }
+  // Добавление или замена записи (повтор логина в файле перекрывает прежний)
+  void putUser(string_view login, string_view passwordHash, Role role,
+               bool isActive, uint32_t generation) {
+    uint32_t id = users.find(login);
+    if (id == UserStore::NOT_FOUND) {
+      users.insert(login, passwordHash, static_cast<uint8_t>(role), isActive,
+                   generation);
+      return;
     }
-    return false;
+    users.setRole(id, static_cast<uint8_t>(role));
+    users.setActive(id, isActive);
+    users.setGeneration(id, generation);
+    users.setPasswordHash(id, passwordHash);  // Последним: меняет номера
   }
 
-  // Получение времени разблокировки IP
-  time_t getIPUnlockTime(const string& ip) {
-    auto it = ipLocks.find(ip);
-    return it != ipLocks.end() ? it->second.unlockTime : 0;
-  }
-
-  // Регистрация неудачной попытки входа с IP
-  void registerFailedAttempt(const string& ip) {
-    IPLockInfo& info = ipLocks[ip];
-    time_t now = time(nullptr);
-
-    info.attempts++;
-    info.lastAttemptTime = now;
-
-    if (info.attempts >= MAX_GLOBAL_ATTEMPTS) {
-      info.unlockTime = now + GLOBAL_LOCK_TIME;
-    }
-  }
-
-  // Сброс счетчика попыток для IP (при успешном входе)
-  void resetIPAttempts(const string& ip) {
-    auto it = ipLocks.find(ip);
-    if (it != ipLocks.end()) {
-      it->second.attempts = 0;
-    }
-  }
-
-  // Получение информации о блокировке IP
-  IPLockInfo getIPLockInfo(const string& ip) { return ipLocks[ip]; }
-
-  bool loadUsers(const string& encryptionKey = "") {
-    string key = encryptionKey.empty() ? DEFAULT_ENCRYPTION_KEY : encryptionKey;
-
-    ifstream file(dbFilename, ios::binary);
-    if (!file.is_open()) {
-      cout << "База пользователей не найдена. Создана новая." << endl;
-      createDefaultUsers();
-      return saveUsers(key);
-    }
-
-    string encryptedData((istreambuf_iterator<char>(file)),
-                         istreambuf_iterator<char>());
-    file.close();
-
-    if (encryptedData.empty()) {
-      cout << "База пользователей пуста." << endl;
-      createDefaultUsers();
-      return saveUsers(key);
-    }
-
-    // ДЕШИФРОВКА данных
-    string data = simpleDecrypt(encryptedData, key);
-
-    // Парсинг данных
+  // Разбор расшифрованного файла в users (прежнее содержимое заменяется);
+  // возвращает число загруженных записей
+  size_t parseUsers(const string& data) {
+    TRACE_FUNCTION();
     stringstream ss(data);
     string line;
     users.clear();
-    int loadedCount = 0;
+    generationCounter = 0;
+    revokedTokens.clear();
+    // Строка базы длиннее записи в арене, так что размер данных — верхняя
+    // оценка арены
+    users.reserve(count(data.begin(), data.end(), '\n'), data.size());
+    size_t loadedCount = 0;
 
     while (getline(ss, line)) {
       if (line.empty()) continue;
@@ -188,124 +180,448 @@ class UserDatabase {
       }
       parts.push_back(part);
 
-      if (parts.size() == 4) {
+      if (parts.size() == 2 && parts[0] == GENERATION_HEADER) {
+        try {
+          generationCounter = max<uint32_t>(
+              generationCounter, static_cast<uint32_t>(stoul(parts[1])));
+        } catch (const exception&) {
+          cout << "Некорректный счётчик поколений: " << parts[1] << endl;
+        }
+      } else if (parts.size() == 3 && parts[0] == REVOKED_HEADER) {
+        try {
+          revokedTokens[parts[1]] = static_cast<time_t>(stoll(parts[2]));
+        } catch (const exception&) {
+          cout << "Некорректная запись об отозванном токене: " << line << endl;
+        }
+      } else if (parts.size() == 4 || parts.size() == 5) {
+        // Четыре поля — база, записанная до появления поколений
         try {
           string login = parts[0];
           int role = stoi(parts[1]);
           int active = stoi(parts[2]);
           string passwordHash = parts[3];
+          uint32_t generation =
+              parts.size() == 5 ? static_cast<uint32_t>(stoul(parts[4])) : 0;
           if (role < 0 || role > 2) {
             cout << "Некорректная роль для пользователя " << login << ": "
                  << role << endl;
             continue;
           }
-          users[login] = {passwordHash, static_cast<Role>(role),
-                          static_cast<bool>(active)};
+          putUser(login, passwordHash, static_cast<Role>(role),
+                  static_cast<bool>(active), generation);
+          generationCounter = max(generationCounter, generation);
           loadedCount++;
         } catch (const exception& e) {
           cout << "Ошибка при загрузке пользователя: " << e.what()
                << " (данные: " << line << ")" << endl;
         }
       } else {
-        cout << "Некорректный формат строки (ожидалось 4 части, получили "
+        cout << "Некорректный формат строки (ожидалось 5 частей, получили "
              << parts.size() << "): " << line << endl;
       }
     }
-    cout << "Загружено пользователей: " << loadedCount << endl;
-    if (users.empty()) {
-      cout << "Создана новая база пользователей по умолчанию." << endl;
-      createDefaultUsers();
-      return saveUsers(key);
+    users.shrinkToFit();
+    return loadedCount;
+  }
+
+  // Содержимое файла базы как есть; пустая строка, если файла нет
+  string readDatabaseFile() {
+    TRACE_FUNCTION();
+    ifstream file(dbFilename, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+  }
+
+  // FNV-1a: отличает версии файла, записанные разными процессами
+  static uint64_t contentDigest(const string& data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data) {
+      hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  bool applyChange(const PendingChange& change) {
+    if (change.kind == PendingChange::Kind::REVOKE_TOKEN) {
+      revokedTokens[change.login] = change.expiresAt;
+      return true;
+    }
+    if (change.kind == PendingChange::Kind::ADD) {
+      putUser(change.login, change.passwordHash, change.role, true,
+              ++generationCounter);
+      return true;
+    }
+    uint32_t id = users.find(change.login);
+    if (id == UserStore::NOT_FOUND) return false;
+    switch (change.kind) {
+      case PendingChange::Kind::REMOVE:
+        users.erase(id);
+        return true;
+      case PendingChange::Kind::ROLE:
+        users.setRole(id, static_cast<uint8_t>(change.role));
+        break;
+      case PendingChange::Kind::ACTIVE:
+        users.setActive(id, change.isActive);
+        break;
+      default:
+        break;
     }
+    users.setGeneration(id, ++generationCounter);
+    if (change.kind == PendingChange::Kind::PASSWORD) {
+      users.setPasswordHash(id, change.passwordHash);  // Последним
+    }
+    return true;
+  }
 
+  // Применяет изменение и запоминает его до сохранения
+  bool recordChange(PendingChange change) {
+    if (!applyChange(change)) return false;
+    pendingChanges.push_back(std::move(change));
     return true;
   }
 
-  bool saveUsers(const string& encryptionKey = "") {
+  // Под блокировкой файла: если база сохранена другим процессом после
+  // нашего чтения, берётся её версия и поверх применяется свой журнал.
+  // Без этого сохранение устаревшего снимка молча стирало бы чужие
+  // изменения. Пустой или нечитаемый файл не заменяет данные в памяти.
+  void mergeSavedChanges(const string& key) {
+    string onDisk = readDatabaseFile();
+    if (onDisk.empty() || contentDigest(onDisk) == fileDigest) return;
+
+    TRACE_SPAN("writeUsers: merge");
+    UserStore previous = std::move(users);
+    uint32_t previousCounter = generationCounter;
+    if (parseUsers(simpleDecrypt(onDisk, key)) == 0) {
+      users = std::move(previous);
+      generationCounter = previousCounter;
+      return;
+    }
+    for (const PendingChange& change : pendingChanges) applyChange(change);
+  }
+
+  // Сериализация и запись без учёта в метриках (см. saveUsers)
+  bool writeUsers(const string& encryptionKey) {
+    TRACE_FUNCTION();
     string key = encryptionKey.empty() ? DEFAULT_ENCRYPTION_KEY : encryptionKey;
 
-    ofstream file(dbFilename, ios::binary);
-    if (!file.is_open()) {
-      cerr << "Ошибка: Не удалось открыть файл для записи: " << dbFilename
-           << endl;
+    // Сохранения из разных процессов идут по очереди, а запись во
+    // временный файл с переименованием не даёт прочитать файл наполовину
+    // записанным. Без блокировки слияние и общий .tmp снова открыли бы
+    // гонку сохранений, поэтому база тогда не сохраняется (журнал
+    // изменений остаётся до следующей попытки)
+    FileLock lock(dbFilename + ".lock", true);
+    if (!lock.isLocked()) {
+      cerr << "Ошибка: Не удалось заблокировать " << dbFilename
+           << ".lock: " << strerror(errno) << endl;
       return false;
     }
-    // Сериализация данных
+    mergeSavedChanges(key);
+
+    // Сериализация данных: первая строка — счётчик поколений, затем
+    // #revoked:nonce:срок для неистёкших отозванных токенов и
+    // login:роль:активен:хэш:поколение
     stringstream data;
-    for (const auto& [login, userInfo] : users) {
-      string escapedLogin = login;
+    data << GENERATION_HEADER << ":" << generationCounter << "\n";
+    time_t now = time(nullptr);
+    for (auto it = revokedTokens.begin(); it != revokedTokens.end();) {
+      if (it->second <= now) {
+        it = revokedTokens.erase(it);
+        continue;
+      }
+      data << REVOKED_HEADER << ":" << it->first << ":" << it->second << "\n";
+      ++it;
+    }
+    users.forEach([&](uint32_t id) {
+      string escapedLogin(users.login(id));
       size_t pos = 0;
       while ((pos = escapedLogin.find(':', pos)) != string::npos) {
         escapedLogin.replace(pos, 1, "\\:");
         pos += 2;
       }
-      data << escapedLogin << ":" << static_cast<int>(userInfo.role) << ":"
-           << (userInfo.isActive ? "1" : "0") << ":" << userInfo.passwordHash
-           << "\n";
-    }
+      data << escapedLogin << ":" << static_cast<int>(users.role(id)) << ":"
+           << (users.isActive(id) ? "1" : "0") << ":"
+           << users.passwordHash(id) << ":" << users.generation(id) << "\n";
+    });
 
     string dataStr = data.str();
     // ШИФРОВАНИЕ данных перед записью
-    string encryptedOutput = simpleEncrypt(dataStr, key);
+    string encryptedOutput;
+    {
+      TRACE_SPAN("writeUsers: encrypt");
+      encryptedOutput = simpleEncrypt(dataStr, key);
+    }
+
+    string temporary = dbFilename + ".tmp";
+    ofstream file(temporary, ios::binary | ios::trunc);
+    if (!file.is_open()) {
+      cerr << "Ошибка: Не удалось открыть файл для записи: " << temporary
+           << endl;
+      return false;
+    }
+    chmod(temporary.c_str(), S_IRUSR | S_IWUSR);
     file << encryptedOutput;
+    file.close();
     if (!file.good()) {
       cerr << "Ошибка при записи в файл!" << endl;
+      remove(temporary.c_str());
+      return false;
+    }
+    if (rename(temporary.c_str(), dbFilename.c_str()) != 0) {
+      cerr << "Ошибка: Не удалось заменить " << dbFilename << endl;
+      remove(temporary.c_str());
       return false;
     }
-    file.close();
 
     setFilePermissions();
+    fileDigest = contentDigest(encryptedOutput);
+    pendingChanges.clear();
     cout << "База данных успешно сохранена (" << users.size()
          << " пользователей)" << endl;
 
     return true;
   }
 
+ public:
+  UserDatabase(const string& filename = "../users.dat")
+      : dbFilename(filename) {}
+
+  const string& getFilename() const { return dbFilename; }
+
+  void attachSharedAttempts(SharedAttemptTable* table) {
+    sharedAttempts = table;
+  }
+
+  // Проверка блокировки IP
+  bool isIPLocked(const string& ip) {
+    if (sharedAttempts) {
+      int remaining = 0;
+      return sharedAttempts->isLocked(SharedAttemptTable::Kind::IP, ip,
+                                      MAX_GLOBAL_ATTEMPTS, time(nullptr),
+                                      remaining);
+    }
+    cleanupOldLocks();
+
+    auto it = ipLocks.find(ip);
+    if (it != ipLocks.end()) {
+      IPLockInfo& info = it->second;
+
+      if (info.attempts >= MAX_GLOBAL_ATTEMPTS) {
+        time_t now = time(nullptr);
+        if (now < info.unlockTime) {
+          return true;
+        } else {
+          // Время блокировки истекло, сбрасываем счетчик
+          info.attempts = 0;
+        }
+      }
+    }
+    return false;
+  }
+
+  // Получение времени разблокировки IP
+  time_t getIPUnlockTime(const string& ip) {
+    if (sharedAttempts) {
+      SharedAttemptTable::Entry entry;
+      return sharedAttempts->lookup(SharedAttemptTable::Kind::IP, ip, entry)
+                 ? entry.unlockTime
+                 : 0;
+    }
+    auto it = ipLocks.find(ip);
+    return it != ipLocks.end() ? it->second.unlockTime : 0;
+  }
+
+  // Регистрация неудачной попытки входа с IP
+  void registerFailedAttempt(const string& ip) {
+    static Counter& ipLockouts = metrics().counter(
+        "secure_calc_ip_lockouts_total", "Блокировки IP-адресов");
+    time_t now = time(nullptr);
+    int attempts;
+
+    if (sharedAttempts) {
+      attempts = static_cast<int>(sharedAttempts->registerFailure(
+          SharedAttemptTable::Kind::IP, ip, MAX_GLOBAL_ATTEMPTS,
+          GLOBAL_LOCK_TIME, now));
+    } else {
+      IPLockInfo& info = ipLocks[ip];
+      info.attempts++;
+      info.lastAttemptTime = now;
+      if (info.attempts >= MAX_GLOBAL_ATTEMPTS) {
+        info.unlockTime = now + GLOBAL_LOCK_TIME;
+      }
+      attempts = info.attempts;
+    }
+    if (attempts == MAX_GLOBAL_ATTEMPTS) ipLockouts.add();
+  }
+
+  // Сброс счетчика попыток для IP (при успешном входе)
+  void resetIPAttempts(const string& ip) {
+    if (sharedAttempts) {
+      sharedAttempts->reset(SharedAttemptTable::Kind::IP, ip);
+      return;
+    }
+    auto it = ipLocks.find(ip);
+    if (it != ipLocks.end()) {
+      it->second.attempts = 0;
+    }
+  }
+
+  // Получение информации о блокировке IP
+  IPLockInfo getIPLockInfo(const string& ip) {
+    if (sharedAttempts) {
+      SharedAttemptTable::Entry entry;
+      if (!sharedAttempts->lookup(SharedAttemptTable::Kind::IP, ip, entry)) {
+        return {0, 0, 0};
+      }
+      return {static_cast<int>(entry.attempts), entry.unlockTime,
+              entry.lastAttempt};
+    }
+    return ipLocks[ip];
+  }
+
+  bool loadUsers(const string& encryptionKey = "") {
+    static LatencyHistogram& latency = metrics().histogram(
+        "secure_calc_database_load_seconds", "Время загрузки базы");
+    ScopedLatency timer(latency);
+    TRACE_FUNCTION();
+    string key = encryptionKey.empty() ? DEFAULT_ENCRYPTION_KEY : encryptionKey;
+
+    ifstream file(dbFilename, ios::binary);
+    if (!file.is_open()) {
+      cout << "База пользователей не найдена. Создана новая." << endl;
+      createDefaultUsers();
+      return saveUsers(key);
+    }
+
+    string encryptedData;
+    {
+      TRACE_SPAN("loadUsers: read");
+      encryptedData.assign(istreambuf_iterator<char>(file),
+                           istreambuf_iterator<char>());
+      file.close();
+    }
+
+    if (encryptedData.empty()) {
+      cout << "База пользователей пуста." << endl;
+      createDefaultUsers();
+      return saveUsers(key);
+    }
+
+    fileDigest = contentDigest(encryptedData);
+    pendingChanges.clear();
+    size_t loadedCount = parseUsers(simpleDecrypt(encryptedData, key));
+    cout << "Загружено пользователей: " << loadedCount << endl;
+    if (users.size() == 0) {
+      cout << "Создана новая база пользователей по умолчанию." << endl;
+      createDefaultUsers();
+      return saveUsers(key);
+    }
+
+    return true;
+  }
+
+  bool saveUsers(const string& encryptionKey = "") {
+    static LatencyHistogram& latency = metrics().histogram(
+        "secure_calc_database_save_seconds", "Время сохранения базы");
+    static Counter& saved = metrics().counter(
+        "secure_calc_database_saves_total", "Сохранения базы",
+        "result=\"success\"");
+    static Counter& failed = metrics().counter(
+        "secure_calc_database_saves_total", "Сохранения базы",
+        "result=\"failure\"");
+    ScopedLatency timer(latency);
+    bool ok = writeUsers(encryptionKey);
+    (ok ? saved : failed).add();
+    return ok;
+  }
+
   void createDefaultUsers() {
-    users = {
-        {"admin",
-         {SecurePasswordHasher::hashPassword("Admin123!"), Role::ADMIN, true}},
-        {"user1",
-         {SecurePasswordHasher::hashPassword("User123!"), Role::USER, true}},
-        {"guest",
-         {SecurePasswordHasher::hashPassword("Guest123!"), Role::GUEST, true}}};
+    TRACE_FUNCTION();
+    users.clear();
+    putUser("admin", SecurePasswordHasher::hashPassword("Admin123!"),
+            Role::ADMIN, true, 0);
+    putUser("user1", SecurePasswordHasher::hashPassword("User123!"),
+            Role::USER, true, 0);
+    putUser("guest", SecurePasswordHasher::hashPassword("Guest123!"),
+            Role::GUEST, true, 0);
   }
 
   // Методы доступа к пользователям
   bool userExists(const string& login) const {
-    return users.find(login) != users.end();
+    return users.find(login) != UserStore::NOT_FOUND;
+  }
+
+  optional<UserInfo> getUser(const string& login) const {
+    uint32_t id = users.find(login);
+    if (id == UserStore::NOT_FOUND) return nullopt;
+    return UserInfo{users.passwordHash(id), static_cast<Role>(users.role(id)),
+                    users.isActive(id), users.generation(id)};
   }
 
-  UserInfo* getUser(const string& login) {
-    auto it = users.find(login);
-    return it != users.end() ? &it->second : nullptr;
+  // Логины по алфавиту
+  vector<string> getLogins() const {
+    vector<string> logins;
+    logins.reserve(users.size());
+    users.forEach([&](uint32_t id) { logins.emplace_back(users.login(id)); });
+    sort(logins.begin(), logins.end());
+    return logins;
   }
 
-  const map<string, UserInfo>& getAllUsers() const { return users; }
+  size_t getUserCount() const { return users.size(); }
 
   void addUser(const string& login, const string& password, Role role) {
-    users[login] = {SecurePasswordHasher::hashPassword(password), role, true};
+    TRACE_FUNCTION();
+    recordChange({PendingChange::Kind::ADD, login,
+                  SecurePasswordHasher::hashPassword(password), role, true,
+                  0});
+  }
+
+  bool changePassword(const string& login, const string& newPassword) {
+    TRACE_FUNCTION();
+    if (!userExists(login)) return false;
+    return recordChange({PendingChange::Kind::PASSWORD, login,
+                         SecurePasswordHasher::hashPassword(newPassword),
+                         Role::GUEST, true, 0});
+  }
+
+  // Отзыв одного токена по его nonce; другим процессам виден после
+  // сохранения базы
+  void revokeToken(const string& nonce, time_t expiresAt) {
+    recordChange({PendingChange::Kind::REVOKE_TOKEN, nonce, "", Role::GUEST,
+                  true, expiresAt});
+  }
+
+  bool isTokenRevoked(const string& nonce) const {
+    return revokedTokens.count(nonce) > 0;
+  }
+
+  // Поколение учётной записи; токены с другим поколением недействительны
+  bool getUserGeneration(const string& login, uint32_t& generation) const {
+    uint32_t id = users.find(login);
+    if (id == UserStore::NOT_FOUND) return false;
+    generation = users.generation(id);
+    return true;
   }
 
   bool updateUserRole(const string& login, Role newRole) {
-    auto it = users.find(login);
-    if (it != users.end()) {
-      it->second.role = newRole;
-      return true;
-    }
-    return false;
+    TRACE_FUNCTION();
+    return recordChange(
+        {PendingChange::Kind::ROLE, login, "", newRole, true, 0});
   }
 
+  // В журнал попадает новое значение, а не переключение: повтор поверх
+  // чужой версии файла не должен менять статус обратно
   bool toggleUserActive(const string& login) {
-    auto it = users.find(login);
-    if (it != users.end()) {
-      it->second.isActive = !it->second.isActive;
-      return true;
-    }
-    return false;
+    TRACE_FUNCTION();
+    uint32_t id = users.find(login);
+    if (id == UserStore::NOT_FOUND) return false;
+    return recordChange({PendingChange::Kind::ACTIVE, login, "", Role::GUEST,
+                         !users.isActive(id), 0});
   }
 
-  bool deleteUser(const string& login) { return users.erase(login) > 0; }
+  bool deleteUser(const string& login) {
+    TRACE_FUNCTION();
+    return recordChange(
+        {PendingChange::Kind::REMOVE, login, "", Role::GUEST, true, 0});
+  }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#ifndef DEADLINE_SCHEDULER_H
+#define DEADLINE_SCHEDULER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// Планировщик отложенных событий: куча дедлайнов + один timerfd.
+// Таймер всегда взведён на ближайший дедлайн, поэтому ожидающие сессии
+// не потребляют процессорное время и просыпаются ровно в срок.
+// Если рабочий поток завершается (деструктор или ошибка poll), ожидающие
+// обратные вызовы выполняются досрочно, чтобы не оставить потоки в waitUntil
+// заблокированными навсегда.
+class DeadlineScheduler {
+ public:
+  using Clock = chrono::system_clock;
+  using TimePoint = Clock::time_point;
+  using Callback = function<void()>;
+
+  DeadlineScheduler();
+  ~DeadlineScheduler();
+
+  DeadlineScheduler(const DeadlineScheduler&) = delete;
+  DeadlineScheduler& operator=(const DeadlineScheduler&) = delete;
+
+  // Регистрация обратного вызова на момент deadline; возвращает id задачи
+  // или 0, если планировщик уже остановлен
+  uint64_t schedule(TimePoint deadline, Callback callback);
+
+  // Отмена задачи, которая ещё не сработала
+  bool cancel(uint64_t id);
+
+  // Блокирует вызывающий поток до наступления deadline; при остановленном
+  // планировщике возвращается сразу
+  void waitUntil(TimePoint deadline);
+
+  size_t pendingCount();
+
+ private:
+  struct Entry {
+    TimePoint deadline;
+    uint64_t id;
+
+    bool operator>(const Entry& other) const {
+      return deadline != other.deadline ? deadline > other.deadline
+                                        : id > other.id;
+    }
+  };
+
+  int timerFd;
+  int wakeFd;
+  bool stopping = false;
+  uint64_t nextId = 1;
+
+  mutex mtx;
+  priority_queue<Entry, vector<Entry>, greater<Entry>> deadlines;
+  unordered_map<uint64_t, Callback> callbacks;
+  thread worker;
+
+  void run();
+  void armTimer();
+  void wakeWorker();
+  void drainOnExit();
+};
+
+#endif
@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef EXPRESSION_ENGINE_H
+#define EXPRESSION_ENGINE_H
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "calculator_engine.h"
+
+using namespace std;
+
+// Язык выражений калькулятора:
+//   выражение  := [имя '='] сумма
+//   сумма      := произведение (('+' | '-') произведение)*
+//   произведение := унарное (('*' | '/') унарное)*
+//   унарное    := ('-' | '+') унарное | степень
+//   степень    := постфикс ['^' унарное]        (правоассоциативна)
+//   постфикс   := первичное '!'*
+//   первичное  := число | имя | функция '(' аргументы ')' | '(' сумма ')'
+// Функции: sqrt(x), log(x) и ln(x) (натуральный), fact(x), pow(x, y).
+// Переменная ans хранит результат последнего вычисления.
+
+enum class ExprOpcode : uint8_t {
+  LOAD_CONST,  // r[dst] = constants[index]
+  LOAD_VAR,    // r[dst] = variables[index]
+  STORE_VAR,   // variables[index] = r[dst]
+  NEG,         // r[dst] = -r[a]
+  ADD,         // r[dst] = r[a] + r[b]
+  SUB,
+  MUL,
+  DIV,
+  POW,
+  SQRT,  // r[dst] = sqrt(r[a])
+  LOG,
+  FACT,
+  RETURN  // результат — r[dst]
+};
+
+// Инструкция регистровой машины: 4 байта. Для LOAD_*/STORE_VAR индекс
+// константы или переменной хранится в (a | b << 8).
+struct ExprInstruction {
+  ExprOpcode opcode;
+  uint8_t dst;
+  uint8_t a;
+  uint8_t b;
+
+  uint16_t index() const { return static_cast<uint16_t>(a | (b << 8)); }
+};
+
+struct CompiledExpression {
+  vector<ExprInstruction> code;
+  vector<double> constants;
+  uint16_t registerCount = 0;
+};
+
+// Компилятор и интерпретатор выражений одной сессии. Права роли проверяются
+// при компиляции для каждой операции, поэтому скомпилированное выражение
+// выполняется без проверок; кэш скомпилированных выражений тоже свой у
+// каждой сессии, так как индексы переменных привязаны к её таблице.
+class ExpressionEngine {
+ public:
+  // Ошибки выражений содержат имена переменных и позиции, поэтому текст
+  // здесь — строка, а не статическое сообщение CalculatorEngine
+  struct CalculationResult {
+    bool success;
+    double value;
+    string errorMessage;
+  };
+
+  static constexpr size_t MAX_REGISTERS = 256;
+  // Вложенность скобок, аргументов функций, унарных знаков и степеней:
+  // разбор рекурсивен, и без предела строка из миллиона '-' или '('
+  // переполняет стек
+  static constexpr size_t MAX_NESTING = 256;
+  // Высота дерева разбора. Цепочки x + x + ... и x!!! растят её без
+  // вложенности, а генерация кода тоже рекурсивна
+  static constexpr size_t MAX_TREE_HEIGHT = 4096;
+  static constexpr size_t MAX_VARIABLES = 0xFF00;
+
+  explicit ExpressionEngine(Role sessionRole, size_t cacheCapacity = 256);
+
+  // nullptr и error при синтаксической ошибке или нехватке прав
+  shared_ptr<const CompiledExpression> compile(const string& source,
+                                               string& error);
+  CalculationResult execute(const CompiledExpression& program);
+
+  // compile (через кэш) + execute
+  CalculationResult evaluate(const string& source);
+
+  // false, если таблица переменных заполнена
+  bool setVariable(const string& name, double value);
+  bool getVariable(const string& name, double& value) const;
+
+  size_t getCacheHits() const { return cacheHits; }
+  size_t getCacheMisses() const { return cacheMisses; }
+  size_t getCachedCount() const { return cacheIndex.size(); }
+
+  // Слот переменной (создаётся при первом упоминании); false, если новой
+  // переменной уже нет места
+  bool variableSlot(const string& name, uint16_t& slot);
+
+ private:
+  Role role;
+
+  unordered_map<string, uint16_t> variableSlots;
+  vector<string> variableNames;
+  vector<double> variableValues;
+  vector<uint8_t> variableDefined;
+  uint16_t ansSlot;
+
+  size_t capacity;
+  list<pair<string, shared_ptr<const CompiledExpression>>> lru;
+  unordered_map<string,
+                list<pair<string, shared_ptr<const CompiledExpression>>>::iterator>
+      cacheIndex;
+  size_t cacheHits = 0;
+  size_t cacheMisses = 0;
+
+  // Удаляет переменные, созданные после первых count
+  void dropVariables(size_t count);
+};
+
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+#ifndef FILE_LOCK_H
+#define FILE_LOCK_H
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+
+using namespace std;
+
+// Рекомендательная блокировка flock на отдельном файле. Сами данные
+// заменяются переименованием, и блокировка на их inode пропала бы вместе
+// со старой версией файла. Снимается при разрушении объекта.
+class FileLock {
+ public:
+  FileLock(const string& path, bool exclusive) {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) return;
+    int rc;
+    do {
+      rc = flock(fd, exclusive ? LOCK_EX : LOCK_SH);
+    } while (rc != 0 && errno == EINTR);
+    if (rc != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+
+  ~FileLock() {
+    if (fd >= 0) close(fd);
+  }
+
+  FileLock(const FileLock&) = delete;
+  FileLock& operator=(const FileLock&) = delete;
+
+  bool isLocked() const { return fd >= 0; }
+
+ private:
+  int fd = -1;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#pragma once
+
+#ifndef FRAGMENT_MATCHER_H
+#define FRAGMENT_MATCHER_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <queue>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Поиск запрещённых фрагментов в пароле автоматом Ахо-Корасик.
+//
+// Байты входа отображаются таблицей из 256 элементов в компактный алфавит:
+// каждый символ, встречающийся во фрагментах, получает свой класс, а ASCII
+// буквы обоих регистров — общий класс (регистр сворачивается прямо при
+// чтении, без копии строки). Все остальные байты попадают в класс 0.
+// Переходы хранятся плотной таблицей состояний × классов, поэтому проверка —
+// один линейный проход по паролю с одним обращением к таблице на байт.
+//
+// Размер таблицы — число состояний бора × размер алфавита, и варианты
+// leetspeak умножают число состояний до 32 раз, поэтому таблица ограничена
+// MAX_TABLE_BYTES: список сверх предела отклоняется при компиляции политики.
+class FragmentMatcher {
+ public:
+  static constexpr size_t MAX_TABLE_BYTES = size_t(16) << 20;
+
+ private:
+  array<uint16_t, 256> symbolOf = {};
+  uint32_t alphabetSize = 1;
+  vector<uint32_t> transitions;  // state * alphabetSize + symbol
+  vector<uint8_t> terminal;
+  size_t patternCount = 0;
+
+  static unsigned char fold(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+  }
+
+ public:
+  FragmentMatcher() {
+    string error;
+    compile({}, error);
+  }
+
+  // false и error, если таблица переходов превысит MAX_TABLE_BYTES
+  bool compile(const vector<string>& fragments, string& error) {
+    const size_t maxEntries = MAX_TABLE_BYTES / sizeof(uint32_t);
+
+    // Алфавит: классы выдаются символам фрагментов после свёртки регистра
+    symbolOf.fill(0);
+    alphabetSize = 1;
+    for (const string& fragment : fragments) {
+      for (unsigned char c : fragment) {
+        unsigned char folded = fold(c);
+        if (symbolOf[folded] == 0) symbolOf[folded] = alphabetSize++;
+      }
+    }
+    for (int c = 'A'; c <= 'Z'; ++c) symbolOf[c] = symbolOf[fold(c)];
+
+    // Бор: переход 0 означает отсутствие ребра (в корень рёбер не бывает)
+    transitions.assign(alphabetSize, 0);
+    terminal.assign(1, 0);
+    patternCount = 0;
+    for (const string& fragment : fragments) {
+      if (fragment.empty()) continue;
+      uint32_t state = 0;
+      for (unsigned char c : fragment) {
+        uint32_t symbol = symbolOf[c];
+        uint32_t& next = transitions[state * alphabetSize + symbol];
+        if (next == 0) {
+          if (transitions.size() + alphabetSize > maxEntries) {
+            error = "список запрещённых фрагментов слишком велик: таблица "
+                    "автомата превышает " +
+                    to_string(MAX_TABLE_BYTES >> 20) + " МиБ";
+            compile({}, error);
+            return false;
+          }
+          next = static_cast<uint32_t>(terminal.size());
+          terminal.push_back(0);
+          transitions.resize(transitions.size() + alphabetSize, 0);
+        }
+        state = transitions[state * alphabetSize + symbol];
+      }
+      terminal[state] = 1;
+      patternCount++;
+    }
+
+    // Обход в ширину: ссылки неудач и достройка до полного ДКА
+    vector<uint32_t> failure(terminal.size(), 0);
+    queue<uint32_t> pending;
+    for (uint32_t symbol = 0; symbol < alphabetSize; ++symbol) {
+      uint32_t next = transitions[symbol];
+      if (next != 0) pending.push(next);
+    }
+    while (!pending.empty()) {
+      uint32_t state = pending.front();
+      pending.pop();
+      terminal[state] |= terminal[failure[state]];
+
+      for (uint32_t symbol = 0; symbol < alphabetSize; ++symbol) {
+        uint32_t& next = transitions[state * alphabetSize + symbol];
+        uint32_t fallback = transitions[failure[state] * alphabetSize + symbol];
+        if (next != 0) {
+          failure[next] = fallback;
+          pending.push(next);
+        } else {
+          next = fallback;
+        }
+      }
+    }
+    return true;
+  }
+
+  // true, если текст содержит хотя бы один фрагмент (без учёта регистра)
+  bool matches(const string& text) const {
+    uint32_t state = 0;
+    for (unsigned char c : text) {
+      state = transitions[state * alphabetSize + symbolOf[c]];
+      if (terminal[state]) return true;
+    }
+    return false;
+  }
+
+  size_t fragmentCount() const { return patternCount; }
+  size_t stateCount() const { return terminal.size(); }
+
+  // Варианты фрагмента с заменами в стиле leetspeak (a→4/@, e→3, i→1/!,
+  // o→0, s→5/$, t→7); исходный фрагмент идёт первым
+  static vector<string> expandLeetspeak(const string& fragment,
+                                        size_t maxVariants = 32) {
+    vector<string> variants = {fragment};
+    for (size_t pos = 0; pos < fragment.size(); ++pos) {
+      const char* replacements = "";
+      switch (fold(fragment[pos])) {
+        case 'a':
+          replacements = "4@";
+          break;
+        case 'e':
+          replacements = "3";
+          break;
+        case 'i':
+          replacements = "1!";
+          break;
+        case 'o':
+          replacements = "0";
+          break;
+        case 's':
+          replacements = "5$";
+          break;
+        case 't':
+          replacements = "7";
+          break;
+      }
+      size_t existing = variants.size();
+      for (const char* r = replacements; *r; ++r) {
+        for (size_t v = 0; v < existing && variants.size() < maxVariants; ++v) {
+          string variant = variants[v];
+          variant[pos] = *r;
+          variants.push_back(variant);
+        }
+      }
+    }
+    return variants;
+  }
+
+  // Чтение списка фрагментов: по одному в строке, '#' — комментарий
+  static bool loadFragments(const string& path, bool expandLeet,
+                            vector<string>& fragments, string& error) {
+    ifstream file(path);
+    if (!file.is_open()) {
+      error = "не удалось открыть список фрагментов: " + path;
+      return false;
+    }
+    string line;
+    while (getline(file, line)) {
+      while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+        line.pop_back();
+      }
+      if (line.empty() || line[0] == '#') continue;
+      if (expandLeet) {
+        for (const string& variant : expandLeetspeak(line)) {
+          fragments.push_back(variant);
+        }
+      } else {
+        fragments.push_back(line);
+      }
+    }
+    return true;
+  }
+};
+
+#endif
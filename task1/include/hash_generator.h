@@ -9,6 +9,8 @@
 #include <sstream>
 #include <string>
 
+#include "trace.h"
+
 using namespace std;
 
 class SecurePasswordHasher {
@@ -26,6 +28,7 @@ class SecurePasswordHasher {
   }
 
   static string hashPassword(const string& password) {
+    TRACE_FUNCTION();
     string salt = generateSalt(16);
 
     // Создаем salted password и хэшируем
@@ -38,6 +41,7 @@ class SecurePasswordHasher {
   }
 
   static bool verifyPassword(const string& password, const string& storedHash) {
+    TRACE_FUNCTION();
     // Ищем наш разделитель |
     size_t delimiter = storedHash.find('|');
     if (delimiter == string::npos) return false;
@@ -49,10 +53,20 @@ class SecurePasswordHasher {
     size_t hashValue = hash<string>{}(saltedPassword);
     string newHash = bytesToHex((unsigned char*)&hashValue, sizeof(hashValue));
 
-    return originalHash == newHash;
+    return constantTimeEquals(originalHash, newHash);
   }
 
  private:
+  // Сравнение без раннего выхода: время не зависит от места расхождения
+  static bool constantTimeEquals(const string& a, const string& b) {
+    if (a.length() != b.length()) return false;
+    unsigned char diff = 0;
+    for (size_t i = 0; i < a.length(); ++i) {
+      diff |= static_cast<unsigned char>(a[i] ^ b[i]);
+    }
+    return diff == 0;
+  }
+
   static string bytesToHex(unsigned char* data, size_t length) {
     stringstream ss;
     ss << hex << setfill('0');
@@ -3,9 +3,15 @@
 #ifndef MENU_MANAGER_H
 #define MENU_MANAGER_H
 
+#include <memory>
+#include <string>
+
 #include "auth_manager.h"
+#include "calculation_history.h"
 #include "calculator_engine.h"
+#include "expression_engine.h"
 #include "password_policy.h"
+#include "session_manager.h"
 
 using namespace std;
 
@@ -16,16 +22,32 @@ class MenuManager {
   PasswordPolicy& passwordPolicy;
   AuthManager& authManager;
   CalculatorEngine& calculatorEngine;
+  // История вычислений текущей сессии; выгружается при выходе
+  unique_ptr<CalculationHistory> history;
+  string historyExportPath;
+  // Токен текущей сессии: выход отзывает только его
+  SessionManager* sessionManager = nullptr;
+  string sessionToken;
 
   void displayCalculatorMenu(const UserSession& session);
   void handleBasicOperations(char op, const UserSession& session);
   void handleAdvancedOperations(char op, const UserSession& session);
+  void handleExpression(ExpressionEngine& expressions);
+  void handleIntegerOperations(const UserSession& session);
+  void handleHistory(ExpressionEngine& expressions);
+  void finishSession(const UserSession& session);
   bool validatePermission(const UserSession& session, char operation);
 
  public:
   MenuManager(UserDatabase& db, SecurityLogger& logger, PasswordPolicy& policy,
               AuthManager& auth, CalculatorEngine& calc);
 
+  // Размер истории в записях и файл выгрузки при выходе (пусто — без
+  // выгрузки; ".csv" — текст, иначе двоичный формат)
+  void configureHistory(size_t capacity, const string& exportPath);
+
+  void attachSessionToken(SessionManager& manager, const string& token);
+
   void showCalculator(const UserSession& session);
   void showAdminPanel(UserSession& session);
   void showChangePassword(const UserSession& session);
@@ -0,0 +1,192 @@
+#pragma once
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Метрики времени работы: счётчики и гистограммы задержек. Запись — одна
+// атомарная операция без блокировок в ячейке, закреплённой за потоком;
+// чтение суммирует ячейки. Потоки раздаются по ячейкам по кругу при первом
+// обращении, поэтому до METRIC_SHARDS потоков не делят кэш-линию.
+
+constexpr size_t METRIC_SHARDS = 16;
+
+inline size_t metricShard() noexcept {
+  static atomic<size_t> nextShard{0};
+  // Константная инициализация: без скрытой проверки при каждом обращении
+  thread_local size_t shard = METRIC_SHARDS;
+  if (shard == METRIC_SHARDS) {
+    shard = nextShard.fetch_add(1, memory_order_relaxed) % METRIC_SHARDS;
+  }
+  return shard;
+}
+
+class Counter {
+ public:
+  void add(uint64_t amount = 1) noexcept {
+    cells[metricShard()].value.fetch_add(amount, memory_order_relaxed);
+  }
+
+  uint64_t value() const noexcept {
+    uint64_t total = 0;
+    for (const Cell& cell : cells) {
+      total += cell.value.load(memory_order_relaxed);
+    }
+    return total;
+  }
+
+ private:
+  struct alignas(64) Cell {
+    atomic<uint64_t> value{0};
+  };
+  array<Cell, METRIC_SHARDS> cells;
+};
+
+// Гистограмма задержек в наносекундах с логарифмическими корзинами в духе
+// HDR: октава [2^e, 2^(e+1)) делится на SUB_BUCKETS равных частей, так что
+// относительная погрешность не больше 1/SUB_BUCKETS при любой величине.
+// Значения от 2^MAX_EXPONENT нс (около 18 минут) попадают в последнюю
+// корзину.
+class LatencyHistogram {
+ public:
+  static constexpr int SUB_BUCKET_BITS = 3;
+  static constexpr uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr int MAX_EXPONENT = 40;
+  static constexpr size_t BUCKETS =
+      (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+  static constexpr size_t SHARDS = 4;  // Задержки пишутся реже счётчиков
+
+  struct Snapshot {
+    vector<uint64_t> counts;
+    uint64_t count = 0;
+    uint64_t sumNs = 0;
+
+    // Верхняя граница корзины, в которую попадает доля q значений
+    uint64_t quantileNs(double q) const;
+  };
+
+  static constexpr size_t bucketIndex(uint64_t ns) noexcept {
+    if (ns < SUB_BUCKETS) return static_cast<size_t>(ns);
+    int exponent = bit_width(ns) - 1;
+    if (exponent >= MAX_EXPONENT) return BUCKETS - 1;
+    uint64_t sub = (ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+    return static_cast<size_t>((exponent - SUB_BUCKET_BITS + 1) *
+                                   SUB_BUCKETS +
+                               sub);
+  }
+
+  // Исключающая верхняя граница корзины, нс
+  static constexpr uint64_t bucketUpperBound(size_t index) noexcept {
+    if (index < SUB_BUCKETS) return index + 1;
+    int exponent = static_cast<int>(index / SUB_BUCKETS) - 1 + SUB_BUCKET_BITS;
+    uint64_t sub = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub + 1) << (exponent - SUB_BUCKET_BITS);
+  }
+
+  void record(uint64_t ns) noexcept {
+    Shard& shard = shards[metricShard() % SHARDS];
+    shard.counts[bucketIndex(ns)].fetch_add(1, memory_order_relaxed);
+    shard.sumNs.fetch_add(ns, memory_order_relaxed);
+  }
+
+  Snapshot snapshot() const;
+
+ private:
+  struct alignas(64) Shard {
+    array<atomic<uint64_t>, BUCKETS> counts{};
+    atomic<uint64_t> sumNs{0};
+  };
+  array<Shard, SHARDS> shards;
+};
+
+// Замер времени блока: ScopedLatency timer(histogram);
+class ScopedLatency {
+ public:
+  explicit ScopedLatency(LatencyHistogram& histogram)
+      : histogram(histogram), start(chrono::steady_clock::now()) {}
+  ~ScopedLatency() {
+    histogram.record(static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() -
+                                                   start)
+            .count()));
+  }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  LatencyHistogram& histogram;
+  chrono::steady_clock::time_point start;
+};
+
+// Реестр метрик процесса. Метрика создаётся при первом обращении и живёт
+// до конца программы, поэтому ссылку можно сохранить и писать в неё без
+// обращения к реестру. labels — метки в синтаксисе Prometheus без скобок,
+// например: result="success".
+class MetricsRegistry {
+ public:
+  static MetricsRegistry& global();
+
+  Counter& counter(const string& name, const string& help,
+                   const string& labels = "");
+  LatencyHistogram& histogram(const string& name, const string& help,
+                              const string& labels = "");
+
+  // Текстовый формат Prometheus 0.0.4; гистограммы — в секундах
+  string renderPrometheus() const;
+  // Сводка для панели администратора: счётчики и перцентили задержек
+  string renderSummary() const;
+
+ private:
+  struct Family {
+    string help;
+    bool isHistogram = false;
+    map<string, unique_ptr<Counter>> counters;  // По меткам
+    map<string, unique_ptr<LatencyHistogram>> histograms;
+  };
+
+  mutable mutex lock;
+  map<string, Family> families;
+};
+
+inline MetricsRegistry& metrics() { return MetricsRegistry::global(); }
+
+// Периодически записывает метрики в файл для textfile-коллектора
+// node_exporter. Файл заменяется переименованием, чтобы коллектор никогда
+// не прочитал его наполовину записанным. Снимок пишется сразу при запуске
+// и последний — при остановке.
+class MetricsExporter {
+ public:
+  MetricsExporter(MetricsRegistry& registry, const string& path,
+                  unsigned intervalSeconds);
+  ~MetricsExporter();
+
+  MetricsExporter(const MetricsExporter&) = delete;
+  MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+  bool writeSnapshot(string& error);
+
+ private:
+  MetricsRegistry& registry;
+  string path;
+  unsigned intervalSeconds;
+  int stopFd = -1;
+  thread worker;
+
+  void run();
+};
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+#ifndef PARALLEL_BATCH_H
+#define PARALLEL_BATCH_H
+
+#include <cstddef>
+#include <string>
+
+#include "batch_processor.h"
+
+using namespace std;
+
+// Время по стадиям конвейера. Время вычисления — сумма по всем потокам,
+// ожидания — время простоя стадии из-за соседней.
+struct PipelineStats {
+  BatchStats totals;
+  size_t chunks = 0;
+  size_t steals = 0;       // Фрагментов, взятых из чужой очереди
+  size_t maxBuffered = 0;  // Наибольшее число фрагментов в работе
+  double splitSeconds = 0;
+  double readerWaitSeconds = 0;  // Чтение ждало освобождения буферов
+  double evaluateSeconds = 0;
+  double writeSeconds = 0;
+  double writerWaitSeconds = 0;  // Запись ждала очередной фрагмент
+  double wallSeconds = 0;
+};
+
+// Параллельный пакетный режим для больших файлов. Файл отображается в
+// память и режется на фрагменты примерно по chunkSize байт по границам
+// строк. Фрагменты раздаются по очередям рабочих потоков; освободившийся
+// поток забирает работу с хвоста чужой очереди. Результаты выводятся в
+// порядке входа: запись ждёт очередной фрагмент, а чтение не раздаёт
+// больше maxInFlight фрагментов вперёд, так что память ограничена
+// maxInFlight буферами вывода.
+class ParallelBatchPipeline {
+ public:
+  static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+  ParallelBatchPipeline(const BatchProcessor& processor, unsigned threads,
+                        size_t chunkSize = DEFAULT_CHUNK_SIZE,
+                        size_t maxInFlight = 0);  // 0 — 4 на поток
+
+  bool run(const string& path, int outputFd, PipelineStats& stats,
+           string& error);
+
+ private:
+  const BatchProcessor& processor;
+  unsigned threadCount;
+  size_t chunkSize;
+  size_t maxInFlight;
+};
+
+#endif
@@ -3,72 +3,176 @@
 #ifndef PASSWORD_POLICY_H
 #define PASSWORD_POLICY_H
 
-#include <regex>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
-#include <vector>
+#include <thread>
+
+#include "policy_program.h"
+#include "trace.h"
 
 using namespace std;
 
+// Политика паролей хранится как скомпилированная PolicyProgram.
+// validatePassword берёт текущую программу одной атомарной загрузкой
+// указателя, без мьютекса публикации; изменения (setters, загрузка файла
+// политики) собирают новую программу и публикуют её заменой указателя.
+//
+// atomic<shared_ptr> в libstdc++ не свободен от блокировок (is_lock_free()
+// == false: загрузка берёт внутренний спинлок), поэтому освобождение
+// устроено по схеме эпох, как в userspace RCU. Проверка отмечается в
+// счётчике текущей эпохи; публикация после замены указателя дважды меняет
+// эпоху и ждёт, пока опустеет счётчик прежней, и только потом удаляет
+// старую программу вместе с автоматом фрагментов и отображённым фильтром
+// утечек. Проверка обходится двумя атомарными инкрементами без ожидания;
+// ждёт только публикация, пока завершатся уже начатые проверки.
 class PasswordPolicy {
  private:
-  size_t minLength = 8;
-  bool requireUpper = true;
-  bool requireLower = true;
-  bool requireDigits = true;
-  bool requireSpecial = true;
-  vector<string> commonPasswords = {"password", "admin", "111", "123"};
-
- public:
-  struct ValidationResult {
-    bool isValid;
-    string message;
+  // Счётчики на отдельных строках кэша, чтобы не делить их с указателем
+  struct alignas(64) ReaderCount {
+    atomic<uint64_t> value{0};
   };
 
-  ValidationResult validatePassword(const string& password) {
-    if (password.length() < minLength) {
-      return {false, "Пароль должен содержать не менее " +
-                         to_string(minLength) + " символов"};
+  // Проверка, учтённая в счётчике эпохи на время своего выполнения
+  class ReadGuard {
+   public:
+    explicit ReadGuard(const PasswordPolicy& policy) {
+      counter = &policy.readers[policy.epoch.load()].value;
+      counter->fetch_add(1);
     }
+    ~ReadGuard() { counter->fetch_sub(1, memory_order_release); }
 
-    if (requireUpper && !regex_search(password, regex("[A-ZА-Я]"))) {
-      return {false, "Пароль должен содержать заглавные буквы"};
-    }
+    ReadGuard(const ReadGuard&) = delete;
+    ReadGuard& operator=(const ReadGuard&) = delete;
 
-    if (requireLower && !regex_search(password, regex("[a-zа-я]"))) {
-      return {false, "Пароль должен содержать строчные буквы"};
-    }
+   private:
+    atomic<uint64_t>* counter;
+  };
 
-    if (requireDigits && !regex_search(password, regex("[0-9]"))) {
-      return {false, "Пароль должен содержать цифры"};
-    }
+  atomic<const PolicyProgram*> current{nullptr};
+  mutable ReaderCount readers[2];
+  atomic<unsigned> epoch{0};
+  mutex publishMutex;  // Сериализует только публикацию
+  PolicyConfig config;
+  size_t version = 0;  // Число опубликованных программ
 
-    if (requireSpecial &&
-        !regex_search(password,
-                      regex("[!@#$%^&*()_+\\-=\\[\\]{};':\"\\\\|,.<>\\/?]"))) {
-      return {false, "Пароль должен содержать специальные символы"};
+  // Две смены эпохи: проверка, прочитавшая эпоху до первой смены, но
+  // учтённая после того, как её счётчик опустел, уже видит новую программу,
+  // однако держит её в том же счётчике и дожидается при второй смене
+  void waitForReaders() {
+    for (int flip = 0; flip < 2; ++flip) {
+      unsigned previous = epoch.load();
+      epoch.store(previous ^ 1);
+      while (readers[previous].value.load() != 0) this_thread::yield();
     }
+  }
+
+  bool publish(const PolicyConfig& newConfig, string& error) {
+    unique_ptr<const PolicyProgram> program =
+        PolicyCompiler::compile(newConfig, error);
+    if (!program) return false;
 
-    // Проверка на распространенные пароли
-    string lowerPassword = password;
-    transform(lowerPassword.begin(), lowerPassword.end(), lowerPassword.begin(),
-              ::tolower);
-
-    for (const auto& common : commonPasswords) {
-      if (lowerPassword.find(common) != string::npos) {
-        return {false,
-                "Отказано по причинам безопасности. Пароль содержит "
-                "распространённую последовательность символов."};
-      }
+    config = newConfig;
+    const PolicyProgram* previous = current.exchange(program.release());
+    ++version;
+    if (previous) {
+      waitForReaders();
+      delete previous;
     }
+    return true;
+  }
+
+  template <typename Change>
+  bool update(Change change, string& error) {
+    lock_guard<mutex> lock(publishMutex);
+    PolicyConfig newConfig = config;
+    change(newConfig);
+    return publish(newConfig, error);
+  }
+
+  template <typename Change>
+  void update(Change change) {
+    string error;
+    update(change, error);
+  }
+
+ public:
+  using ValidationResult = PolicyVerdict;
+
+  PasswordPolicy() {
+    string error;
+    publish(PolicyConfig(), error);
+  }
 
-    return {true, "Пароль надежен"};
+  // Проверки к моменту разрушения должны быть завершены
+  ~PasswordPolicy() { delete current.load(); }
+
+  PasswordPolicy(const PasswordPolicy&) = delete;
+  PasswordPolicy& operator=(const PasswordPolicy&) = delete;
+
+  ValidationResult validatePassword(const string& password) const {
+    ReadGuard guard(*this);
+    return current.load()->run(password);
+  }
+
+  // Загрузка файла политики (см. PolicyConfig); при ошибке разбора или
+  // компиляции продолжает действовать прежняя политика
+  bool loadPolicyFile(const string& path, string& error) {
+    TRACE_FUNCTION();
+    PolicyConfig newConfig;
+    if (!PolicyCompiler::parseFile(path, newConfig, error)) return false;
+    lock_guard<mutex> lock(publishMutex);
+    return publish(newConfig, error);
+  }
+
+  // Подключение фильтра, собранного утилитой breach_filter_builder
+  bool loadBreachFilter(const string& path, string& error) {
+    TRACE_FUNCTION();
+    return update([&](PolicyConfig& c) { c.breachFilterPath = path; }, error);
+  }
+
+  // Дополнительные запрещённые фрагменты (по одному в строке); для каждого
+  // добавляются варианты с заменами в стиле leetspeak
+  bool loadBannedFragments(const string& path, string& error) {
+    TRACE_FUNCTION();
+    return update(
+        [&](PolicyConfig& c) {
+          c.bannedFragmentsFile = path;
+          c.expandLeetspeak = true;
+        },
+        error);
+  }
+
+  PolicyConfig getConfig() {
+    lock_guard<mutex> lock(publishMutex);
+    return config;
+  }
+
+  size_t getVersion() {
+    lock_guard<mutex> lock(publishMutex);
+    return version;
   }
 
-  void setMinLength(int length) { minLength = length; }
-  void setRequireUpper(bool require) { requireUpper = require; }
-  void setRequireLower(bool require) { requireLower = require; }
-  void setRequireDigits(bool require) { requireDigits = require; }
-  void setRequireSpecial(bool require) { requireSpecial = require; }
+  void setMinLength(int length) {
+    update([&](PolicyConfig& c) { c.minLength = length; });
+  }
+  void setRequireUpper(bool require) {
+    update([&](PolicyConfig& c) { c.requireUpper = require; });
+  }
+  void setRequireLower(bool require) {
+    update([&](PolicyConfig& c) { c.requireLower = require; });
+  }
+  void setRequireDigits(bool require) {
+    update([&](PolicyConfig& c) { c.requireDigits = require; });
+  }
+  void setRequireSpecial(bool require) {
+    update([&](PolicyConfig& c) { c.requireSpecial = require; });
+  }
+  void setMinStrengthScore(int score) {
+    update([&](PolicyConfig& c) { c.minStrengthScore = score; });
+  }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,330 @@
+#pragma once
+
+#ifndef POLICY_PROGRAM_H
+#define POLICY_PROGRAM_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "breach_filter.h"
+#include "char_classifier.h"
+#include "fragment_matcher.h"
+#include "strength_estimator.h"
+
+using namespace std;
+
+struct PolicyVerdict {
+  bool isValid;
+  string message;
+  int score = -1;  // Оценка стойкости 0..4; -1, если до неё не дошло
+  double guessesLog10 = 0;
+};
+
+// Настройки политики паролей в том виде, в каком они записаны в файле:
+//
+//   # комментарий
+//   min_length = 10
+//   require_upper = true          (также require_lower/digits/special)
+//   breach_filter = ../breached_passwords.bin
+//   banned_fragments_file = ../banned_fragments.txt
+//   banned_fragment = qwerty      (можно повторять)
+//   expand_leetspeak = true       (варианты фрагментов в стиле leetspeak)
+//   use_default_fragments = true  (password, admin, 111, 123)
+//   strength_table = ../strength_table.bin
+//   min_strength_score = 2        (0..4, 0 — только оценка без отказа)
+struct PolicyConfig {
+  size_t minLength = 8;
+  bool requireUpper = true;
+  bool requireLower = true;
+  bool requireDigits = true;
+  bool requireSpecial = true;
+  string breachFilterPath;
+  string bannedFragmentsFile;
+  vector<string> bannedFragments;
+  bool expandLeetspeak = true;
+  bool useDefaultFragments = true;
+  string strengthTablePath;
+  int minStrengthScore = 2;
+};
+
+// Скомпилированная политика: неизменяемая последовательность правил.
+// После публикации не меняется, поэтому читается без синхронизации.
+class PolicyProgram {
+ public:
+  enum class Opcode : uint8_t {
+    MIN_LENGTH,
+    REQUIRE_CLASS,
+    BREACH_FILTER,
+    BANNED_FRAGMENTS,
+    MIN_STRENGTH
+  };
+
+  struct Rule {
+    Opcode opcode;
+    uint32_t argument;  // Длина, маска класса или минимальная оценка
+    string message;
+  };
+
+  PolicyVerdict run(const string& password) const {
+    PolicyVerdict verdict = {true, "Пароль надежен"};
+    uint8_t classes = 0;
+    bool classified = false;
+
+    for (const Rule& rule : rules) {
+      bool passed = true;
+      switch (rule.opcode) {
+        case Opcode::MIN_LENGTH:
+          passed = password.length() >= rule.argument;
+          break;
+        case Opcode::REQUIRE_CLASS:
+          // Один проход классификации на все правила классов
+          if (!classified) {
+            classes = CharClassifier::classify(password);
+            classified = true;
+          }
+          passed = (classes & rule.argument) != 0;
+          break;
+        case Opcode::BREACH_FILTER:
+          passed = !breachFilter->contains(password);
+          break;
+        case Opcode::BANNED_FRAGMENTS:
+          passed = !fragments.matches(password);
+          break;
+        case Opcode::MIN_STRENGTH: {
+          StrengthEstimator::Estimate estimate = strength->estimate(password);
+          verdict.score = estimate.score;
+          verdict.guessesLog10 = estimate.guessesLog10;
+          passed = estimate.score >= static_cast<int>(rule.argument);
+          break;
+        }
+      }
+      if (!passed) {
+        verdict.isValid = false;
+        verdict.message = rule.message;
+        return verdict;
+      }
+    }
+    return verdict;
+  }
+
+  const PolicyConfig& getConfig() const { return config; }
+  const vector<Rule>& getRules() const { return rules; }
+
+ private:
+  friend class PolicyCompiler;
+
+  PolicyConfig config;
+  vector<Rule> rules;
+  shared_ptr<const BreachFilter> breachFilter;
+  FragmentMatcher fragments;
+  shared_ptr<const StrengthEstimator> strength;
+};
+
+// Разбор файла политики и компиляция настроек в PolicyProgram
+class PolicyCompiler {
+ public:
+  static vector<string> defaultFragments() {
+    return {"password", "admin", "111", "123"};
+  }
+
+  static bool parseFile(const string& path, PolicyConfig& config,
+                        string& error) {
+    ifstream file(path);
+    if (!file.is_open()) {
+      error = "не удалось открыть файл политики: " + path;
+      return false;
+    }
+    stringstream buffer;
+    buffer << file.rdbuf();
+    return parse(buffer.str(), config, error);
+  }
+
+  // Файл разбирается целиком; при любой ошибке config не меняется
+  static bool parse(const string& text, PolicyConfig& config, string& error) {
+    PolicyConfig parsed;
+    stringstream ss(text);
+    string line;
+    int lineNumber = 0;
+
+    while (getline(ss, line)) {
+      lineNumber++;
+      string content = trim(line);
+      if (content.empty() || content[0] == '#') continue;
+
+      size_t equals = content.find('=');
+      if (equals == string::npos) {
+        error = "строка " + to_string(lineNumber) + ": ожидалось 'ключ = значение'";
+        return false;
+      }
+      string key = trim(content.substr(0, equals));
+      string value = trim(content.substr(equals + 1));
+
+      bool ok = true;
+      if (key == "min_length") {
+        ok = parseSize(value, parsed.minLength);
+      } else if (key == "require_upper") {
+        ok = parseBool(value, parsed.requireUpper);
+      } else if (key == "require_lower") {
+        ok = parseBool(value, parsed.requireLower);
+      } else if (key == "require_digits") {
+        ok = parseBool(value, parsed.requireDigits);
+      } else if (key == "require_special") {
+        ok = parseBool(value, parsed.requireSpecial);
+      } else if (key == "breach_filter") {
+        parsed.breachFilterPath = value;
+      } else if (key == "banned_fragments_file") {
+        parsed.bannedFragmentsFile = value;
+      } else if (key == "banned_fragment") {
+        ok = !value.empty();
+        parsed.bannedFragments.push_back(value);
+      } else if (key == "expand_leetspeak") {
+        ok = parseBool(value, parsed.expandLeetspeak);
+      } else if (key == "use_default_fragments") {
+        ok = parseBool(value, parsed.useDefaultFragments);
+      } else if (key == "strength_table") {
+        parsed.strengthTablePath = value;
+      } else if (key == "min_strength_score") {
+        size_t score = 0;
+        ok = parseSize(value, score) && score <= 4;
+        parsed.minStrengthScore = static_cast<int>(score);
+      } else {
+        error = "строка " + to_string(lineNumber) + ": неизвестный ключ '" +
+                key + "'";
+        return false;
+      }
+
+      if (!ok) {
+        error = "строка " + to_string(lineNumber) +
+                ": некорректное значение для '" + key + "'";
+        return false;
+      }
+    }
+
+    config = parsed;
+    return true;
+  }
+
+  static unique_ptr<const PolicyProgram> compile(const PolicyConfig& config,
+                                                 string& error) {
+    unique_ptr<PolicyProgram> program(new PolicyProgram());
+    program->config = config;
+    vector<PolicyProgram::Rule>& rules = program->rules;
+
+    rules.push_back({PolicyProgram::Opcode::MIN_LENGTH,
+                     static_cast<uint32_t>(config.minLength),
+                     "Пароль должен содержать не менее " +
+                         to_string(config.minLength) + " символов"});
+
+    if (config.requireUpper) {
+      rules.push_back({PolicyProgram::Opcode::REQUIRE_CLASS,
+                       CharClassifier::UPPER,
+                       "Пароль должен содержать заглавные буквы"});
+    }
+    if (config.requireLower) {
+      rules.push_back({PolicyProgram::Opcode::REQUIRE_CLASS,
+                       CharClassifier::LOWER,
+                       "Пароль должен содержать строчные буквы"});
+    }
+    if (config.requireDigits) {
+      rules.push_back({PolicyProgram::Opcode::REQUIRE_CLASS,
+                       CharClassifier::DIGIT, "Пароль должен содержать цифры"});
+    }
+    if (config.requireSpecial) {
+      rules.push_back({PolicyProgram::Opcode::REQUIRE_CLASS,
+                       CharClassifier::SPECIAL,
+                       "Пароль должен содержать специальные символы"});
+    }
+
+    if (!config.breachFilterPath.empty()) {
+      auto filter = make_shared<BreachFilter>();
+      if (!filter->open(config.breachFilterPath, error)) return nullptr;
+      program->breachFilter = filter;
+      rules.push_back({PolicyProgram::Opcode::BREACH_FILTER, 0,
+                       "Отказано по причинам безопасности. Пароль встречается "
+                       "в базах утёкших паролей."});
+    }
+
+    // Встроенные фрагменты компилируются без вариантов leetspeak,
+    // чтобы вердикты по умолчанию не менялись
+    vector<string> fragments;
+    if (config.useDefaultFragments) fragments = defaultFragments();
+    vector<string> extra = config.bannedFragments;
+    if (!config.bannedFragmentsFile.empty() &&
+        !FragmentMatcher::loadFragments(config.bannedFragmentsFile, false,
+                                        extra, error)) {
+      return nullptr;
+    }
+    for (const string& fragment : extra) {
+      if (config.expandLeetspeak) {
+        for (const string& variant : FragmentMatcher::expandLeetspeak(fragment)) {
+          fragments.push_back(variant);
+        }
+      } else {
+        fragments.push_back(fragment);
+      }
+    }
+    if (!fragments.empty()) {
+      if (!program->fragments.compile(fragments, error)) return nullptr;
+      rules.push_back({PolicyProgram::Opcode::BANNED_FRAGMENTS, 0,
+                       "Отказано по причинам безопасности. Пароль содержит "
+                       "распространённую последовательность символов."});
+    }
+
+    // Оценка стойкости идёт последней: она самая дорогая из проверок.
+    // Правило есть всегда, чтобы оценка попадала в результат проверки.
+    if (config.strengthTablePath.empty()) {
+      program->strength = defaultEstimator();
+    } else {
+      auto estimator = make_shared<StrengthEstimator>();
+      if (!estimator->loadTable(config.strengthTablePath, error)) return nullptr;
+      program->strength = estimator;
+    }
+    rules.push_back({PolicyProgram::Opcode::MIN_STRENGTH,
+                     static_cast<uint32_t>(max(config.minStrengthScore, 0)),
+                     "Пароль слишком легко подобрать: оценка стойкости ниже " +
+                         to_string(config.minStrengthScore) + " из 4"});
+
+    return program;
+  }
+
+ private:
+  // Встроенный словарь один на все программы
+  static shared_ptr<const StrengthEstimator> defaultEstimator() {
+    static const shared_ptr<const StrengthEstimator> estimator =
+        make_shared<StrengthEstimator>();
+    return estimator;
+  }
+
+  static string trim(const string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == string::npos) return "";
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+  }
+
+  static bool parseBool(const string& value, bool& result) {
+    if (value == "true" || value == "1" || value == "yes") {
+      result = true;
+    } else if (value == "false" || value == "0" || value == "no") {
+      result = false;
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+  static bool parseSize(const string& value, size_t& result) {
+    if (value.empty() || value.size() > 4 ||
+        value.find_first_not_of("0123456789") != string::npos) {
+      return false;
+    }
+    result = stoul(value);
+    return true;
+  }
+};
+
+#endif
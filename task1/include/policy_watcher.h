@@ -0,0 +1,48 @@
+#pragma once
+
+#ifndef POLICY_WATCHER_H
+#define POLICY_WATCHER_H
+
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "password_policy.h"
+
+using namespace std;
+
+// Следит за файлом политики через inotify и перезагружает PasswordPolicy
+// после каждой записи. Наблюдается каталог, а не сам файл: редакторы и
+// конфигурационные системы обычно заменяют файл переименованием, и
+// наблюдение за inode потерялось бы после первой замены.
+class PolicyWatcher {
+ public:
+  // ok == false: новый файл отклонён, действует прежняя политика
+  using ReloadCallback = function<void(bool ok, const string& message)>;
+
+  PolicyWatcher(PasswordPolicy& policy, const string& path,
+                ReloadCallback callback);
+  ~PolicyWatcher();
+
+  PolicyWatcher(const PolicyWatcher&) = delete;
+  PolicyWatcher& operator=(const PolicyWatcher&) = delete;
+
+  bool isWatching() const { return watchFd >= 0; }
+
+ private:
+  PasswordPolicy& passwordPolicy;
+  string policyPath;
+  string fileName;
+  ReloadCallback onReload;
+
+  int inotifyFd = -1;
+  int watchFd = -1;
+  int stopFd = -1;
+  thread worker;
+
+  void run();
+  bool drainEvents();
+  void reload();
+};
+
+#endif
@@ -0,0 +1,280 @@
+#pragma once
+
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace std;
+
+// Политика ограничения: не более limit событий за periodSeconds секунд
+struct RateLimitPolicy {
+  uint32_t limit;
+  uint32_t periodSeconds;
+};
+
+// Ограничитель частоты по алгоритму GCRA (Generic Cell Rate Algorithm).
+// Состояние ключа упаковано в одно 64-битное слово: 24 бита отпечатка ключа
+// и 40 бит TAT (theoretical arrival time) в миллисекундах. Таблица с открытой
+// адресацией обновляется только через CAS, блокировок нет.
+//
+// Слот с TAT в прошлом не несёт информации и может быть занят другим ключом,
+// поэтому отдельного удаления не требуется. Слоты никогда не обнуляются, и
+// цепочки линейного пробирования не разрываются. При одновременной первой
+// вставке одного ключа из двух потоков возможен дубль; это ослабляет лимит
+// лишь на одно событие.
+//
+// Если вся цепочка из MAX_PROBES слотов занята активными ключами, вытесняется
+// ключ с наименьшим TAT: он ближе всех к истечению и теряет меньше всего
+// состояния. Отказ всем ключам цепочки позволял бы злоумышленнику, заполнив
+// её случайными ключами, блокировать законных пользователей; вытеснение
+// учитывается в getOverflowCount.
+//
+// Ключи различаются только по 24-битному отпечатку, поэтому два ключа одной
+// цепочки с совпавшим отпечатком (вероятность порядка MAX_PROBES / 2^24 на
+// пару) делят общий лимит. Затравка хэша случайна для каждого процесса, так
+// что подобрать такой ключ заранее нельзя; расширение отпечатка сократило бы
+// TAT до нескольких лет работы процесса, что не даёт заметного выигрыша.
+class RateLimiter {
+ private:
+  static const int FINGERPRINT_BITS = 24;
+  static const int TAT_BITS = 40;
+  static const uint64_t TAT_MASK = (uint64_t(1) << TAT_BITS) - 1;
+  static const size_t MAX_PROBES = 16;
+
+  struct alignas(8) Slot {
+    atomic<uint64_t> word{0};
+  };
+
+  RateLimitPolicy policy;
+  uint64_t emissionInterval;  // Интервал между событиями, мс
+  uint64_t burstTolerance;    // Допустимое опережение TAT, мс
+  size_t mask;
+  uint64_t seed;
+  unique_ptr<Slot[]> slots;
+  chrono::steady_clock::time_point epoch;
+  atomic<uint64_t> overflows{0};
+
+  static uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  static uint64_t pack(uint64_t fingerprint, uint64_t tat) {
+    return (fingerprint << TAT_BITS) | (tat & TAT_MASK);
+  }
+
+  static uint64_t fingerprintOf(uint64_t word) { return word >> TAT_BITS; }
+  static uint64_t tatOf(uint64_t word) { return word & TAT_MASK; }
+
+  // Время в мс от создания ограничителя; 0 зарезервирован под «пустой» TAT
+  uint64_t nowMs() const {
+    return chrono::duration_cast<chrono::milliseconds>(
+               chrono::steady_clock::now() - epoch)
+               .count() +
+           1;
+  }
+
+  // Поиск слота ключа; при отсутствии — слот для вставки: пустой, истёкший
+  // или, если цепочка заполнена, слот с наименьшим TAT (вытеснение)
+  Slot* findSlot(uint64_t hash, uint64_t fingerprint, uint64_t now,
+                 uint64_t& observed, bool& found) const {
+    Slot* reusable = nullptr;
+    uint64_t reusableWord = 0;
+    Slot* oldest = nullptr;
+    uint64_t oldestWord = 0;
+    found = false;
+
+    for (size_t i = 0; i < MAX_PROBES; ++i) {
+      Slot* slot = &slots[(hash + i) & mask];
+      uint64_t word = slot->word.load(memory_order_acquire);
+
+      if (word == 0) {
+        // Ключа дальше по цепочке быть не может
+        if (!reusable) {
+          reusable = slot;
+          reusableWord = 0;
+        }
+        break;
+      }
+      if (fingerprintOf(word) == fingerprint) {
+        found = true;
+        observed = word;
+        return slot;
+      }
+      if (!reusable && tatOf(word) <= now) {
+        reusable = slot;
+        reusableWord = word;
+      }
+      if (!oldest || tatOf(word) < tatOf(oldestWord)) {
+        oldest = slot;
+        oldestWord = word;
+      }
+    }
+
+    if (!reusable) {
+      observed = oldestWord;
+      return oldest;
+    }
+    observed = reusableWord;
+    return reusable;
+  }
+
+  void keyHash(const string& key, uint64_t& hash, uint64_t& fingerprint) const {
+    hash = mix(std::hash<string>{}(key) ^ seed);
+    fingerprint = (hash >> (64 - FINGERPRINT_BITS)) | 1;  // Не ноль
+  }
+
+ public:
+  // capacity округляется вверх до степени двойки
+  RateLimiter(RateLimitPolicy limitPolicy, size_t capacity = 65536)
+      : policy(limitPolicy), epoch(chrono::steady_clock::now()) {
+    uint64_t periodMs = uint64_t(policy.periodSeconds) * 1000;
+    uint32_t limit = policy.limit > 0 ? policy.limit : 1;
+    emissionInterval = periodMs / limit > 0 ? periodMs / limit : 1;
+    burstTolerance = emissionInterval * (limit - 1);
+
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+    mask = size - 1;
+    slots.reset(new Slot[size]);
+
+    random_device rd;
+    seed = (uint64_t(rd()) << 32) | rd();
+  }
+
+  // Регистрирует событие, если лимит не исчерпан; иначе возвращает false
+  bool tryAcquire(const string& key) {
+    uint64_t hash, fingerprint;
+    keyHash(key, hash, fingerprint);
+
+    while (true) {
+      uint64_t now = nowMs();
+      uint64_t observed;
+      bool found;
+      Slot* slot = findSlot(hash, fingerprint, now, observed, found);
+      // Вставка поверх ещё активного ключа — вытеснение
+      bool evicting = !found && tatOf(observed) > now;
+
+      uint64_t tat = found ? tatOf(observed) : 0;
+      if (tat < now) tat = now;
+      if (tat - now > burstTolerance) return false;
+
+      uint64_t desired = pack(fingerprint, tat + emissionInterval);
+      if (slot->word.compare_exchange_weak(observed, desired,
+                                           memory_order_acq_rel)) {
+        if (evicting) overflows.fetch_add(1, memory_order_relaxed);
+        return true;
+      }
+      // Слот изменился конкурентно: повторяем поиск
+    }
+  }
+
+  // Проверка без регистрации события
+  bool wouldAllow(const string& key) const {
+    return retryAfterMs(key) == 0;
+  }
+
+  // Через сколько миллисекунд событие будет разрешено (0 — уже можно)
+  uint64_t retryAfterMs(const string& key) const {
+    uint64_t hash, fingerprint;
+    keyHash(key, hash, fingerprint);
+
+    uint64_t now = nowMs();
+    uint64_t observed;
+    bool found;
+    findSlot(hash, fingerprint, now, observed, found);
+    // Неизвестный ключ получит свободный или вытесненный слот
+    if (!found) return 0;
+
+    uint64_t tat = tatOf(observed);
+    if (tat <= now + burstTolerance) return 0;
+    return tat - burstTolerance - now;
+  }
+
+  // Сброс состояния ключа (например, после успешного входа)
+  void reset(const string& key) {
+    uint64_t hash, fingerprint;
+    keyHash(key, hash, fingerprint);
+
+    uint64_t observed;
+    bool found;
+    Slot* slot = findSlot(hash, fingerprint, nowMs(), observed, found);
+    if (found) {
+      // Слот остаётся занятым, чтобы не разорвать цепочку пробирования
+      slot->word.compare_exchange_strong(observed, pack(fingerprint, 0),
+                                         memory_order_acq_rel);
+    }
+  }
+
+  const RateLimitPolicy& getPolicy() const { return policy; }
+  uint64_t getOverflowCount() const {
+    return overflows.load(memory_order_relaxed);
+  }
+};
+
+// Ограничение попыток входа сразу по трём измерениям: аккаунт, IP и подсеть
+class AttemptThrottle {
+ private:
+  RateLimiter accountLimiter;
+  RateLimiter ipLimiter;
+  RateLimiter subnetLimiter;
+
+ public:
+  struct Policies {
+    RateLimitPolicy account = {5, 60};
+    RateLimitPolicy ip = {20, 60};
+    RateLimitPolicy subnet = {50, 60};
+  };
+
+  AttemptThrottle() : AttemptThrottle(Policies()) {}
+  explicit AttemptThrottle(const Policies& policies)
+      : accountLimiter(policies.account),
+        ipLimiter(policies.ip),
+        subnetLimiter(policies.subnet) {}
+
+  // Подсеть /24 для IPv4 и /64 для IPv6
+  static string subnetOf(const string& ip) {
+    if (ip.find(':') != string::npos) {
+      int colons = 0;
+      for (size_t i = 0; i < ip.size(); ++i) {
+        if (ip[i] == ':' && ++colons == 4) return ip.substr(0, i) + "::/64";
+      }
+      return ip;
+    }
+    size_t lastDot = ip.rfind('.');
+    return lastDot == string::npos ? ip : ip.substr(0, lastDot) + ".0/24";
+  }
+
+  bool isThrottled(const string& login, const string& ip) const {
+    return !accountLimiter.wouldAllow(login) || !ipLimiter.wouldAllow(ip) ||
+           !subnetLimiter.wouldAllow(subnetOf(ip));
+  }
+
+  // Учитывает неудачную попытку; false — один из лимитов исчерпан
+  bool registerFailure(const string& login, const string& ip) {
+    bool allowed = accountLimiter.tryAcquire(login);
+    allowed = ipLimiter.tryAcquire(ip) && allowed;
+    allowed = subnetLimiter.tryAcquire(subnetOf(ip)) && allowed;
+    return allowed;
+  }
+
+  void resetAccount(const string& login) { accountLimiter.reset(login); }
+
+  uint64_t retryAfterMs(const string& login, const string& ip) const {
+    uint64_t wait = accountLimiter.retryAfterMs(login);
+    wait = max(wait, ipLimiter.retryAfterMs(ip));
+    return max(wait, subnetLimiter.retryAfterMs(subnetOf(ip)));
+  }
+};
+
+#endif
@@ -0,0 +1,169 @@
+#pragma once
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+struct ResultCacheConfig {
+  size_t memoryBudget = 32 << 20;  // Байт на все сегменты вместе
+  size_t shardCount = 8;           // Округляется вверх до степени двойки
+  bool isolateUsers = false;       // Свой набор записей у каждого пользователя
+};
+
+struct ResultCacheStats {
+  size_t hits = 0;
+  size_t misses = 0;
+  size_t evictions = 0;
+  size_t entries = 0;
+  size_t bytes = 0;  // Оценка занятой памяти вместе со служебными узлами
+};
+
+// Память вне самого узла: строки длиннее встроенного буфера
+inline size_t resultCacheExtraBytes(const string& value) {
+  return value.capacity() > 15 ? value.capacity() + 1 : 0;
+}
+
+template <typename T>
+size_t resultCacheExtraBytes(const T&) {
+  return 0;
+}
+
+// Ограниченный по памяти LRU-кэш, разбитый на сегменты со своими мьютексами:
+// сегмент выбирается по хешу ключа, поэтому потоки с разными ключами почти
+// не конкурируют. Бюджет делится между сегментами поровну; запись, которая
+// не помещается в бюджет сегмента, не сохраняется. Сбой выделения памяти
+// считается промахом — вызывающий код просто вычисляет результат заново.
+template <typename Key, typename Value, typename Hash = hash<Key>>
+class ResultCache {
+ public:
+  explicit ResultCache(const ResultCacheConfig& config = {})
+      : shardCount(bit_ceil(max<size_t>(config.shardCount, 1))),
+        shardBudget(config.memoryBudget / shardCount),
+        shards(make_unique<Shard[]>(shardCount)) {}
+
+  bool lookup(const Key& key, Value& value) noexcept {
+    Shard& shard = shardFor(key);
+    lock_guard<mutex> lock(shard.lock);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+      ++shard.misses;
+      return false;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+    ++shard.hits;
+    try {
+      value = found->second->value;
+    } catch (const bad_alloc&) {
+      return false;
+    }
+    return true;
+  }
+
+  void store(const Key& key, const Value& value) noexcept {
+    Shard& shard = shardFor(key);
+    // Ключ хранится дважды: в списке и в индексе
+    size_t charge = ENTRY_OVERHEAD + 2 * resultCacheExtraBytes(key) +
+                    resultCacheExtraBytes(value);
+    if (charge > shardBudget) return;
+
+    lock_guard<mutex> lock(shard.lock);
+    try {
+      auto found = shard.index.find(key);
+      if (found != shard.index.end()) {
+        shard.bytes -= found->second->charge;
+        found->second->value = value;
+        found->second->charge = charge;
+        shard.bytes += charge;
+        shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+      } else {
+        shard.lru.push_front({key, value, charge});
+        try {
+          shard.index.emplace(key, shard.lru.begin());
+        } catch (const bad_alloc&) {
+          shard.lru.pop_front();
+          return;
+        }
+        shard.bytes += charge;
+      }
+    } catch (const bad_alloc&) {
+      return;
+    }
+
+    while (shard.bytes > shardBudget) {
+      Entry& oldest = shard.lru.back();
+      shard.bytes -= oldest.charge;
+      shard.index.erase(oldest.key);
+      shard.lru.pop_back();
+      ++shard.evictions;
+    }
+  }
+
+  void clear() {
+    for (size_t i = 0; i < shardCount; ++i) {
+      lock_guard<mutex> lock(shards[i].lock);
+      shards[i].index.clear();
+      shards[i].lru.clear();
+      shards[i].bytes = 0;
+    }
+  }
+
+  ResultCacheStats getStats() const {
+    ResultCacheStats stats;
+    for (size_t i = 0; i < shardCount; ++i) {
+      lock_guard<mutex> lock(shards[i].lock);
+      stats.hits += shards[i].hits;
+      stats.misses += shards[i].misses;
+      stats.evictions += shards[i].evictions;
+      stats.entries += shards[i].index.size();
+      stats.bytes += shards[i].bytes;
+    }
+    return stats;
+  }
+
+  size_t getMemoryBudget() const { return shardBudget * shardCount; }
+
+ private:
+  struct Entry {
+    Key key;
+    Value value;
+    size_t charge;
+  };
+
+  // Узел списка, узел хеш-таблицы с копией ключа и ячейка корзины
+  static constexpr size_t ENTRY_OVERHEAD =
+      sizeof(Entry) + 2 * sizeof(void*) + sizeof(Key) + 3 * sizeof(void*);
+
+  struct Shard {
+    mutable mutex lock;
+    list<Entry> lru;
+    unordered_map<Key, typename list<Entry>::iterator, Hash> index;
+    size_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+  };
+
+  Shard& shardFor(const Key& key) {
+    // Старшие биты перемешанного хеша: младшие уже использует unordered_map
+    uint64_t mixed = uint64_t(Hash{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return shards[(mixed >> 40) & (shardCount - 1)];
+  }
+
+  size_t shardCount;
+  size_t shardBudget;
+  unique_ptr<Shard[]> shards;
+};
+
+#endif
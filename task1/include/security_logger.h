@@ -7,14 +7,19 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <string>
 
+#include "metrics.h"
+#include "trace.h"
+
 using namespace std;
 
 class SecurityLogger {
  private:
   string logFilename;
   ofstream logFile;
+  mutex logMutex;  // События пишут и фоновые потоки (перезагрузка политики)
 
   string getCurrentTimestamp() {
     time_t now = time(nullptr);
@@ -25,9 +30,23 @@ class SecurityLogger {
 
   void setFilePermissions() { chmod(logFilename.c_str(), S_IRUSR | S_IWUSR); }
 
+  static Counter& eventCounter(const string& type) {
+    return metrics().counter("secure_calc_security_events_total",
+                             "События журнала безопасности по типу",
+                             "type=\"" + type + "\"");
+  }
+
+  // Время записи события вместе с ожиданием мьютекса и flush
+  static LatencyHistogram& writeLatency() {
+    static LatencyHistogram& latency = metrics().histogram(
+        "secure_calc_log_write_seconds", "Время записи события в журнал");
+    return latency;
+  }
+
  public:
   SecurityLogger(const string& filename = "../security.log")
       : logFilename(filename) {
+    TRACE_SPAN("SecurityLogger: open");
     logFile.open(logFilename, ios::app);
     setFilePermissions();
   }
@@ -39,6 +58,11 @@ class SecurityLogger {
   }
 
   void logLoginSuccess(const string& username, const string& ip) {
+    static Counter& events = eventCounter("login_success");
+    events.add();
+    ScopedLatency timer(writeLatency());
+    TRACE_FUNCTION();
+    lock_guard<mutex> lock(logMutex);
     logFile << getCurrentTimestamp() << " [SUCCESS] Login: user='" << username
             << "' ip=" << ip << endl;
     logFile.flush();
@@ -46,12 +70,22 @@ class SecurityLogger {
 
   void logLoginFailure(const string& username, const string& ip,
                        const string& reason) {
+    static Counter& events = eventCounter("login_failure");
+    events.add();
+    ScopedLatency timer(writeLatency());
+    TRACE_FUNCTION();
+    lock_guard<mutex> lock(logMutex);
     logFile << getCurrentTimestamp() << " [FAILURE] Login: user='" << username
             << "' ip=" << ip << " reason='" << reason << "'" << endl;
     logFile.flush();
   }
 
   void logPasswordChange(const string& username, bool success) {
+    static Counter& events = eventCounter("password_change");
+    events.add();
+    ScopedLatency timer(writeLatency());
+    TRACE_FUNCTION();
+    lock_guard<mutex> lock(logMutex);
     logFile << getCurrentTimestamp() << " [PASSWORD] Change: user='" << username
             << "' success=" << (success ? "true" : "false") << endl;
     logFile.flush();
@@ -59,12 +93,22 @@ class SecurityLogger {
 
   void logAdminAction(const string& adminUser, const string& action,
                       const string& target) {
+    static Counter& events = eventCounter("admin_action");
+    events.add();
+    ScopedLatency timer(writeLatency());
+    TRACE_FUNCTION();
+    lock_guard<mutex> lock(logMutex);
     logFile << getCurrentTimestamp() << " [ADMIN] Action: admin='" << adminUser
             << "' action='" << action << "' target='" << target << "'" << endl;
     logFile.flush();
   }
 
   void logSecurityEvent(const string& event, const string& details) {
+    static Counter& events = eventCounter("security_event");
+    events.add();
+    ScopedLatency timer(writeLatency());
+    TRACE_FUNCTION();
+    lock_guard<mutex> lock(logMutex);
     logFile << getCurrentTimestamp() << " [SECURITY] " << event << ": "
             << details << endl;
     logFile.flush();
@@ -0,0 +1,68 @@
+#pragma once
+
+#ifndef SESSION_MANAGER_H
+#define SESSION_MANAGER_H
+
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "auth_manager.h"
+#include "database.h"
+
+using namespace std;
+
+// Выдача подписанных HMAC-SHA256 токенов сессий и LRU-кэш проверенных сессий.
+// Формат токена: v1.<login>.<ip>.<роль>.<поколение>.<срок>.<nonce>.<подпись>
+// (login и ip закодированы в hex). Смена роли, статуса или пароля меняет
+// поколение пользователя и отзывает все его токены; выход отзывает только
+// токен своей сессии по nonce (UserDatabase::revokeToken). Оба признака
+// хранятся в базе, поэтому видны и другим процессам, проверяющим токены из
+// --token.
+class SessionManager {
+ private:
+  struct CachedSession {
+    string token;
+    UserSession session;
+    string nonce;
+    uint32_t generation;
+    time_t expiresAt;
+  };
+
+  UserDatabase& userDB;
+  string keyFilename;
+  string signingKey;
+  size_t capacity;
+  int tokenLifetime;
+
+  // Начало списка — самые свежие сессии, конец — кандидаты на вытеснение
+  list<CachedSession> lruList;
+  unordered_map<string, list<CachedSession>::iterator> sessionIndex;
+
+  void loadOrCreateKey();
+  bool parseToken(const string& token, CachedSession& parsed) const;
+  bool isSessionCurrent(const CachedSession& cached) const;
+  void cacheSession(CachedSession&& cached);
+
+ public:
+  static const size_t DEFAULT_CAPACITY = 1024;
+  static const int DEFAULT_LIFETIME = 3600;  // Время жизни токена, секунд
+
+  SessionManager(UserDatabase& db, const string& keyFile = "../session.key",
+                 size_t cacheCapacity = DEFAULT_CAPACITY,
+                 int lifetime = DEFAULT_LIFETIME);
+
+  string issueToken(const UserSession& session);
+
+  // Проверка токена: подпись, срок, активность и поколение пользователя
+  bool validateToken(const string& token, UserSession& session);
+
+  // Отзыв одного токена (выход из сессии); false, если токен не наш
+  bool revokeToken(const string& token);
+
+  size_t cachedCount() const { return sessionIndex.size(); }
+};
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Запись ввода интерактивного сеанса и его воспроизведение. Все меню читают
+// cin, поэтому достаточно подменить буфер потока: запись читает stdin и
+// сохраняет каждую прочитанную порцию с отметкой времени, воспроизведение
+// отдаёт сохранённые порции вместо stdin.
+//
+// Формат файла: строка SESSION_RECORD_MAGIC, затем порции
+//   <мкс от начала сеанса> <длина>\n<байты>\n
+//
+// В записи остаются введённые пароли: файл создаётся с правами 0600, а
+// воспроизводить его следует на копии базы (см. tools/session_replay).
+// Пакетный режим читает операции из stdin в обход cin, поэтому запись и
+// воспроизведение с ним допускаются только при пакетном файле.
+inline const string SESSION_RECORD_MAGIC = "SECURE_CALC_SESSION 1";
+
+class SessionRecorder : public streambuf {
+ public:
+  SessionRecorder() = default;
+  ~SessionRecorder() override;
+
+  SessionRecorder(const SessionRecorder&) = delete;
+  SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+  bool open(const string& path, string& error);
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  int fd = -1;
+  char buffer[4096];
+  chrono::steady_clock::time_point start;
+
+  bool writeAll(const string& data);
+};
+
+class SessionReplayer : public streambuf {
+ public:
+  // Запись кончилась раньше, чем сеанс завершился сам
+  static constexpr int EXHAUSTED_EXIT_CODE = 3;
+
+  // paced — выдерживать паузы исходного сеанса, иначе полная скорость
+  bool open(const string& path, bool paced, string& error);
+
+ protected:
+  // Меню повторяют запрос при ошибке ввода и на конце потока зациклились
+  // бы, поэтому исчерпание записи завершает процесс с EXHAUSTED_EXIT_CODE
+  int_type underflow() override;
+
+ private:
+  struct Chunk {
+    uint64_t offsetUs;
+    size_t begin;
+    size_t length;
+  };
+
+  // "<мкс> <длина>" без знаков и лишних символов
+  static bool parseChunkHeader(const char* begin, const char* end,
+                               Chunk& chunk);
+
+  string data;
+  vector<Chunk> chunks;
+  size_t next = 0;
+  bool paced = false;
+  chrono::steady_clock::time_point start;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#pragma once
+
+#ifndef SHARED_ATTEMPT_TABLE_H
+#define SHARED_ATTEMPT_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+
+using namespace std;
+
+// Счётчики попыток и блокировки, общие для всех процессов SecureCalculator
+// на машине. Таблица с открытой адресацией лежит в разделяемой памяти
+// (shm_open); без неё каждый процесс считал бы попытки сам, и параллельные
+// сессии умножали бы число догадок.
+//
+// Поиск и обновление счётчиков не берут блокировок: поля слота атомарны и
+// меняются fetch_add/CAS. Под межпроцессным мьютексом выполняется только
+// занятие слота новым ключом, чтобы два процесса не вставили один ключ
+// дважды. Мьютекс робастный: если его владелец упал, следующий процесс
+// получает EOWNERDEAD и продолжает работу. Занятие слота не оставляет
+// промежуточных состояний, поэтому восстанавливать, кроме самого мьютекса,
+// нечего.
+//
+// Как и в RateLimiter, слоты никогда не освобождаются: ключ занимает чужой
+// слот только заменой, и цепочки линейного пробирования не разрываются.
+// Давно неактивный слот переиспользуется; если в окне пробирования таких
+// нет, вытесняется самый давний незаблокированный (а в крайнем случае и
+// заблокированный — потолок памяти важнее).
+class SharedAttemptTable {
+ public:
+  enum class Kind : uint8_t { ACCOUNT = 1, IP = 2 };
+
+  static constexpr size_t DEFAULT_CAPACITY = 65536;
+  static constexpr size_t MAX_PROBES = 32;
+  static constexpr uint32_t STALE_SECONDS = 86400;  // Как у блокировок IP
+
+  struct Entry {
+    uint32_t attempts;
+    uint32_t unlockTime;   // Секунды Unix
+    uint32_t lastAttempt;  // Секунды Unix
+  };
+
+  struct Stats {
+    size_t capacity;
+    size_t occupied;
+    uint64_t evictions;
+    uint64_t lockedEvictions;  // Вытеснено записей с активной блокировкой
+    uint64_t recoveries;       // Мьютекс восстановлен после падения владельца
+  };
+
+  SharedAttemptTable() = default;
+  ~SharedAttemptTable();
+
+  SharedAttemptTable(const SharedAttemptTable&) = delete;
+  SharedAttemptTable& operator=(const SharedAttemptTable&) = delete;
+
+  // Имя сегмента для базы databasePath: euid и отпечаток канонического
+  // пути. Процессы с одной базой делят счётчики, а выбрать себе чистую
+  // таблицу для рабочей базы нельзя
+  static string nameFor(const string& databasePath);
+
+  // Подключается к сегменту или создаёт его. capacity (округляется до
+  // степени двойки) учитывается только при создании. Существующий сегмент
+  // принимается, только если он принадлежит эффективному uid процесса и
+  // закрыт для остальных (права без битов группы и прочих).
+  bool open(const string& name, size_t capacity, string& error);
+  bool isOpen() const { return header != nullptr; }
+
+  // Ключ заблокирован: threshold попыток и срок блокировки не истёк.
+  // Истёкшая блокировка сбрасывает счётчик.
+  bool isLocked(Kind kind, const string& key, uint32_t threshold, time_t now,
+                int& remaining);
+  // Учитывает неудачу и возвращает новое число попыток; начиная с
+  // threshold каждая неудача продлевает блокировку на lockSeconds. Если
+  // слот не удалось занять, возвращает threshold: неучтённая неудача
+  // считается блокирующей
+  uint32_t registerFailure(Kind kind, const string& key, uint32_t threshold,
+                           uint32_t lockSeconds, time_t now);
+  void reset(Kind kind, const string& key);
+  bool lookup(Kind kind, const string& key, Entry& entry) const;
+
+  Stats getStats() const;
+
+ private:
+  struct alignas(32) Slot {
+    atomic<uint64_t> keyHash;  // 0 — свободный слот
+    atomic<uint32_t> attempts;
+    atomic<uint32_t> unlockTime;
+    atomic<uint32_t> lastAttempt;
+  };
+  struct Header;
+
+  Header* header = nullptr;
+  Slot* slots = nullptr;
+  size_t mask = 0;
+  void* mapping = nullptr;
+  size_t mappingSize = 0;
+
+  uint64_t hashKey(Kind kind, const string& key) const;
+  Slot* find(uint64_t keyHash) const;
+  Slot* findOrClaim(uint64_t keyHash, time_t now);
+  Slot* chooseSlot(uint64_t keyHash, time_t now);
+  bool lockClaims();
+  // uninitialized: создатель сегмента не закончил инициализацию
+  bool attach(int fd, bool created, size_t capacity, bool& uninitialized,
+              string& error);
+};
+
+#endif
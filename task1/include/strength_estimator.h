@@ -0,0 +1,798 @@
+#pragma once
+
+#ifndef STRENGTH_ESTIMATOR_H
+#define STRENGTH_ESTIMATOR_H
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Оценка стойкости пароля в духе zxcvbn (Wheeler, 2016).
+//
+// Пароль раскладывается на шаблоны: словарные слова (в том числе с заменами
+// leetspeak и заглавными буквами), клавиатурные дорожки, повторы,
+// последовательности и годы/даты. Для каждого шаблона оценивается число
+// попыток, за которое его угадает атакующий, а динамическое программирование
+// находит разбиение пароля с минимальным произведением попыток. Итог —
+// десятичный логарифм попыток и оценка 0..4 по порогам zxcvbn.
+//
+// Частотные словари хранятся хэш-таблицей рангов, которую собирает утилита
+// strength_table_builder; файл отображается в память. Без файла используется
+// встроенный короткий список самых частых паролей.
+//
+// Формат файла: StrengthTableHeader, затем slotCount записей StrengthTableSlot
+// (открытая адресация, линейное зондирование, hash == 0 — пустая ячейка).
+
+struct StrengthTableHeader {
+  char magic[8];
+  uint64_t slotCount;  // Степень двойки
+  uint64_t entries;
+  uint32_t maxWordLength;
+  uint32_t dictionaryCount;
+};
+
+struct StrengthTableSlot {
+  uint64_t hash;
+  uint32_t rank;        // 1 — самое частое слово словаря
+  uint32_t dictionary;  // Номер исходного списка
+};
+
+class StrengthTableFormat {
+ public:
+  static constexpr char MAGIC[8] = {'S', 'T', 'R', 'T', 'B', 'L', '0', '1'};
+  static constexpr uint64_t HASH_BASIS = 0xcbf29ce484222325ULL;
+
+  // Хэш строится посимвольно (FNV-1a), чтобы перебирать подстроки пароля
+  // без копирования: extend на каждый символ, finish перед поиском
+  static uint64_t extend(uint64_t hash, unsigned char c) {
+    return (hash ^ c) * 0x100000001b3ULL;
+  }
+
+  static uint64_t finish(uint64_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    return hash ? hash : 1;
+  }
+
+  static unsigned char lower(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+  }
+
+  static uint64_t hashWord(const string& word) {
+    uint64_t hash = HASH_BASIS;
+    for (unsigned char c : word) hash = extend(hash, lower(c));
+    return finish(hash);
+  }
+};
+
+// Ранги слов: либо отображённый в память файл, либо встроенный список
+class StrengthTable {
+ private:
+  void* mapping = nullptr;
+  size_t mappingSize = 0;
+  vector<StrengthTableSlot> ownedSlots;
+  const StrengthTableSlot* slots = nullptr;
+  StrengthTableHeader header = {};
+
+  static vector<string> builtinWords() {
+    // Самые частые пароли и слова из них, по убыванию частоты
+    return {"123456",   "password", "12345678", "qwerty",   "123456789",
+            "12345",    "1234",     "111111",   "1234567",  "dragon",
+            "123123",   "baseball", "abc123",   "football", "monkey",
+            "letmein",  "696969",   "shadow",   "master",   "666666",
+            "qwertyuiop", "123321", "mustang",  "1234567890", "michael",
+            "654321",   "superman", "1qaz2wsx", "7777777",  "121212",
+            "000000",   "qazwsx",   "123qwe",   "killer",   "trustno1",
+            "jordan",   "jennifer", "zxcvbnm",  "asdfgh",   "hunter",
+            "buster",   "soccer",   "harley",   "batman",   "andrew",
+            "tigger",   "sunshine", "iloveyou", "hello123", "2000",
+            "charlie",  "robert",   "thomas",   "hockey",   "ranger",
+            "daniel",   "starwars", "klaster",  "112233",   "george",
+            "internet", "computer", "michelle", "jessica",  "pepper",
+            "1111",     "zxcvbn",   "555555",   "11111111", "131313",
+            "freedom",  "777777",   "pass",     "maggie",   "159753",
+            "aaaaaa",   "ginger",   "princess", "joshua",   "cheese",
+            "amanda",   "summer",   "love",     "ashley",   "6969",
+            "nicole",   "chelsea",  "biteme",   "matthew",  "access",
+            "yankees",  "987654321", "dallas",  "austin",   "thunder",
+            "taylor",   "matrix",   "admin",    "welcome",  "login",
+            "hello",    "secret",   "whatever", "flower",   "lovely",
+            "monday",   "friday",   "winter",   "spring",   "autumn",
+            "orange",   "qwerty123", "passw0rd", "root",    "user",
+            "guest",    "test",     "default",  "changeme", "calculator",
+            "secure",   "admin123", "qwe",      "asd",      "zxc",
+            "parol",    "privet",   "natasha",  "marina",   "sasha",
+            "maksim",   "dima",     "olga",     "irina",    "svetlana",
+            "kotik",    "solnce",   "lubov",    "zvezda",   "nikita"};
+  }
+
+ public:
+  StrengthTable() { loadBuiltin(); }
+  StrengthTable(const StrengthTable&) = delete;
+  StrengthTable& operator=(const StrengthTable&) = delete;
+  ~StrengthTable() { unmap(); }
+
+  // Строит таблицу по ранжированным спискам; при повторе слова остаётся
+  // наименьший ранг. Используется утилитой и встроенным словарём.
+  static void buildSlots(const vector<vector<string>>& rankedLists,
+                         StrengthTableHeader& header,
+                         vector<StrengthTableSlot>& slots) {
+    size_t total = 0;
+    for (const auto& list : rankedLists) total += list.size();
+
+    uint64_t slotCount = 16;
+    while (slotCount < total * 2) slotCount <<= 1;
+    slots.assign(slotCount, StrengthTableSlot{0, 0, 0});
+
+    header = {};
+    memcpy(header.magic, StrengthTableFormat::MAGIC, sizeof(header.magic));
+    header.slotCount = slotCount;
+    header.dictionaryCount = static_cast<uint32_t>(rankedLists.size());
+
+    for (uint32_t d = 0; d < rankedLists.size(); ++d) {
+      uint32_t rank = 0;
+      for (const string& word : rankedLists[d]) {
+        ++rank;
+        if (word.empty()) continue;
+        uint64_t hash = StrengthTableFormat::hashWord(word);
+        uint64_t index = hash & (slotCount - 1);
+        while (slots[index].hash != 0 && slots[index].hash != hash) {
+          index = (index + 1) & (slotCount - 1);
+        }
+        if (slots[index].hash == 0) {
+          slots[index] = {hash, rank, d};
+          header.entries++;
+          header.maxWordLength = max<uint32_t>(header.maxWordLength,
+                                               static_cast<uint32_t>(word.size()));
+        } else if (rank < slots[index].rank) {
+          slots[index].rank = rank;
+          slots[index].dictionary = d;
+        }
+      }
+    }
+  }
+
+  void loadBuiltin() {
+    unmap();
+    buildSlots({builtinWords()}, header, ownedSlots);
+    slots = ownedSlots.data();
+  }
+
+  bool open(const string& path, string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      error = "не удалось открыть таблицу частот: " + path;
+      return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        static_cast<size_t>(info.st_size) < sizeof(StrengthTableHeader)) {
+      ::close(fd);
+      error = "некорректный размер таблицы частот: " + path;
+      return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+      error = "не удалось отобразить таблицу частот в память: " + path;
+      return false;
+    }
+
+    StrengthTableHeader fileHeader;
+    memcpy(&fileHeader, data, sizeof(fileHeader));
+    // slotCount ограничивается размером файла до умножения, чтобы
+    // поддельный заголовок не переполнил ожидаемый размер
+    uint64_t fileSize = static_cast<uint64_t>(info.st_size);
+    bool powerOfTwo = fileHeader.slotCount != 0 &&
+                      (fileHeader.slotCount & (fileHeader.slotCount - 1)) == 0;
+    bool sizeValid =
+        powerOfTwo &&
+        fileHeader.slotCount <= fileSize / sizeof(StrengthTableSlot) &&
+        fileSize == sizeof(fileHeader) +
+                        fileHeader.slotCount * sizeof(StrengthTableSlot);
+    if (memcmp(fileHeader.magic, StrengthTableFormat::MAGIC,
+               sizeof(fileHeader.magic)) != 0 ||
+        !sizeValid) {
+      munmap(data, info.st_size);
+      error = "файл не является таблицей частот: " + path;
+      return false;
+    }
+    // Поиск останавливается на пустом слоте: без него каждая проверка
+    // пароля по повреждённой таблице обходила бы её целиком
+    const StrengthTableSlot* fileSlots =
+        reinterpret_cast<const StrengthTableSlot*>(
+            static_cast<const char*>(data) + sizeof(fileHeader));
+    bool hasEmptySlot = false;
+    for (uint64_t i = 0; i < fileHeader.slotCount && !hasEmptySlot; ++i) {
+      hasEmptySlot = fileSlots[i].hash == 0;
+    }
+    if (!hasEmptySlot) {
+      munmap(data, info.st_size);
+      error = "таблица частот переполнена (нет пустых слотов): " + path;
+      return false;
+    }
+
+    unmap();
+    ownedSlots.clear();
+    ownedSlots.shrink_to_fit();
+    mapping = data;
+    mappingSize = info.st_size;
+    header = fileHeader;
+    slots = reinterpret_cast<const StrengthTableSlot*>(
+        static_cast<const char*>(data) + sizeof(header));
+    return true;
+  }
+
+  bool isMapped() const { return mapping != nullptr; }
+  uint64_t entryCount() const { return header.entries; }
+  uint32_t maxWordLength() const { return header.maxWordLength; }
+
+  // Ранг слова по готовому хэшу или 0, если слова нет в словарях
+  uint32_t lookup(uint64_t hash) const {
+    uint64_t mask = header.slotCount - 1;
+    uint64_t index = hash & mask;
+    for (uint64_t probe = 0; probe < header.slotCount; ++probe) {
+      const StrengthTableSlot& slot = slots[index];
+      if (slot.hash == hash) return slot.rank;
+      if (slot.hash == 0) return 0;
+      index = (index + 1) & mask;
+    }
+    return 0;
+  }
+
+ private:
+  void unmap() {
+    if (mapping) munmap(mapping, mappingSize);
+    mapping = nullptr;
+    mappingSize = 0;
+  }
+};
+
+// Граф соседства клавиш: для каждой пары байтов — направление перехода
+// между соседними клавишами или -1. Таблица 256×256 строится один раз.
+class KeyboardGraph {
+ private:
+  vector<int8_t> directions;  // a * 256 + b
+  array<uint8_t, 256> shiftedKey = {};
+  double startingPositions = 0;
+  double averageDegree = 0;
+
+ public:
+  struct Row {
+    const char* keys;
+    const char* shifted;  // nullptr для цифрового блока
+    int startColumn;
+  };
+
+  // slanted: ряды сдвинуты на полклавиши (основная клавиатура), иначе
+  // прямоугольная сетка (цифровой блок) с восемью направлениями
+  KeyboardGraph(const vector<Row>& rows, bool slanted)
+      : directions(256 * 256, -1) {
+    static const int SLANTED[6][2] = {{0, -1}, {-1, 0}, {-1, 1},
+                                      {0, 1},  {1, 0},  {1, -1}};
+    static const int ALIGNED[8][2] = {{0, -1}, {-1, -1}, {-1, 0}, {-1, 1},
+                                      {0, 1},  {1, 1},   {1, 0},  {1, -1}};
+    const int(*offsets)[2] = slanted ? SLANTED : ALIGNED;
+    int directionCount = slanted ? 6 : 8;
+
+    // Клавиша: (ряд, столбец) -> символы без Shift и с Shift
+    auto keyAt = [&](int row, int column, int shifted) -> int {
+      if (row < 0 || row >= static_cast<int>(rows.size())) return -1;
+      const char* keys = shifted ? rows[row].shifted : rows[row].keys;
+      if (!keys) return -1;
+      int index = column - rows[row].startColumn;
+      if (index < 0 || index >= static_cast<int>(strlen(keys))) return -1;
+      return keys[index] == ' ' ? -1 : static_cast<unsigned char>(keys[index]);
+    };
+
+    size_t keyCount = 0;
+    size_t neighbourCount = 0;
+    for (int row = 0; row < static_cast<int>(rows.size()); ++row) {
+      int length = static_cast<int>(strlen(rows[row].keys));
+      for (int column = rows[row].startColumn;
+           column < rows[row].startColumn + length; ++column) {
+        if (keyAt(row, column, 0) < 0) continue;
+        int variants = rows[row].shifted ? 2 : 1;
+        keyCount += variants;
+
+        for (int d = 0; d < directionCount; ++d) {
+          int nextRow = row + offsets[d][0];
+          int nextColumn = column + offsets[d][1];
+          if (keyAt(nextRow, nextColumn, 0) < 0) continue;
+          neighbourCount += variants;
+
+          for (int from = 0; from < variants; ++from) {
+            for (int to = 0; to < 2; ++to) {
+              int a = keyAt(row, column, from);
+              int b = keyAt(nextRow, nextColumn, to);
+              if (a >= 0 && b >= 0) directions[a * 256 + b] = d;
+            }
+          }
+        }
+        int shifted = keyAt(row, column, 1);
+        if (shifted >= 0) shiftedKey[shifted] = 1;
+      }
+    }
+    startingPositions = static_cast<double>(keyCount);
+    averageDegree = keyCount ? double(neighbourCount) / keyCount : 0;
+  }
+
+  int direction(unsigned char from, unsigned char to) const {
+    return directions[from * 256 + to];
+  }
+  bool isShifted(unsigned char c) const { return shiftedKey[c]; }
+  double getStartingPositions() const { return startingPositions; }
+  double getAverageDegree() const { return averageDegree; }
+
+  static const KeyboardGraph& qwerty() {
+    static const KeyboardGraph graph(
+        {{"`1234567890-=", "~!@#$%^&*()_+", 0},
+         {"qwertyuiop[]\\", "QWERTYUIOP{}|", 1},
+         {"asdfghjkl;'", "ASDFGHJKL:\"", 1},
+         {"zxcvbnm,./", "ZXCVBNM<>?", 1}},
+        true);
+    return graph;
+  }
+
+  static const KeyboardGraph& keypad() {
+    static const KeyboardGraph graph({{"/*-", nullptr, 1},
+                                      {"789+", nullptr, 0},
+                                      {"456", nullptr, 0},
+                                      {"123", nullptr, 0},
+                                      {"0.", nullptr, 0}},
+                                     false);
+    return graph;
+  }
+};
+
+class StrengthEstimator {
+ public:
+  struct Estimate {
+    double guesses;
+    double guessesLog10;
+    int score;  // 0 — угадывается мгновенно, 4 — очень стойкий
+  };
+
+  // Пароль длиннее оценивается по первым MAX_LENGTH байтам
+  static constexpr size_t MAX_LENGTH = 64;
+
+  StrengthEstimator() : referenceYear(currentYear()) {}
+
+  bool loadTable(const string& path, string& error) {
+    return table.open(path, error);
+  }
+
+  const StrengthTable& getTable() const { return table; }
+
+  Estimate estimate(const string& password) const {
+    size_t length = min(password.size(), MAX_LENGTH);
+    if (length == 0) return {1, 0, 0};
+    const unsigned char* text =
+        reinterpret_cast<const unsigned char*>(password.data());
+
+    Scratch scratch;
+    scratch.count = 0;
+    matchDictionary(text, length, scratch);
+    matchSpatial(text, length, KeyboardGraph::qwerty(), scratch);
+    matchSpatial(text, length, KeyboardGraph::keypad(), scratch);
+    matchRepeat(text, length, scratch);
+    matchSequence(text, length, scratch);
+    matchDates(text, length, scratch);
+
+    double guesses = minimumGuesses(length, scratch);
+    return {guesses, log10(guesses), scoreFor(guesses)};
+  }
+
+  // Пороги zxcvbn: 10^3, 10^6, 10^8, 10^10 попыток
+  static int scoreFor(double guesses) {
+    const double DELTA = 5;
+    if (guesses < 1e3 + DELTA) return 0;
+    if (guesses < 1e6 + DELTA) return 1;
+    if (guesses < 1e8 + DELTA) return 2;
+    if (guesses < 1e10 + DELTA) return 3;
+    return 4;
+  }
+
+ private:
+  struct Match {
+    uint8_t begin;
+    uint8_t end;  // Включительно
+    double guesses;
+  };
+
+  // Число шаблонов ограничено, чтобы оценка не выделяла память
+  static constexpr size_t MAX_MATCHES = 512;
+
+  struct Scratch {
+    array<Match, MAX_MATCHES> matches;
+    size_t count;
+  };
+
+  StrengthTable table;
+  int referenceYear;
+
+  static int currentYear() {
+    time_t now = time(nullptr);
+    tm local = {};
+    localtime_r(&now, &local);
+    return local.tm_year + 1900;
+  }
+
+  static void addMatch(Scratch& scratch, size_t begin, size_t end,
+                       double guesses) {
+    if (scratch.count == MAX_MATCHES) return;
+    scratch.matches[scratch.count++] = {static_cast<uint8_t>(begin),
+                                        static_cast<uint8_t>(end), guesses};
+  }
+
+  static double binomial(double n, double k) {
+    if (k > n) return 0;
+    double result = 1;
+    for (double d = 1; d <= k; ++d) result = result * (n - k + d) / d;
+    return result;
+  }
+
+  static double variationsOf(double first, double second) {
+    if (first == 0 || second == 0) return 2;
+    double variations = 0;
+    for (double i = 1; i <= min(first, second); ++i) {
+      variations += binomial(first + second, i);
+    }
+    return variations;
+  }
+
+  // Замены leetspeak сворачиваются в буквы; 0 — символ не заменяется
+  static unsigned char unleet(unsigned char c) {
+    switch (c) {
+      case '4':
+      case '@':
+        return 'a';
+      case '3':
+        return 'e';
+      case '1':
+      case '!':
+        return 'i';
+      case '|':
+        return 'l';
+      case '0':
+        return 'o';
+      case '5':
+      case '$':
+        return 's';
+      case '7':
+        return 't';
+    }
+    return 0;
+  }
+
+  static double uppercaseVariations(const unsigned char* text, size_t begin,
+                                    size_t end) {
+    double upper = 0, lower = 0;
+    for (size_t k = begin; k <= end; ++k) {
+      upper += (text[k] >= 'A' && text[k] <= 'Z');
+      lower += (text[k] >= 'a' && text[k] <= 'z');
+    }
+    if (upper == 0) return 1;
+    bool firstOnly = upper == 1 && text[begin] >= 'A' && text[begin] <= 'Z';
+    bool lastOnly = upper == 1 && text[end] >= 'A' && text[end] <= 'Z';
+    if (lower == 0 || firstOnly || lastOnly) return 2;
+    return variationsOf(upper, lower);
+  }
+
+  static double leetVariations(const unsigned char* text, size_t begin,
+                               size_t end) {
+    double variations = 1;
+    bool seen[256] = {};
+    for (size_t k = begin; k <= end; ++k) {
+      unsigned char letter = unleet(text[k]);
+      if (!letter || seen[letter]) continue;
+      seen[letter] = true;
+      double substituted = 0, plain = 0;
+      for (size_t m = begin; m <= end; ++m) {
+        if (unleet(text[m]) == letter) substituted++;
+        if (StrengthTableFormat::lower(text[m]) == letter) plain++;
+      }
+      variations *= variationsOf(substituted, plain);
+    }
+    return variations;
+  }
+
+  // Словарные слова: хэш подстроки наращивается посимвольно, поэтому все
+  // O(n * maxWordLength) подстрок проверяются без копирования. Второй проход
+  // ищет слова с заменами leetspeak, если они есть в пароле.
+  void matchDictionary(const unsigned char* text, size_t length,
+                       Scratch& scratch) const {
+    size_t maxWord = table.maxWordLength();
+    bool hasLeet = false;
+    for (size_t k = 0; k < length; ++k) hasLeet |= unleet(text[k]) != 0;
+
+    for (size_t begin = 0; begin < length; ++begin) {
+      uint64_t plain = StrengthTableFormat::HASH_BASIS;
+      uint64_t leet = StrengthTableFormat::HASH_BASIS;
+      size_t substitutions = 0;
+      size_t last = min(length, begin + maxWord);
+
+      for (size_t end = begin; end < last; ++end) {
+        unsigned char c = StrengthTableFormat::lower(text[end]);
+        unsigned char letter = unleet(c);
+        plain = StrengthTableFormat::extend(plain, c);
+        leet = StrengthTableFormat::extend(leet, letter ? letter : c);
+        substitutions += letter != 0;
+
+        uint32_t rank = table.lookup(StrengthTableFormat::finish(plain));
+        if (rank) {
+          addMatch(scratch, begin, end,
+                   rank * uppercaseVariations(text, begin, end));
+        }
+        if (hasLeet && substitutions) {
+          rank = table.lookup(StrengthTableFormat::finish(leet));
+          if (rank) {
+            addMatch(scratch, begin, end,
+                     rank * uppercaseVariations(text, begin, end) *
+                         leetVariations(text, begin, end));
+          }
+        }
+      }
+    }
+  }
+
+  // Клавиатурные дорожки длиной от 3 клавиш; каждая смена направления —
+  // поворот, повороты и клавиши с Shift увеличивают число попыток
+  static void matchSpatial(const unsigned char* text, size_t length,
+                           const KeyboardGraph& graph, Scratch& scratch) {
+    size_t begin = 0;
+    while (begin + 1 < length) {
+      size_t end = begin + 1;
+      int lastDirection = -1;
+      int turns = 0;
+      int shifted = graph.isShifted(text[begin]);
+
+      while (end < length) {
+        int direction = graph.direction(text[end - 1], text[end]);
+        if (direction < 0) break;
+        if (direction != lastDirection) turns++;
+        lastDirection = direction;
+        shifted += graph.isShifted(text[end]);
+        end++;
+      }
+
+      if (end - begin > 2) {
+        addMatch(scratch, begin, end - 1,
+                 spatialGuesses(graph, end - begin, turns, shifted));
+      }
+      begin = end;
+    }
+  }
+
+  static double spatialGuesses(const KeyboardGraph& graph, size_t length,
+                               int turns, int shifted) {
+    double starts = graph.getStartingPositions();
+    double degree = graph.getAverageDegree();
+    double guesses = 0;
+    for (size_t i = 2; i <= length; ++i) {
+      int possibleTurns = min<int>(turns, static_cast<int>(i) - 1);
+      for (int j = 1; j <= possibleTurns; ++j) {
+        guesses += binomial(i - 1, j - 1) * starts * pow(degree, j);
+      }
+    }
+    if (shifted > 0) {
+      double unshifted = static_cast<double>(length) - shifted;
+      guesses *= variationsOf(shifted, unshifted);
+    }
+    return guesses;
+  }
+
+  // Повторы фрагмента длиной 1..4 символа: "aaaa", "abab", "123123"
+  static void matchRepeat(const unsigned char* text, size_t length,
+                          Scratch& scratch) {
+    size_t begin = 0;
+    while (begin < length) {
+      size_t bestEnd = begin;
+      size_t bestPeriod = 0;
+      for (size_t period = 1; period <= 4 && begin + 2 * period <= length;
+           ++period) {
+        size_t end = begin + period;
+        while (end < length && text[end] == text[end - period]) end++;
+        size_t repeats = (end - begin) / period;
+        end = begin + repeats * period;
+        if (repeats >= 2 && end - begin >= 3 && end > bestEnd) {
+          bestEnd = end;
+          bestPeriod = period;
+        }
+      }
+
+      if (bestPeriod == 0) {
+        begin++;
+        continue;
+      }
+      double baseGuesses = pow(10.0, double(bestPeriod)) + 1;
+      addMatch(scratch, begin, bestEnd - 1,
+               baseGuesses * double((bestEnd - begin) / bestPeriod));
+      begin = bestEnd;
+    }
+  }
+
+  // Последовательности с постоянным шагом: "abcd", "9753", "acegi"
+  static void matchSequence(const unsigned char* text, size_t length,
+                            Scratch& scratch) {
+    if (length < 2) return;
+    auto emit = [&](size_t begin, size_t end, int delta) {
+      int step = abs(delta);
+      if (step == 0 || step > 5 || (end - begin < 2 && step != 1)) return;
+      unsigned char first = text[begin];
+      double base;
+      if (strchr("aAzZ019", first) && first != 0) {
+        base = 4;
+      } else if (first >= '0' && first <= '9') {
+        base = 10;
+      } else {
+        base = 26;
+      }
+      if (delta < 0) base *= 2;
+      addMatch(scratch, begin, end, base * double(end - begin + 1));
+    };
+
+    size_t begin = 0;
+    int lastDelta = int(text[1]) - int(text[0]);
+    for (size_t k = 2; k < length; ++k) {
+      int delta = int(text[k]) - int(text[k - 1]);
+      if (delta == lastDelta) continue;
+      emit(begin, k - 1, lastDelta);
+      begin = k - 1;
+      lastDelta = delta;
+    }
+    emit(begin, length - 1, lastDelta);
+  }
+
+  // Годы 1900..2099 и даты из 6 или 8 цифр без разделителей
+  void matchDates(const unsigned char* text, size_t length,
+                  Scratch& scratch) const {
+    // Число из count цифр начиная с begin; -1, если там не только цифры
+    auto digitsAt = [&](size_t begin, size_t count) {
+      if (begin + count > length) return -1;
+      int value = 0;
+      for (size_t k = begin; k < begin + count; ++k) {
+        if (text[k] < '0' || text[k] > '9') return -1;
+        value = value * 10 + (text[k] - '0');
+      }
+      return value;
+    };
+    auto yearSpace = [&](int year) {
+      return max(double(abs(year - referenceYear)), 20.0);
+    };
+    auto isYear = [](int year) { return year >= 1900 && year <= 2099; };
+    auto validDay = [](int day, int month) {
+      return day >= 1 && day <= 31 && month >= 1 && month <= 12;
+    };
+
+    for (size_t begin = 0; begin < length; ++begin) {
+      int year = digitsAt(begin, 4);
+      if (isYear(year)) addMatch(scratch, begin, begin + 3, yearSpace(year));
+
+      // ДДММГГГГ, ММДДГГГГ, ГГГГММДД
+      if (digitsAt(begin, 8) >= 0) {
+        int a = digitsAt(begin, 2);
+        int b = digitsAt(begin + 2, 2);
+        int trailing = digitsAt(begin + 4, 4);
+        bool trailingYear =
+            isYear(trailing) && (validDay(a, b) || validDay(b, a));
+        int month = digitsAt(begin + 4, 2);
+        int day = digitsAt(begin + 6, 2);
+        bool leadingYear = isYear(year) && validDay(day, month);
+        if (trailingYear || leadingYear) {
+          addMatch(scratch, begin, begin + 7,
+                   yearSpace(trailingYear ? trailing : year) * 365);
+        }
+      }
+
+      // ДДММГГ, ГГММДД: двузначный год — 100 вариантов
+      if (digitsAt(begin, 6) >= 0) {
+        int day = digitsAt(begin, 2);
+        int month = digitsAt(begin + 2, 2);
+        int last = digitsAt(begin + 4, 2);
+        if (validDay(day, month) || validDay(last, month)) {
+          addMatch(scratch, begin, begin + 5, 100.0 * 365);
+        }
+      }
+    }
+  }
+
+  // Минимальное число попыток по всем разбиениям пароля на шаблоны и
+  // участки перебора (формула zxcvbn: l! * Π попыток + 10000^(l-1), где
+  // l — число частей). best[k][l] — минимум для префикса [0, k] из l частей.
+  double minimumGuesses(size_t length, const Scratch& scratch) const {
+    const double MIN_GUESSES_BEFORE_GROWING_SEQUENCE = 10000;
+    const double INF = HUGE_VAL;
+
+    // product — произведение попыток частей; bruteforce — последняя часть
+    // является перебором (два перебора подряд не рассматриваются)
+    struct Cell {
+      double total;
+      double product;
+      bool bruteforce;
+    };
+    static thread_local array<array<Cell, MAX_LENGTH + 1>, MAX_LENGTH> best;
+    for (size_t k = 0; k < length; ++k) {
+      for (size_t l = 0; l <= length; ++l) best[k][l] = {INF, INF, false};
+    }
+
+    double factorial[MAX_LENGTH + 1];
+    double additive[MAX_LENGTH + 1];
+    factorial[0] = 1;
+    additive[0] = 1;
+    for (size_t l = 1; l <= length; ++l) {
+      factorial[l] = factorial[l - 1] * l;
+      additive[l] = l == 1 ? 1 : additive[l - 1] * MIN_GUESSES_BEFORE_GROWING_SEQUENCE;
+    }
+
+    auto update = [&](size_t begin, size_t end, double guesses, size_t parts,
+                      bool bruteforce) {
+      // Часть короче всего пароля не может быть слишком дешёвой
+      if (end - begin + 1 < length) {
+        guesses = max(guesses, end == begin ? 10.0 : 50.0);
+      }
+      double product = guesses;
+      if (parts > 1) product *= best[begin - 1][parts - 1].product;
+      double total = factorial[parts] * product + additive[parts];
+
+      // Разбиение из меньшего числа частей с не большим итогом лучше
+      for (size_t l = 1; l <= parts; ++l) {
+        if (best[end][l].total <= total) return;
+      }
+      best[end][parts] = {total, product, bruteforce};
+    };
+
+    auto bruteforceGuesses = [](size_t begin, size_t end) {
+      return pow(10.0, double(end - begin + 1));
+    };
+
+    for (size_t end = 0; end < length; ++end) {
+      for (size_t m = 0; m < scratch.count; ++m) {
+        const Match& match = scratch.matches[m];
+        if (match.end != end) continue;
+        if (match.begin == 0) {
+          update(0, end, match.guesses, 1, false);
+          continue;
+        }
+        for (size_t l = 1; l <= match.begin; ++l) {
+          if (best[match.begin - 1][l].total < INF) {
+            update(match.begin, end, match.guesses, l + 1, false);
+          }
+        }
+      }
+
+      update(0, end, bruteforceGuesses(0, end), 1, true);
+      for (size_t begin = 1; begin <= end; ++begin) {
+        for (size_t l = 1; l <= begin; ++l) {
+          const Cell& previous = best[begin - 1][l];
+          if (previous.total == INF || previous.bruteforce) continue;
+          update(begin, end, bruteforceGuesses(begin, end), l + 1, true);
+        }
+      }
+    }
+
+    double guesses = INF;
+    for (size_t l = 1; l <= length; ++l) {
+      guesses = min(guesses, best[length - 1][l].total);
+    }
+    return guesses;
+  }
+};
+
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using namespace std;
+
+// Трассировка интервалов в формате Chrome trace event (chrome://tracing,
+// Perfetto). Интервал отмечается макросом в начале блока:
+//
+//   TRACE_SPAN("loadUsers: parse");
+//   TRACE_FUNCTION();
+//
+// Имя должно жить до конца программы (строковый литерал или __func__).
+// Без определения SECURE_CALC_TRACING (опция CMake) макросы раскрываются
+// в пустое выражение. Со сборкой трассировки запись включается во время
+// работы Tracer::start, до этого интервал стоит одной загрузки флага.
+//
+// Каждый поток пишет в свой буфер без блокировок; буферы растут блоками
+// по CHUNK_EVENTS событий до MAX_CHUNKS, дальше события отбрасываются и
+// учитываются. Файл пишется при выходе (atexit) и по сигналу SIGUSR1.
+class Tracer {
+ public:
+  static constexpr size_t CHUNK_EVENTS = 4096;
+  static constexpr size_t MAX_CHUNKS = 64;
+
+  struct Event {
+    const char* name;
+    uint64_t startNs;  // steady_clock; в файле — от момента Tracer::start
+    uint64_t durationNs;
+  };
+
+  // Включает запись; false и error, если не удалось подготовить файл
+  static bool start(const string& path, string& error);
+  static bool isEnabled() noexcept {
+    return enabled.load(memory_order_relaxed);
+  }
+  // Пишет все накопленные события в файл (события не удаляются)
+  static bool dump(string& error);
+
+  static uint64_t nowNs() noexcept {
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::nanoseconds>(
+            chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  static void record(const char* name, uint64_t startNs,
+                     uint64_t endNs) noexcept;
+  // Интервал от Tracer::start до текущего момента, например весь запуск
+  static void recordSinceStart(const char* name) noexcept;
+
+ private:
+  static atomic<bool> enabled;
+};
+
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char* name) noexcept
+      : name(name), startNs(Tracer::isEnabled() ? Tracer::nowNs() : 0) {}
+  ~TraceSpan() {
+    if (startNs != 0) Tracer::record(name, startNs, Tracer::nowNs());
+  }
+
+  TraceSpan(const TraceSpan&) = delete;
+  TraceSpan& operator=(const TraceSpan&) = delete;
+
+ private:
+  const char* name;
+  uint64_t startNs;
+};
+
+#ifdef SECURE_CALC_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+#define TRACE_FUNCTION() TRACE_SPAN(__func__)
+#define TRACE_SINCE_START(name) Tracer::recordSinceStart(name)
+#else
+#define TRACE_SPAN(name) ((void)0)
+#define TRACE_FUNCTION() ((void)0)
+#define TRACE_SINCE_START(name) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef USER_STORE_H
+#define USER_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Компактное хранилище учётных записей в виде структуры массивов. Логин и
+// хэш пароля каждого пользователя лежат подряд в общей арене:
+//
+//   [длина логина, varint][логин][хэш]
+//
+// Хэш канонического формата (32 hex соли, '|', 16 hex значения) хранится
+// в двоичном виде, 24 байта; любой другой — как есть, с длиной varint.
+// Роль, активность и служебные биты упакованы в один байт. Поиск идёт по
+// плоской таблице с открытой адресацией из 32-битных номеров записей;
+// 32-битный хэш логина в отдельном массиве отсекает чужие записи, не
+// читая арену.
+//
+// Номер записи действителен до следующего insert, erase или
+// setPasswordHash: они могут уплотнить хранилище и перенумеровать записи.
+class UserStore {
+ public:
+  static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+  uint32_t find(string_view login) const;
+  // Логина в хранилище быть не должно
+  uint32_t insert(string_view login, string_view passwordHash, uint8_t role,
+                  bool isActive, uint32_t generation);
+  void erase(uint32_t id);
+  void clear();
+  // Резерв под users записей и arenaBytes байт арены, чтобы загрузка не
+  // копировала растущие массивы
+  void reserve(size_t users, size_t arenaBytes);
+  // Возвращает неиспользованный резерв арены и массивов
+  void shrinkToFit();
+
+  string_view login(uint32_t id) const;
+  string passwordHash(uint32_t id) const;
+  uint8_t role(uint32_t id) const { return flags[id] & ROLE_MASK; }
+  bool isActive(uint32_t id) const { return flags[id] & ACTIVE; }
+  uint32_t generation(uint32_t id) const { return generations[id]; }
+
+  void setRole(uint32_t id, uint8_t role) {
+    flags[id] = (flags[id] & ~ROLE_MASK) | (role & ROLE_MASK);
+  }
+  void setActive(uint32_t id, bool isActive) {
+    flags[id] = isActive ? flags[id] | ACTIVE : flags[id] & ~ACTIVE;
+  }
+  void setGeneration(uint32_t id, uint32_t generation) {
+    generations[id] = generation;
+  }
+  // Запись переносится в конец арены; старое место освобождается при
+  // уплотнении
+  void setPasswordHash(uint32_t id, string_view passwordHash);
+
+  size_t size() const { return live; }
+  // Память всех массивов и арены с учётом резерва
+  size_t memoryBytes() const;
+
+  // Обход живых записей в порядке хранения
+  template <typename Callback>
+  void forEach(Callback callback) const {
+    for (uint32_t id = 0; id < flags.size(); ++id) {
+      if (!(flags[id] & DELETED)) callback(id);
+    }
+  }
+
+ private:
+  static constexpr uint8_t ROLE_MASK = 0x03;
+  static constexpr uint8_t ACTIVE = 0x04;
+  static constexpr uint8_t PACKED_HASH = 0x08;
+  static constexpr uint8_t DELETED = 0x10;
+
+  // Ячейка индекса: номер записи + 2
+  static constexpr uint32_t EMPTY = 0;
+  static constexpr uint32_t TOMBSTONE = 1;
+
+  vector<char> arena;
+  vector<uint32_t> offsets;  // Начало записи в арене
+  vector<uint32_t> loginHashes;
+  vector<uint32_t> generations;
+  vector<uint8_t> flags;
+  vector<uint32_t> index;
+  size_t live = 0;
+  size_t tombstones = 0;
+  size_t garbageBytes = 0;  // Арена удалённых и перенесённых записей
+
+  static uint32_t hashLogin(string_view login);
+  uint32_t appendRecord(string_view login, string_view passwordHash,
+                        bool& packed);
+  size_t recordSize(uint32_t id) const;
+  size_t findSlot(uint32_t id) const;
+  void rebuildIndex(size_t capacity);
+  void compactIfSparse();
+};
+
+#endif
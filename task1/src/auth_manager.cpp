@@ -1,31 +1,86 @@
 #include "auth_manager.h"
 
-#include <unistd.h>
-
+#include <array>
 #include <iostream>
 
+#include "metrics.h"
+#include "trace.h"
+
 using namespace std;
 
+const char* loginStatusLabel(LoginStatus status) {
+  switch (status) {
+    case LoginStatus::SUCCESS:
+      return "success";
+    case LoginStatus::IP_LOCKED:
+      return "ip_locked";
+    case LoginStatus::RATE_LIMITED:
+      return "rate_limited";
+    case LoginStatus::ACCOUNT_LOCKED:
+      return "account_locked";
+    case LoginStatus::ACCOUNT_DISABLED:
+      return "account_disabled";
+    case LoginStatus::INVALID_CREDENTIALS:
+      return "invalid_credentials";
+    case LoginStatus::ACCOUNT_LOCKED_NOW:
+      return "account_locked_now";
+  }
+  return "unknown";
+}
+
+namespace {
+
+// Итог каждой попытки входа; ACCOUNT_LOCKED_NOW — ещё и блокировка аккаунта
+void countLoginAttempt(LoginStatus status) {
+  static const array<Counter*, 7> attempts = [] {
+    array<Counter*, 7> counters;
+    for (size_t i = 0; i < counters.size(); ++i) {
+      counters[i] = &metrics().counter(
+          "secure_calc_login_attempts_total", "Попытки входа по результату",
+          string("result=\"") +
+              loginStatusLabel(static_cast<LoginStatus>(i)) + "\"");
+    }
+    return counters;
+  }();
+  static Counter& lockouts = metrics().counter(
+      "secure_calc_account_lockouts_total", "Блокировки аккаунтов");
+
+  attempts[static_cast<size_t>(status)]->add();
+  if (status == LoginStatus::ACCOUNT_LOCKED_NOW) lockouts.add();
+}
+
+}  // namespace
+
 AuthManager::AuthManager(UserDatabase& db, SecurityLogger& logger)
-    : userDB(db), securityLogger(logger) {}
+    : userDB(db),
+      securityLogger(logger),
+      decoyHash(SecurePasswordHasher::hashPassword(
+          SecurePasswordHasher::generateSalt(16))) {}
+
+void AuthManager::attachSharedAttempts(SharedAttemptTable* table) {
+  sharedAttempts = table;
+  userDB.attachSharedAttempts(table);
+}
 
 string AuthManager::getClientIP() {
   return "127.0.0.1";  // Локальный IP для Linux/Mac
 }
 
-bool AuthManager::isAccountLocked(const string& login) {
-  if (loginAttempts.find(login) != loginAttempts.end()) {
-    LockInfo& info = loginAttempts[login];
-
-    if (info.attempts >= MAX_ACCOUNT_ATTEMPTS) {
+bool AuthManager::isAccountLocked(const string& login, int& remaining) {
+  if (sharedAttempts) {
+    return sharedAttempts->isLocked(SharedAttemptTable::Kind::ACCOUNT, login,
+                                    MAX_ACCOUNT_ATTEMPTS, time(nullptr),
+                                    remaining);
+  }
+  AttemptRecord* info = loginAttempts.find(login);
+  if (info) {
+    if (info->attempts >= MAX_ACCOUNT_ATTEMPTS) {
       time_t now = time(nullptr);
-      if (now < info.unlockTime) {
-        int remaining = info.unlockTime - now;
-        cout << "Аккаунт заблокирован. Попробуйте снова через " << remaining
-             << " секунд." << endl;
+      if (now < info->unlockTime) {
+        remaining = info->unlockTime - now;
         return true;
       } else {
-        info.attempts = 0;
+        info->attempts = 0;
       }
     }
   }
@@ -54,7 +109,147 @@ void AuthManager::showIPLockInfo(const string& ip) {
   }
 }
 
+bool AuthManager::verifyCredentials(const optional<UserInfo>& userInfo,
+                                    const string& password) {
+  // Проверка выполняется всегда, чтобы время ответа не выдавало
+  // существование учетной записи
+  static LatencyHistogram& latency = metrics().histogram(
+      "secure_calc_verify_password_seconds", "Время проверки пароля");
+  ScopedLatency timer(latency);
+  TRACE_FUNCTION();
+
+  const string& storedHash = userInfo ? userInfo->passwordHash : decoyHash;
+  bool matches = SecurePasswordHasher::verifyPassword(password, storedHash);
+  return userInfo.has_value() && matches;
+}
+
+void AuthManager::waitForIPUnlock(const string& ip) {
+  // Сессия паркуется на таймере и просыпается ровно в момент разблокировки
+  while (userDB.isIPLocked(ip)) {
+    time_t unlockTime = userDB.getIPUnlockTime(ip);
+    int remaining = unlockTime - time(nullptr);
+    if (remaining <= 0) break;
+
+    cout << "Ожидание разблокировки... " << remaining << " секунд" << endl;
+    lockTimer.waitUntil(DeadlineScheduler::Clock::from_time_t(unlockTime));
+  }
+}
+
+LoginResult AuthManager::checkLoginAllowed(const string& login,
+                                           const string& ip) {
+  TRACE_FUNCTION();
+  if (userDB.isIPLocked(ip)) {
+    int remaining = userDB.getIPUnlockTime(ip) - time(nullptr);
+    return {LoginStatus::IP_LOCKED, {}, 0, remaining};
+  }
+
+  if (attemptThrottle.isThrottled(login, ip)) {
+    uint64_t waitMs = attemptThrottle.retryAfterMs(login, ip);
+    securityLogger.logLoginFailure(login, ip, "Rate limited");
+    return {LoginStatus::RATE_LIMITED, {}, 0,
+            static_cast<int>((waitMs + 999) / 1000)};
+  }
+
+  int remaining = 0;
+  if (isAccountLocked(login, remaining)) {
+    securityLogger.logLoginFailure(login, ip, "Account locked");
+    userDB.registerFailedAttempt(ip);
+    return {LoginStatus::ACCOUNT_LOCKED, {}, 0, remaining};
+  }
+
+  optional<UserInfo> userInfo = userDB.getUser(login);
+  if (userInfo && !userInfo->isActive) {
+    securityLogger.logLoginFailure(login, ip, "Account disabled");
+    userDB.registerFailedAttempt(ip);
+    return {LoginStatus::ACCOUNT_DISABLED, {}, 0, 0};
+  }
+
+  return {LoginStatus::SUCCESS, {}, 0, 0};
+}
+
+LoginResult AuthManager::completeLogin(const string& login,
+                                       const string& password,
+                                       const string& ip) {
+  TRACE_FUNCTION();
+  optional<UserInfo> userInfo = userDB.getUser(login);
+  if (verifyCredentials(userInfo, password)) {
+    securityLogger.logLoginSuccess(login, ip);
+    resetAttempts(login, ip);
+    return {LoginStatus::SUCCESS, {login, userInfo->role, ip}, 0, 0};
+  }
+
+  time_t now = time(nullptr);
+  int attempts;
+  if (sharedAttempts) {
+    attempts = static_cast<int>(sharedAttempts->registerFailure(
+        SharedAttemptTable::Kind::ACCOUNT, login, MAX_ACCOUNT_ATTEMPTS,
+        ACCOUNT_LOCK_TIME, now));
+  } else {
+    AttemptRecord& info = loginAttempts.findOrInsert(login, now);
+    info.attempts++;
+    if (info.attempts >= MAX_ACCOUNT_ATTEMPTS) {
+      info.unlockTime = static_cast<uint32_t>(now + ACCOUNT_LOCK_TIME);
+    }
+    attempts = info.attempts;
+  }
+
+  userDB.registerFailedAttempt(ip);
+  attemptThrottle.registerFailure(login, ip);
+
+  string failureReason = userInfo ? "Wrong password" : "User not found";
+  securityLogger.logLoginFailure(login, ip, failureReason);
+
+  if (attempts >= MAX_ACCOUNT_ATTEMPTS) {
+    securityLogger.logSecurityEvent("Account locked",
+                                    "user=" + login + " ip=" + ip);
+    return {LoginStatus::ACCOUNT_LOCKED_NOW, {}, 0, ACCOUNT_LOCK_TIME};
+  }
+  return {LoginStatus::INVALID_CREDENTIALS, {},
+          MAX_ACCOUNT_ATTEMPTS - attempts, 0};
+}
+
+LoginResult AuthManager::attemptLogin(const string& login,
+                                      const string& password,
+                                      const string& ip) {
+  TRACE_FUNCTION();
+  LoginResult result = checkLoginAllowed(login, ip);
+  if (result.status == LoginStatus::SUCCESS) {
+    result = completeLogin(login, password, ip);
+  }
+  countLoginAttempt(result.status);
+  return result;
+}
+
+void AuthManager::reportLoginFailure(const LoginResult& result) {
+  switch (result.status) {
+    case LoginStatus::RATE_LIMITED:
+      cout << "Слишком частые попытки входа. Повторите через "
+           << result.retryAfter << " секунд." << endl;
+      break;
+    case LoginStatus::ACCOUNT_LOCKED:
+      cout << "Аккаунт заблокирован. Попробуйте снова через "
+           << result.retryAfter << " секунд." << endl;
+      break;
+    case LoginStatus::ACCOUNT_DISABLED:
+      cout << "Учетная запись отключена. Обратитесь к администратору." << endl;
+      break;
+    case LoginStatus::ACCOUNT_LOCKED_NOW:
+      cout << "\nПревышено максимальное количество попыток для аккаунта!"
+           << endl;
+      cout << "Аккаунт заблокирован на " << ACCOUNT_LOCK_TIME << " секунд."
+           << endl;
+      break;
+    case LoginStatus::INVALID_CREDENTIALS:
+      cout << "Неверные данные. Осталось попыток для аккаунта: "
+           << result.attemptsLeft << endl;
+      break;
+    default:
+      break;
+  }
+}
+
 UserSession AuthManager::authenticate() {
+  TRACE_FUNCTION();
   string login, password;
 
   cout << "=== СИСТЕМА АУТЕНТИФИКАЦИИ ===" << endl;
@@ -73,15 +268,7 @@ UserSession AuthManager::authenticate() {
       showIPLockInfo(clientIP);
       securityLogger.logSecurityEvent("IP blocked", "ip=" + clientIP);
 
-      while (userDB.isIPLocked(clientIP)) {
-        time_t unlockTime = userDB.getIPUnlockTime(clientIP);
-        time_t now = time(nullptr);
-        int remaining = unlockTime - now;
-        if (remaining <= 0) break;
-
-        cout << "Ожидание разблокировки... " << remaining << " секунд" << endl;
-        sleep(10);
-      }
+      waitForIPUnlock(clientIP);
       cout << "IP разблокирован! Продолжаем..." << endl;
       securityLogger.logSecurityEvent("IP unblocked", "ip=" + clientIP);
     }
@@ -89,18 +276,13 @@ UserSession AuthManager::authenticate() {
     cout << "\nЛогин: ";
     cin >> login;
 
-    if (isAccountLocked(login)) {
-      securityLogger.logLoginFailure(login, clientIP, "Account locked");
-      userDB.registerFailedAttempt(clientIP);
-      showIPLockInfo(clientIP);
-      continue;
+    LoginResult check = checkLoginAllowed(login, clientIP);
+    if (check.status != LoginStatus::SUCCESS) {
+      countLoginAttempt(check.status);
     }
-
-    UserInfo* userInfo = userDB.getUser(login);
-    if (userInfo && !userInfo->isActive) {
-      cout << "Учетная запись отключена. Обратитесь к администратору." << endl;
-      securityLogger.logLoginFailure(login, clientIP, "Account disabled");
-      userDB.registerFailedAttempt(clientIP);
+    if (check.status == LoginStatus::IP_LOCKED) continue;
+    if (check.status != LoginStatus::SUCCESS) {
+      reportLoginFailure(check);
       showIPLockInfo(clientIP);
       continue;
     }
@@ -108,51 +290,25 @@ UserSession AuthManager::authenticate() {
     cout << "Пароль: ";
     cin >> password;
 
-    if (userInfo && SecurePasswordHasher::verifyPassword(
-                        password, userInfo->passwordHash)) {
+    LoginResult result = completeLogin(login, password, clientIP);
+    countLoginAttempt(result.status);
+    if (result.status == LoginStatus::SUCCESS) {
       cout << "\nДоступ разрешен! Добро пожаловать, " << login << "!" << endl;
-      cout << "Ваша роль: " << getRoleName(userInfo->role) << endl;
-
-      securityLogger.logLoginSuccess(login, clientIP);
-      resetAttempts(login, clientIP);
-
-      return {login, userInfo->role, clientIP};
-    } else {
-      if (loginAttempts.find(login) == loginAttempts.end()) {
-        loginAttempts[login] = {1, 0};
-      } else {
-        loginAttempts[login].attempts++;
-      }
-
-      userDB.registerFailedAttempt(clientIP);
-
-      LockInfo& info = loginAttempts[login];
-      int remaining = MAX_ACCOUNT_ATTEMPTS - info.attempts;
-
-      string failureReason = userInfo ? "Wrong password" : "User not found";
-      securityLogger.logLoginFailure(login, clientIP, failureReason);
-
-      if (info.attempts >= MAX_ACCOUNT_ATTEMPTS) {
-        info.unlockTime = time(nullptr) + ACCOUNT_LOCK_TIME;
-        cout << "\nПревышено максимальное количество попыток для аккаунта!"
-             << endl;
-        cout << "Аккаунт заблокирован на " << ACCOUNT_LOCK_TIME << " секунд."
-             << endl;
-        securityLogger.logSecurityEvent("Account locked",
-                                        "user=" + login + " ip=" + clientIP);
-      } else if (remaining > 0) {
-        cout << "Неверные данные. Осталось попыток для аккаунта: " << remaining
-             << endl;
-      }
-
-      showIPLockInfo(clientIP);
+      cout << "Ваша роль: " << getRoleName(result.session.role) << endl;
+      return result.session;
     }
+
+    reportLoginFailure(result);
+    showIPLockInfo(clientIP);
   }
 }
 
 void AuthManager::resetAttempts(const string& login, const string& ip) {
-  if (loginAttempts.find(login) != loginAttempts.end()) {
-    loginAttempts[login].attempts = 0;
+  if (sharedAttempts) {
+    sharedAttempts->reset(SharedAttemptTable::Kind::ACCOUNT, login);
+  } else if (AttemptRecord* info = loginAttempts.find(login)) {
+    info->attempts = 0;
   }
   userDB.resetIPAttempts(ip);
+  attemptThrottle.resetAccount(login);
 }
\ No newline at end of file
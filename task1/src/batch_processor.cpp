@@ -0,0 +1,175 @@
+#include "batch_processor.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const char* const PERMISSION_DENIED =
+    "Недостаточно прав для выполнения этой операции!";
+const char* const INVALID_NUMBER = "Некорректное число!";
+const char* const TRAILING_INPUT = "Лишние символы в строке!";
+const char* const LINE_TOO_LONG = "Слишком длинная строка!";
+
+const char* skipSpaces(const char* p, const char* end) {
+  while (p < end && (*p == ' ' || *p == '\t')) ++p;
+  return p;
+}
+
+void appendError(string& out, BatchStats& stats, string_view message) {
+  ++stats.errors;
+  out.append("ОШИБКА: ");
+  out.append(message);
+  out.push_back('\n');
+}
+
+}  // namespace
+
+BatchProcessor::BatchProcessor(CalculatorEngine& engine, Role role)
+    : calculatorEngine(engine) {
+  for (const auto& entry : CalculatorOperations::entries) {
+    allowed[static_cast<uint8_t>(entry.symbol)] =
+        static_cast<int>(role) >= static_cast<int>(entry.role);
+  }
+}
+
+void BatchProcessor::evaluateLine(const char* begin, const char* end,
+                                  string& out, BatchStats& stats) const {
+  const char* p = skipSpaces(begin, end);
+  while (end > p && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+    --end;
+  }
+  if (p == end || *p == '#') return;
+
+  ++stats.lines;
+  char op = *p++;
+  const auto* entry = CalculatorOperations::find(op);
+  if (!entry) {
+    return appendError(out, stats,
+                       calcErrorMessage(CalcError::UNSUPPORTED_OPERATION));
+  }
+  if (!allowed[static_cast<uint8_t>(op)]) {
+    return appendError(out, stats, PERMISSION_DENIED);
+  }
+
+  double operands[2] = {0, 0};
+  for (int i = 0; i < entry->arity; ++i) {
+    p = skipSpaces(p, end);
+    auto [next, ec] = from_chars(p, end, operands[i]);
+    if (ec != errc() || next == p) {
+      return appendError(out, stats, INVALID_NUMBER);
+    }
+    p = next;
+  }
+  if (skipSpaces(p, end) != end) {
+    return appendError(out, stats, TRAILING_INPUT);
+  }
+
+  auto result = entry->arity == 2
+                    ? calculatorEngine.calculate(op, operands[0], operands[1])
+                    : calculatorEngine.calculateAdvanced(op, operands[0]);
+  if (!result.success) {
+    return appendError(out, stats, result.errorMessage);
+  }
+
+  // Кратчайшая запись, из которой from_chars восстановит то же число
+  char buffer[32];
+  auto [last, ec] = to_chars(buffer, buffer + sizeof(buffer), result.value);
+  out.append(buffer, last);
+  out.push_back('\n');
+}
+
+void BatchProcessor::evaluateLines(const char* begin, const char* end,
+                                   string& out, BatchStats& stats) const {
+  while (begin < end) {
+    const char* newline =
+        static_cast<const char*>(memchr(begin, '\n', end - begin));
+    const char* lineEnd = newline ? newline : end;
+    evaluateLine(begin, lineEnd, out, stats);
+    begin = lineEnd + 1;
+  }
+}
+
+bool BatchProcessor::run(int inputFd, int outputFd, BatchStats& stats,
+                         string& error) {
+  vector<char> input(READ_BUFFER_SIZE);
+  size_t carried = 0;  // Начало неполной строки из прошлого блока
+  // Строка длиннее буфера уже учтена как ошибка, её остаток до '\n'
+  // отбрасывается: буфер не растёт, и память не зависит от входа
+  bool skipping = false;
+  string out;
+  out.reserve(WRITE_BUFFER_SIZE);
+
+  while (true) {
+    ssize_t count =
+        read(inputFd, input.data() + carried, input.size() - carried);
+    if (count < 0) {
+      if (errno == EINTR) continue;
+      error = string("Ошибка чтения: ") + strerror(errno);
+      return false;
+    }
+    if (count == 0) {
+      if (!skipping) {
+        evaluateLines(input.data(), input.data() + carried, out, stats);
+      }
+      break;
+    }
+    stats.bytesIn += static_cast<size_t>(count);
+
+    // В перенесённой части перевода строки нет: ищем только в новых байтах
+    size_t filled = carried + static_cast<size_t>(count);
+    const char* data = input.data();
+    const char* lastNewline = static_cast<const char*>(
+        memrchr(data + carried, '\n', static_cast<size_t>(count)));
+    if (!lastNewline) {
+      carried = skipping ? 0 : filled;
+      if (carried == input.size()) {
+        ++stats.lines;
+        appendError(out, stats, LINE_TOO_LONG);
+        skipping = true;
+        carried = 0;
+      }
+      continue;
+    }
+
+    const char* begin = data;
+    if (skipping) {
+      // Первый перевод строки завершает отброшенную строку
+      begin = static_cast<const char*>(memchr(data, '\n', filled)) + 1;
+      skipping = false;
+    }
+    evaluateLines(begin, lastNewline + 1, out, stats);
+    carried = static_cast<size_t>(data + filled - (lastNewline + 1));
+    memmove(input.data(), lastNewline + 1, carried);
+
+    if (out.size() >= WRITE_BUFFER_SIZE) {
+      if (!writeAll(outputFd, out.data(), out.size(), error)) return false;
+      stats.bytesOut += out.size();
+      out.clear();
+    }
+  }
+
+  stats.bytesOut += out.size();
+  return writeAll(outputFd, out.data(), out.size(), error);
+}
+
+bool BatchProcessor::writeAll(int fd, const char* data, size_t size,
+                              string& error) {
+  while (size > 0) {
+    ssize_t written = write(fd, data, size);
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      error = string("Ошибка записи: ") + strerror(errno);
+      return false;
+    }
+    data += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
@@ -0,0 +1,628 @@
+#include "big_integer.h"
+
+#include <algorithm>
+#include <bit>
+#include <future>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+using Limbs = BigInteger::Limbs;
+
+const uint32_t DECIMAL_BASE = 1000000000;  // 10^9 — девять цифр в разряде
+const size_t KARATSUBA_THRESHOLD = 96;     // Разрядов; ниже — в столбик
+const size_t PARALLEL_THRESHOLD = 2048;    // Ниже потоки не окупаются
+const size_t NAIVE_CONVERSION_LIMBS = 48;
+const uint32_t FACTORIAL_LEAF = 32;
+
+// Непрерывный участок разрядов без ведущих нулей
+struct View {
+  const uint32_t* data;
+  size_t size;
+};
+
+View trimmed(const uint32_t* data, size_t size) {
+  while (size > 0 && data[size - 1] == 0) --size;
+  return {data, size};
+}
+
+View view(const Limbs& limbs) { return {limbs.data(), limbs.size()}; }
+
+void trim(Limbs& limbs) {
+  while (!limbs.empty() && limbs.back() == 0) limbs.pop_back();
+}
+
+unsigned resolveThreads(unsigned threads) {
+  if (threads != 0) return threads;
+  return max(1u, thread::hardware_concurrency());
+}
+
+int compare(View a, View b) {
+  if (a.size != b.size) return a.size < b.size ? -1 : 1;
+  for (size_t i = a.size; i-- > 0;) {
+    if (a.data[i] != b.data[i]) return a.data[i] < b.data[i] ? -1 : 1;
+  }
+  return 0;
+}
+
+Limbs add(View a, View b) {
+  if (a.size < b.size) swap(a, b);
+  Limbs out(a.size + 1);
+  uint64_t carry = 0;
+  for (size_t i = 0; i < a.size; ++i) {
+    uint64_t sum = uint64_t(a.data[i]) + (i < b.size ? b.data[i] : 0) + carry;
+    out[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+  out[a.size] = static_cast<uint32_t>(carry);
+  trim(out);
+  return out;
+}
+
+// a -= b при a >= b
+void subtractInPlace(Limbs& a, View b) {
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < a.size() && (i < b.size || borrow); ++i) {
+    uint64_t subtrahend = (i < b.size ? b.data[i] : 0) + borrow;
+    if (a[i] >= subtrahend) {
+      a[i] = static_cast<uint32_t>(a[i] - subtrahend);
+      borrow = 0;
+    } else {
+      a[i] = static_cast<uint32_t>((uint64_t(1) << 32) + a[i] - subtrahend);
+      borrow = 1;
+    }
+  }
+  trim(a);
+}
+
+// out[offset...] += v; out должен вмещать результат
+void addInto(Limbs& out, size_t offset, View v) {
+  uint64_t carry = 0;
+  size_t i = 0;
+  for (; i < v.size; ++i) {
+    uint64_t sum = uint64_t(out[offset + i]) + v.data[i] + carry;
+    out[offset + i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+  for (size_t k = offset + i; carry && k < out.size(); ++k) {
+    uint64_t sum = uint64_t(out[k]) + carry;
+    out[k] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+}
+
+void multiplySmall(Limbs& a, uint32_t factor) {
+  uint64_t carry = 0;
+  for (uint32_t& limb : a) {
+    uint64_t product = uint64_t(limb) * factor + carry;
+    limb = static_cast<uint32_t>(product);
+    carry = product >> 32;
+  }
+  if (carry) a.push_back(static_cast<uint32_t>(carry));
+}
+
+void addSmall(Limbs& a, uint32_t value) {
+  uint64_t carry = value;
+  for (size_t i = 0; carry && i < a.size(); ++i) {
+    uint64_t sum = uint64_t(a[i]) + carry;
+    a[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+  if (carry) a.push_back(static_cast<uint32_t>(carry));
+}
+
+// a /= divisor, возвращает остаток
+uint32_t divideSmall(Limbs& a, uint32_t divisor) {
+  uint64_t remainder = 0;
+  for (size_t i = a.size(); i-- > 0;) {
+    uint64_t current = (remainder << 32) | a[i];
+    a[i] = static_cast<uint32_t>(current / divisor);
+    remainder = current % divisor;
+  }
+  trim(a);
+  return static_cast<uint32_t>(remainder);
+}
+
+void shiftLeftBits(Limbs& a, size_t bits) {
+  if (a.empty() || bits == 0) return;
+  size_t limbShift = bits / 32;
+  unsigned bitShift = bits % 32;
+  Limbs out(a.size() + limbShift + 1, 0);
+  for (size_t i = 0; i < a.size(); ++i) {
+    uint64_t shifted = uint64_t(a[i]) << bitShift;
+    out[i + limbShift] |= static_cast<uint32_t>(shifted);
+    out[i + limbShift + 1] |= static_cast<uint32_t>(shifted >> 32);
+  }
+  trim(out);
+  a.swap(out);
+}
+
+__extension__ using Wide = unsigned __int128;
+
+// Пары 32-битных разрядов как 64-битные слова
+vector<uint64_t> packWords(View v) {
+  vector<uint64_t> words((v.size + 1) / 2);
+  for (size_t i = 0; i < v.size; ++i) {
+    words[i / 2] |= uint64_t(v.data[i]) << (32 * (i % 2));
+  }
+  return words;
+}
+
+// В столбик по 64-битным словам: вчетверо меньше умножений, чем по 32 бита
+Limbs schoolbook(View a, View b) {
+  vector<uint64_t> x = packWords(a), y = packWords(b);
+  vector<uint64_t> product(x.size() + y.size(), 0);
+  for (size_t i = 0; i < x.size(); ++i) {
+    uint64_t carry = 0;
+    for (size_t j = 0; j < y.size(); ++j) {
+      Wide t = Wide(x[i]) * y[j] + product[i + j] + carry;
+      product[i + j] = static_cast<uint64_t>(t);
+      carry = static_cast<uint64_t>(t >> 64);
+    }
+    product[i + y.size()] = carry;
+  }
+
+  Limbs out(2 * product.size());
+  for (size_t i = 0; i < product.size(); ++i) {
+    out[2 * i] = static_cast<uint32_t>(product[i]);
+    out[2 * i + 1] = static_cast<uint32_t>(product[i] >> 32);
+  }
+  trim(out);
+  return out;
+}
+
+Limbs karatsuba(View a, View b, unsigned threads) {
+  if (a.size < b.size) swap(a, b);
+  if (b.size == 0) return {};
+  if (b.size < KARATSUBA_THRESHOLD) return schoolbook(a, b);
+
+  size_t half = (a.size + 1) / 2;
+  View a0 = trimmed(a.data, half);
+  View a1 = trimmed(a.data + half, a.size - half);
+  bool parallel = threads > 1 && a.size >= PARALLEL_THRESHOLD;
+  Limbs result(a.size + b.size + 1, 0);
+
+  if (b.size <= half) {
+    // Несимметричные размеры: a = a1·B^half + a0, два умножения на b
+    Limbs low, high;
+    if (parallel) {
+      auto future = async(launch::async, karatsuba, a1, b, threads / 2);
+      low = karatsuba(a0, b, threads - threads / 2);
+      high = future.get();
+    } else {
+      low = karatsuba(a0, b, 1);
+      high = karatsuba(a1, b, 1);
+    }
+    addInto(result, 0, view(low));
+    addInto(result, half, view(high));
+    trim(result);
+    return result;
+  }
+
+  // a·b = z2·B^(2·half) + z1·B^half + z0,
+  // z1 = (a0 + a1)(b0 + b1) - z0 - z2: три умножения половинного размера
+  View b0 = trimmed(b.data, half);
+  View b1 = trimmed(b.data + half, b.size - half);
+  Limbs sumA = add(a0, a1);
+  Limbs sumB = add(b0, b1);
+
+  Limbs z0, z1, z2;
+  if (parallel) {
+    unsigned share = max(1u, threads / 3);
+    auto future2 = async(launch::async, karatsuba, a1, b1, share);
+    auto future1 =
+        async(launch::async, karatsuba, view(sumA), view(sumB), share);
+    z0 = karatsuba(a0, b0, max(1u, threads - 2 * share));
+    z2 = future2.get();
+    z1 = future1.get();
+  } else {
+    z0 = karatsuba(a0, b0, 1);
+    z2 = karatsuba(a1, b1, 1);
+    z1 = karatsuba(view(sumA), view(sumB), 1);
+  }
+  subtractInPlace(z1, view(z0));
+  subtractInPlace(z1, view(z2));
+
+  addInto(result, 0, view(z0));
+  addInto(result, half, view(z1));
+  addInto(result, 2 * half, view(z2));
+  trim(result);
+  return result;
+}
+
+// Алгоритм D Кнута (TAOCP 4.3.1) для модулей
+void divideMagnitudes(View a, View b, Limbs& quotient, Limbs& remainder) {
+  if (compare(a, b) < 0) {
+    quotient.clear();
+    remainder.assign(a.data, a.data + a.size);
+    return;
+  }
+  if (b.size == 1) {
+    quotient.assign(a.data, a.data + a.size);
+    uint32_t rest = divideSmall(quotient, b.data[0]);
+    remainder.clear();
+    if (rest) remainder.push_back(rest);
+    return;
+  }
+
+  // Нормализация: старший бит делителя должен быть единицей
+  unsigned shift = countl_zero(b.data[b.size - 1]);
+  size_t n = b.size;
+  size_t m = a.size - n;
+  Limbs v(n), u(a.size + 1);
+  for (size_t i = n; i-- > 0;) {
+    v[i] = (b.data[i] << shift) |
+           (shift && i > 0 ? b.data[i - 1] >> (32 - shift) : 0);
+  }
+  u[a.size] = shift ? a.data[a.size - 1] >> (32 - shift) : 0;
+  for (size_t i = a.size; i-- > 0;) {
+    u[i] = (a.data[i] << shift) |
+           (shift && i > 0 ? a.data[i - 1] >> (32 - shift) : 0);
+  }
+
+  const uint64_t BASE = uint64_t(1) << 32;
+  quotient.assign(m + 1, 0);
+  for (size_t j = m + 1; j-- > 0;) {
+    uint64_t numerator = (uint64_t(u[j + n]) << 32) | u[j + n - 1];
+    uint64_t qhat = numerator / v[n - 1];
+    uint64_t rhat = numerator % v[n - 1];
+    while (qhat >= BASE ||
+           qhat * v[n - 2] > ((rhat << 32) | u[j + n - 2])) {
+      qhat--;
+      rhat += v[n - 1];
+      if (rhat >= BASE) break;
+    }
+
+    // u[j..j+n] -= qhat * v
+    int64_t borrow = 0;
+    int64_t t;
+    for (size_t i = 0; i < n; ++i) {
+      uint64_t product = qhat * v[i];
+      t = int64_t(u[i + j]) - borrow - int64_t(product & 0xFFFFFFFF);
+      u[i + j] = static_cast<uint32_t>(t);
+      borrow = int64_t(product >> 32) - (t >> 32);
+    }
+    t = int64_t(u[j + n]) - borrow;
+    u[j + n] = static_cast<uint32_t>(t);
+
+    quotient[j] = static_cast<uint32_t>(qhat);
+    if (t < 0) {
+      // qhat оказалась на единицу больше: возвращаем v
+      quotient[j]--;
+      uint64_t carry = 0;
+      for (size_t i = 0; i < n; ++i) {
+        uint64_t sum = uint64_t(u[i + j]) + v[i] + carry;
+        u[i + j] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+      }
+      u[j + n] = static_cast<uint32_t>(u[j + n] + carry);
+    }
+  }
+  trim(quotient);
+
+  remainder.assign(n, 0);
+  for (size_t i = 0; i < n; ++i) {
+    remainder[i] = (u[i] >> shift) |
+                   (shift ? static_cast<uint32_t>(uint64_t(u[i + 1])
+                                                  << (32 - shift))
+                          : 0);
+  }
+  trim(remainder);
+}
+
+// Степени 10^(9·2^k) и их обратные для деления Барретта:
+// inverses[k] = floor(B^(2m) / powers[k]), m — число разрядов powers[k]
+struct PowerTable {
+  vector<Limbs> powers;
+  vector<Limbs> inverses;
+};
+
+Limbs powerOfBase(size_t limbs) {
+  Limbs result(limbs + 1, 0);
+  result[limbs] = 1;
+  return result;
+}
+
+// Обратное к powers[k] из обратного к powers[k-1]: квадрат даёт половину
+// нужной точности, шаг Ньютона — всю, последние единицы исправляются точно
+Limbs nextInverse(const Limbs& power, const Limbs& previousInverse,
+                  size_t previousSize, unsigned threads) {
+  size_t m = power.size();
+  Limbs estimate = BigInteger::multiply(previousInverse, previousInverse,
+                                        threads);
+  size_t drop = 4 * previousSize - 2 * m;
+  estimate.erase(estimate.begin(),
+                 estimate.begin() + min(drop, estimate.size()));
+
+  Limbs scale = powerOfBase(2 * m);
+  // Шаг Ньютона x += x·(S - p·x) / S удваивает число верных разрядов
+  Limbs product = BigInteger::multiply(power, estimate, threads);
+  bool below = compare(view(product), view(scale)) <= 0;
+  Limbs error = below ? scale : product;
+  subtractInPlace(error, below ? view(product) : view(scale));
+  Limbs correction = BigInteger::multiply(estimate, error, threads);
+  correction.erase(correction.begin(),
+                   correction.begin() + min(2 * m, correction.size()));
+  if (below) {
+    estimate = add(view(estimate), view(correction));
+  } else {
+    subtractInPlace(estimate, view(correction));
+  }
+
+  static const uint32_t ONE = 1;
+  product = BigInteger::multiply(power, estimate, threads);
+  while (compare(view(product), view(scale)) > 0) {
+    subtractInPlace(estimate, View{&ONE, 1});
+    subtractInPlace(product, view(power));
+  }
+  Limbs rest = scale;
+  subtractInPlace(rest, view(product));
+  while (compare(view(rest), view(power)) >= 0) {
+    addSmall(estimate, 1);
+    subtractInPlace(rest, view(power));
+  }
+  return estimate;
+}
+
+// Деление Барретта a / powers[k] при a < powers[k]^2
+void divideByPower(View a, const PowerTable& table, size_t k, Limbs& quotient,
+                   Limbs& remainder, unsigned threads) {
+  const Limbs& power = table.powers[k];
+  size_t m = power.size();
+  View top = a.size > m - 1 ? View{a.data + m - 1, a.size - (m - 1)}
+                            : View{nullptr, 0};
+  Limbs estimate = karatsuba(top, view(table.inverses[k]), threads);
+  if (estimate.size() > m + 1) {
+    quotient.assign(estimate.begin() + m + 1, estimate.end());
+  } else {
+    quotient.clear();
+  }
+
+  remainder.assign(a.data, a.data + a.size);
+  subtractInPlace(remainder, view(karatsuba(view(quotient), view(power),
+                                            threads)));
+  // Оценка Барретта меньше точного частного не более чем на 2
+  while (compare(view(remainder), view(power)) >= 0) {
+    subtractInPlace(remainder, view(power));
+    addSmall(quotient, 1);
+  }
+}
+
+// Ровно width цифр (с ведущими нулями) делением на 10^9
+void naiveDigits(View a, char* out, size_t width) {
+  Limbs value(a.data, a.data + a.size);
+  size_t position = width;
+  while (!value.empty() && position > 0) {
+    uint32_t chunk = divideSmall(value, DECIMAL_BASE);
+    for (int d = 0; d < 9 && position > 0; ++d) {
+      out[--position] = static_cast<char>('0' + chunk % 10);
+      chunk /= 10;
+    }
+  }
+  fill(out, out + position, '0');
+}
+
+// a < powers[k]^2 записывается ровно 9·2^(k+1) цифрами
+void convertDigits(View a, const PowerTable& table, size_t k, char* out,
+                   unsigned threads) {
+  size_t width = size_t(9) << (k + 1);
+  if (k == 0 || a.size <= NAIVE_CONVERSION_LIMBS) {
+    naiveDigits(a, out, width);
+    return;
+  }
+
+  Limbs quotient, remainder;
+  divideByPower(a, table, k, quotient, remainder, threads);
+  char* high = out;
+  char* low = out + width / 2;
+  if (threads > 1 && a.size >= PARALLEL_THRESHOLD) {
+    auto future = async(launch::async, convertDigits, view(quotient),
+                        cref(table), k - 1, high, threads / 2);
+    convertDigits(view(remainder), table, k - 1, low, threads - threads / 2);
+    future.get();
+  } else {
+    convertDigits(view(quotient), table, k - 1, high, 1);
+    convertDigits(view(remainder), table, k - 1, low, 1);
+  }
+}
+
+// Произведение нечётных частей чисел lo..hi: множители 2 учитываются
+// отдельно одним сдвигом в конце
+Limbs oddProduct(uint32_t lo, uint32_t hi, unsigned threads) {
+  if (hi - lo < FACTORIAL_LEAF) {
+    Limbs product = {1};
+    uint64_t chunk = 1;
+    for (uint64_t i = lo; i <= hi; ++i) {
+      uint64_t odd = i >> countr_zero(i);
+      if (chunk * odd > UINT32_MAX) {
+        multiplySmall(product, static_cast<uint32_t>(chunk));
+        chunk = odd;
+      } else {
+        chunk *= odd;
+      }
+    }
+    multiplySmall(product, static_cast<uint32_t>(chunk));
+    return product;
+  }
+
+  uint32_t mid = lo + (hi - lo) / 2;
+  Limbs left, right;
+  if (threads > 1 && hi - lo > 4096) {
+    auto future = async(launch::async, oddProduct, lo, mid, threads / 2);
+    right = oddProduct(mid + 1, hi, threads - threads / 2);
+    left = future.get();
+  } else {
+    left = oddProduct(lo, mid, 1);
+    right = oddProduct(mid + 1, hi, 1);
+  }
+  return karatsuba(view(left), view(right), threads);
+}
+
+}  // namespace
+
+BigInteger::BigInteger(long long value) {
+  negative = value < 0;
+  uint64_t magnitude =
+      negative ? uint64_t(0) - static_cast<uint64_t>(value) : uint64_t(value);
+  while (magnitude) {
+    limbs.push_back(static_cast<uint32_t>(magnitude));
+    magnitude >>= 32;
+  }
+}
+
+BigInteger::BigInteger(Limbs magnitude, bool isNegative)
+    : negative(isNegative), limbs(std::move(magnitude)) {
+  normalize();
+}
+
+void BigInteger::normalize() {
+  trim(limbs);
+  if (limbs.empty()) negative = false;
+}
+
+size_t BigInteger::bitLength() const {
+  if (limbs.empty()) return 0;
+  return (limbs.size() - 1) * 32 + (32 - countl_zero(limbs.back()));
+}
+
+BigInteger::Limbs BigInteger::multiply(const Limbs& a, const Limbs& b,
+                                       unsigned threads) {
+  return karatsuba(view(a), view(b), resolveThreads(threads));
+}
+
+bool BigInteger::fromString(const string& text, BigInteger& result,
+                            string& error) {
+  size_t begin = 0;
+  bool isNegative = false;
+  if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+    isNegative = text[0] == '-';
+    begin = 1;
+  }
+  if (begin == text.size()) {
+    error = "Ожидалось целое число";
+    return false;
+  }
+  for (size_t i = begin; i < text.size(); ++i) {
+    if (text[i] < '0' || text[i] > '9') {
+      error = "Некорректное целое число: " + text;
+      return false;
+    }
+  }
+
+  // Блоки по 9 цифр: value = value·10^9 + блок
+  Limbs value;
+  size_t first = (text.size() - begin) % 9;
+  if (first == 0) first = 9;
+  for (size_t pos = begin; pos < text.size();) {
+    size_t length = pos == begin ? first : 9;
+    uint32_t chunk = 0;
+    for (size_t i = 0; i < length; ++i) chunk = chunk * 10 + (text[pos + i] - '0');
+    multiplySmall(value, DECIMAL_BASE);
+    addSmall(value, chunk);
+    pos += length;
+  }
+  result = BigInteger(std::move(value), isNegative);
+  return true;
+}
+
+string BigInteger::toString(unsigned threads) const {
+  if (limbs.empty()) return "0";
+  threads = resolveThreads(threads);
+
+  string digits;
+  if (limbs.size() <= NAIVE_CONVERSION_LIMBS) {
+    digits.assign(limbs.size() * 10, '0');
+    naiveDigits(view(limbs), digits.data(), digits.size());
+  } else {
+    // Степени 10^(9·2^k), пока квадрат последней не превысит число
+    PowerTable table;
+    table.powers.push_back({DECIMAL_BASE});
+    table.inverses.push_back({static_cast<uint32_t>(UINT64_MAX / DECIMAL_BASE),
+                              static_cast<uint32_t>((UINT64_MAX / DECIMAL_BASE) >> 32)});
+    trim(table.inverses.back());
+    while (true) {
+      Limbs square = multiply(table.powers.back(), table.powers.back(), threads);
+      if (compare(view(square), view(limbs)) > 0) break;
+      table.powers.push_back(std::move(square));
+      const Limbs& previous = table.powers[table.powers.size() - 2];
+      table.inverses.push_back(nextInverse(table.powers.back(),
+                                           table.inverses.back(),
+                                           previous.size(), threads));
+    }
+
+    size_t k = table.powers.size() - 1;
+    digits.assign(size_t(9) << (k + 1), '0');
+    convertDigits(view(limbs), table, k, digits.data(), threads);
+  }
+
+  size_t firstDigit = digits.find_first_not_of('0');
+  digits.erase(0, firstDigit);
+  return negative ? "-" + digits : digits;
+}
+
+BigInteger BigInteger::factorial(uint32_t n, unsigned threads) {
+  if (n < 2) return BigInteger(1);
+  Limbs product = oddProduct(1, n, resolveThreads(threads));
+  // Показатель двойки в n! по Лежандру: n - (число единиц в n)
+  shiftLeftBits(product, n - popcount(n));
+  return BigInteger(std::move(product), false);
+}
+
+BigInteger BigInteger::power(const BigInteger& base, uint32_t exponent) {
+  Limbs result = {1};
+  Limbs square = base.limbs;
+  for (uint32_t e = exponent; e > 0; e >>= 1) {
+    if (e & 1) result = multiply(result, square);
+    if (e > 1) square = multiply(square, square);
+  }
+  return BigInteger(std::move(result), base.negative && (exponent & 1));
+}
+
+bool BigInteger::divide(const BigInteger& a, const BigInteger& b,
+                        BigInteger& quotient, BigInteger& remainder) {
+  if (b.isZero()) return false;
+  Limbs q, r;
+  divideMagnitudes(view(a.limbs), view(b.limbs), q, r);
+  quotient = BigInteger(std::move(q), a.negative != b.negative);
+  remainder = BigInteger(std::move(r), a.negative);
+  return true;
+}
+
+BigInteger BigInteger::operator-() const {
+  return BigInteger(limbs, !negative);
+}
+
+BigInteger operator+(const BigInteger& a, const BigInteger& b) {
+  if (a.negative == b.negative) {
+    return BigInteger(add(view(a.limbs), view(b.limbs)), a.negative);
+  }
+  // Разные знаки: из большего модуля вычитается меньший
+  int order = compare(view(a.limbs), view(b.limbs));
+  if (order == 0) return BigInteger();
+  const BigInteger& larger = order > 0 ? a : b;
+  const BigInteger& smaller = order > 0 ? b : a;
+  Limbs magnitude = larger.limbs;
+  subtractInPlace(magnitude, view(smaller.limbs));
+  return BigInteger(std::move(magnitude), larger.negative);
+}
+
+BigInteger operator-(const BigInteger& a, const BigInteger& b) {
+  return a + (-b);
+}
+
+BigInteger operator*(const BigInteger& a, const BigInteger& b) {
+  return BigInteger(BigInteger::multiply(a.limbs, b.limbs),
+                    a.negative != b.negative);
+}
+
+bool operator==(const BigInteger& a, const BigInteger& b) {
+  return a.negative == b.negative && a.limbs == b.limbs;
+}
+
+bool operator<(const BigInteger& a, const BigInteger& b) {
+  if (a.negative != b.negative) return a.negative;
+  int order = compare(view(a.limbs), view(b.limbs));
+  return a.negative ? order > 0 : order < 0;
+}
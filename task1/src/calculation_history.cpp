@@ -0,0 +1,135 @@
+#include "calculation_history.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+
+using namespace std;
+
+const char* historyStatusMessage(uint8_t status) {
+  if (status == HISTORY_OK) return "OK";
+  if (status == HISTORY_EXPRESSION_ERROR) return "Ошибка в выражении";
+  return calcErrorMessage(static_cast<CalcError>(status - 1));
+}
+
+CalculationHistory::CalculationHistory(size_t capacity)
+    : capacity((max<size_t>(capacity, 1) + BLOCK_RECORDS - 1) /
+               BLOCK_RECORDS * BLOCK_RECORDS),
+      arena(BLOCK_RECORDS * sizeof(HistoryRecord)) {
+  blocks.reserve(this->capacity / BLOCK_RECORDS);
+}
+
+HistoryRecord& CalculationHistory::slot(uint32_t sequence) const {
+  size_t position = (sequence - 1 - base) % capacity;
+  return blocks[position / BLOCK_RECORDS][position % BLOCK_RECORDS];
+}
+
+void CalculationHistory::append(char operation, uint8_t arity,
+                                double operand1, double operand2,
+                                double result, uint8_t status) {
+  size_t position = (appended - base) % capacity;
+  if (position / BLOCK_RECORDS == blocks.size()) {
+    blocks.push_back(static_cast<HistoryRecord*>(
+        arena.allocate(BLOCK_RECORDS * sizeof(HistoryRecord),
+                       alignof(HistoryRecord))));
+  }
+  ++appended;
+
+  HistoryRecord& record = slot(appended);
+  record.operand1 = operand1;
+  record.operand2 = operand2;
+  record.result = result;
+  record.timestamp = static_cast<int64_t>(time(nullptr));
+  record.sequence = appended;
+  record.operation = operation;
+  record.arity = arity;
+  record.status = status;
+  record.reserved = 0;
+}
+
+size_t CalculationHistory::size() const {
+  return min<size_t>(appended - base, capacity);
+}
+
+const HistoryRecord* CalculationHistory::find(uint32_t sequence) const {
+  if (sequence == 0 || sequence > appended || sequence < firstSequence()) {
+    return nullptr;
+  }
+  return &slot(sequence);
+}
+
+void CalculationHistory::clear() {
+  blocks.clear();
+  arena.release();
+  base = appended;
+}
+
+bool CalculationHistory::exportFile(const string& path, string& error) const {
+  bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+  return csv ? exportCsv(path, error) : exportBinary(path, error);
+}
+
+bool CalculationHistory::exportCsv(const string& path, string& error) const {
+  ofstream out(path, ios::trunc);
+  if (!out) {
+    error = "Не удалось открыть " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  out << "sequence,timestamp,operation,operand1,operand2,result,status\n";
+  char buffer[32];
+  auto number = [&](double value) {
+    if (isnan(value)) return string_view();
+    auto [last, ec] = to_chars(buffer, buffer + sizeof(buffer), value);
+    return string_view(buffer, last);
+  };
+  for (uint32_t sequence = firstSequence(); sequence <= appended; ++sequence) {
+    const HistoryRecord& record = slot(sequence);
+    out << record.sequence << ',' << record.timestamp << ','
+        << record.operation << ',';
+    out << (record.arity > 0 ? number(record.operand1) : "") << ',';
+    out << (record.arity > 1 ? number(record.operand2) : "") << ',';
+    out << number(record.result) << ",\"" << historyStatusMessage(record.status)
+        << "\"\n";
+  }
+
+  out.flush();
+  if (!out) {
+    error = "Ошибка записи в " + path;
+    return false;
+  }
+  return true;
+}
+
+bool CalculationHistory::exportBinary(const string& path,
+                                      string& error) const {
+  ofstream out(path, ios::binary | ios::trunc);
+  if (!out) {
+    error = "Не удалось открыть " + path + ": " + strerror(errno);
+    return false;
+  }
+
+  HistoryFileHeader header{"SCHIST1", sizeof(HistoryRecord),
+                           static_cast<uint32_t>(size())};
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  // Подряд идущие номера внутри блока лежат подряд: пишем кусками
+  for (uint32_t sequence = firstSequence(); sequence <= appended;) {
+    size_t position = (sequence - 1 - base) % capacity;
+    size_t run = min<size_t>(BLOCK_RECORDS - position % BLOCK_RECORDS,
+                             appended - sequence + 1);
+    out.write(reinterpret_cast<const char*>(&slot(sequence)),
+              static_cast<streamsize>(run * sizeof(HistoryRecord)));
+    sequence += static_cast<uint32_t>(run);
+  }
+
+  out.flush();
+  if (!out) {
+    error = "Ошибка записи в " + path;
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,263 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "calculator_engine.h"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define CALCULATOR_BATCH_X86 1
+#endif
+
+using namespace std;
+
+// Пакетные ядра CalculatorEngine::calculateBatch.
+//
+// Сложение, вычитание, умножение, деление и корень выполняются векторно
+// и дают те же биты, что и скалярные операции (IEEE 754). Для логарифма и
+// степени векторно проверяется область определения, а значение считается
+// функциями libm по элементам: векторные приближения log/pow расходились бы
+// со скалярным calculate в последних разрядах.
+
+namespace {
+
+using Kernel = void (*)(char operation, const double* a, const double* b,
+                        double* out, uint8_t* status, size_t count);
+
+const double NOT_A_NUMBER = numeric_limits<double>::quiet_NaN();
+
+inline void scalarLane(char operation, double a, double b, double& out,
+                       uint8_t& status) {
+  status = CalculatorEngine::BATCH_OK;
+  switch (operation) {
+    case '+':
+      out = a + b;
+      break;
+    case '-':
+      out = a - b;
+      break;
+    case '*':
+      out = a * b;
+      break;
+    case '/':
+      if (b == 0) {
+        status = CalculatorEngine::BATCH_DIVISION_BY_ZERO;
+        out = NOT_A_NUMBER;
+      } else {
+        out = a / b;
+      }
+      break;
+    case '^':
+      out = CalculatorEngine::power(a, b);
+      break;
+    case 's':
+      if (a < 0) {
+        status = CalculatorEngine::BATCH_DOMAIN_ERROR;
+        out = NOT_A_NUMBER;
+      } else {
+        out = sqrt(a);
+      }
+      break;
+    case 'l':
+      if (a <= 0) {
+        status = CalculatorEngine::BATCH_DOMAIN_ERROR;
+        out = NOT_A_NUMBER;
+      } else {
+        out = log(a);
+      }
+      break;
+  }
+}
+
+void scalarKernel(char operation, const double* a, const double* b,
+                  double* out, uint8_t* status, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    scalarLane(operation, a[i], b ? b[i] : 0, out[i], status[i]);
+  }
+}
+
+#ifdef CALCULATOR_BATCH_X86
+
+// Маска ошибок из movemask -> байты статуса (бит k -> байт k)
+inline void writeStatus(uint8_t* status, int mask, int lanes, uint8_t code) {
+  for (int k = 0; k < lanes; ++k) {
+    status[k] = (mask >> k) & 1 ? code : uint8_t(CalculatorEngine::BATCH_OK);
+  }
+}
+
+// Логарифм и степень: значения по элементам, статусы как в скалярном ядре
+inline void libmLanes(char operation, const double* a, const double* b,
+                      double* out, uint8_t* status, int lanes, int errors) {
+  for (int k = 0; k < lanes; ++k) {
+    if (operation == '^') {
+      out[k] = CalculatorEngine::power(a[k], b[k]);
+    } else {
+      out[k] = (errors >> k) & 1 ? NOT_A_NUMBER : log(a[k]);
+    }
+  }
+  writeStatus(status, errors, lanes, CalculatorEngine::BATCH_DOMAIN_ERROR);
+}
+
+// SSE2 есть на любом x86-64, поэтому это ядро по умолчанию
+void sse2Kernel(char operation, const double* a, const double* b, double* out,
+                uint8_t* status, size_t count) {
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d nan = _mm_set1_pd(NOT_A_NUMBER);
+  size_t i = 0;
+
+  for (; i + 2 <= count; i += 2) {
+    __m128d x = _mm_loadu_pd(a + i);
+    __m128d y = b ? _mm_loadu_pd(b + i) : zero;
+    __m128d result;
+    int errors = 0;
+    uint8_t code = CalculatorEngine::BATCH_OK;
+
+    switch (operation) {
+      case '+':
+        result = _mm_add_pd(x, y);
+        break;
+      case '-':
+        result = _mm_sub_pd(x, y);
+        break;
+      case '*':
+        result = _mm_mul_pd(x, y);
+        break;
+      case '/': {
+        __m128d bad = _mm_cmpeq_pd(y, zero);
+        errors = _mm_movemask_pd(bad);
+        code = CalculatorEngine::BATCH_DIVISION_BY_ZERO;
+        result = _mm_or_pd(_mm_and_pd(bad, nan),
+                           _mm_andnot_pd(bad, _mm_div_pd(x, y)));
+        break;
+      }
+      case 's': {
+        __m128d bad = _mm_cmplt_pd(x, zero);
+        errors = _mm_movemask_pd(bad);
+        code = CalculatorEngine::BATCH_DOMAIN_ERROR;
+        result = _mm_or_pd(_mm_and_pd(bad, nan),
+                           _mm_andnot_pd(bad, _mm_sqrt_pd(x)));
+        break;
+      }
+      case 'l':
+        errors = _mm_movemask_pd(_mm_cmple_pd(x, zero));
+        libmLanes(operation, a + i, nullptr, out + i, status + i, 2, errors);
+        continue;
+      default:  // '^'
+        libmLanes(operation, a + i, b + i, out + i, status + i, 2, 0);
+        continue;
+    }
+    _mm_storeu_pd(out + i, result);
+    writeStatus(status + i, errors, 2, code);
+  }
+  scalarKernel(operation, a + i, b ? b + i : nullptr, out + i, status + i,
+               count - i);
+}
+
+__attribute__((target("avx2"))) void avx2Kernel(char operation,
+                                                const double* a,
+                                                const double* b, double* out,
+                                                uint8_t* status,
+                                                size_t count) {
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d nan = _mm256_set1_pd(NOT_A_NUMBER);
+  size_t i = 0;
+
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_loadu_pd(a + i);
+    __m256d y = b ? _mm256_loadu_pd(b + i) : zero;
+    __m256d result;
+    int errors = 0;
+    uint8_t code = CalculatorEngine::BATCH_OK;
+
+    switch (operation) {
+      case '+':
+        result = _mm256_add_pd(x, y);
+        break;
+      case '-':
+        result = _mm256_sub_pd(x, y);
+        break;
+      case '*':
+        result = _mm256_mul_pd(x, y);
+        break;
+      case '/': {
+        __m256d bad = _mm256_cmp_pd(y, zero, _CMP_EQ_OQ);
+        errors = _mm256_movemask_pd(bad);
+        code = CalculatorEngine::BATCH_DIVISION_BY_ZERO;
+        result = _mm256_blendv_pd(_mm256_div_pd(x, y), nan, bad);
+        break;
+      }
+      case 's': {
+        __m256d bad = _mm256_cmp_pd(x, zero, _CMP_LT_OQ);
+        errors = _mm256_movemask_pd(bad);
+        code = CalculatorEngine::BATCH_DOMAIN_ERROR;
+        result = _mm256_blendv_pd(_mm256_sqrt_pd(x), nan, bad);
+        break;
+      }
+      case 'l':
+        errors = _mm256_movemask_pd(_mm256_cmp_pd(x, zero, _CMP_LE_OQ));
+        libmLanes(operation, a + i, nullptr, out + i, status + i, 4, errors);
+        continue;
+      default:  // '^'
+        libmLanes(operation, a + i, b + i, out + i, status + i, 4, 0);
+        continue;
+    }
+    _mm256_storeu_pd(out + i, result);
+    writeStatus(status + i, errors, 4, code);
+  }
+  scalarKernel(operation, a + i, b ? b + i : nullptr, out + i, status + i,
+               count - i);
+}
+
+#endif
+
+struct KernelChoice {
+  Kernel kernel;
+  const char* name;
+};
+
+const KernelChoice& selectKernel() {
+  static const KernelChoice choice = []() -> KernelChoice {
+#ifdef CALCULATOR_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {avx2Kernel, "avx2"};
+    return {sse2Kernel, "sse2"};
+#else
+    return {scalarKernel, "scalar"};
+#endif
+  }();
+  return choice;
+}
+
+}  // namespace
+
+bool CalculatorEngine::calculateBatch(char operation, span<const double> a,
+                                      span<const double> b, span<double> out,
+                                      span<uint8_t> status) {
+  bool unary = operation == 's' || operation == 'l';
+  bool binary = operation == '+' || operation == '-' || operation == '*' ||
+                operation == '/' || operation == '^';
+  if (!unary && !binary) return false;
+  if (out.size() != a.size() || status.size() != a.size()) return false;
+  if (binary && b.size() != a.size()) return false;
+
+  selectKernel().kernel(operation, a.data(), binary ? b.data() : nullptr,
+                        out.data(), status.data(), a.size());
+  return true;
+}
+
+const char* CalculatorEngine::batchKernelName() { return selectKernel().name; }
+
+const char* CalculatorEngine::batchStatusMessage(char operation,
+                                                 uint8_t status) {
+  switch (status) {
+    case BATCH_OK:
+      return "";
+    case BATCH_DIVISION_BY_ZERO:
+      return calcErrorMessage(CalcError::DIVISION_BY_ZERO);
+    case BATCH_DOMAIN_ERROR:
+      return calcErrorMessage(operation == 's' ? CalcError::NEGATIVE_SQRT
+                                               : CalcError::NONPOSITIVE_LOG);
+    default:
+      return "Неизвестная ошибка!";
+  }
+}
@@ -1,10 +1,43 @@
 #include "calculator_engine.h"
 
+#include "big_integer.h"
+
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 
+#include "metrics.h"
+
 using namespace std;
 
+namespace {
+
+// Создаются при статической инициализации: calculate и calculateAdvanced
+// объявлены noexcept и не должны выделять память при первом вызове
+Counter& doubleCalculations = metrics().counter(
+    "secure_calc_calculations_total", "Вычисления по режиму",
+    "mode=\"double\"");
+Counter& doubleErrors = metrics().counter(
+    "secure_calc_calculation_errors_total", "Вычисления с ошибкой по режиму",
+    "mode=\"double\"");
+Counter& integerCalculations = metrics().counter(
+    "secure_calc_calculations_total", "Вычисления по режиму",
+    "mode=\"integer\"");
+Counter& integerErrors = metrics().counter(
+    "secure_calc_calculation_errors_total", "Вычисления с ошибкой по режиму",
+    "mode=\"integer\"");
+LatencyHistogram& integerLatency = metrics().histogram(
+    "secure_calc_integer_calculation_seconds",
+    "Время операции целочисленного режима вместе с кэшем");
+Counter& integerCacheHits = metrics().counter(
+    "secure_calc_integer_cache_lookups_total",
+    "Обращения к кэшу целочисленного режима", "result=\"hit\"");
+Counter& integerCacheMisses = metrics().counter(
+    "secure_calc_integer_cache_lookups_total",
+    "Обращения к кэшу целочисленного режима", "result=\"miss\"");
+
+}  // namespace
+
 long long CalculatorEngine::factorial(int n) {
   long long result = 1;
   for (int i = 2; i <= n; ++i) {
@@ -17,68 +50,139 @@ double CalculatorEngine::power(double base, double exponent) {
   return pow(base, exponent);
 }
 
-CalculatorEngine::CalculationResult CalculatorEngine::calculate(char operation,
-                                                                double num1,
-                                                                double num2) {
-  CalculationResult result;
+Role CalculatorEngine::requiredRole(char operation) {
+  return CalculatorOperations::requiredRole(operation);
+}
+
+CalcOutcome CalculatorEngine::compute(char operation, double num1,
+                                      double num2) noexcept {
+  return CalculatorOperations::dispatch(operation, num1, num2);
+}
+
+namespace {
+
+CalculatorEngine::CalculationResult toResult(CalcOutcome outcome) noexcept {
+  doubleCalculations.add();
+  if (!outcome) doubleErrors.add();
+  if (outcome) return {true, *outcome, {}, {}};
+  return {false, 0, calcErrorMessage(outcome.error()), outcome.error()};
+}
+
+}  // namespace
+
+CalculatorEngine::CalculationResult CalculatorEngine::calculate(
+    char operation, double num1, double num2) noexcept {
+  return toResult(CalculatorOperations::dispatch<2>(operation, num1, num2));
+}
+
+CalculatorEngine::CalculationResult CalculatorEngine::calculateAdvanced(
+    char operation, double num) noexcept {
+  return toResult(CalculatorOperations::dispatch<1>(operation, num, 0));
+}
+
+void CalculatorEngine::enableResultCache(const ResultCacheConfig& config) {
+  isolateUsers = config.isolateUsers;
+  integerCache = make_unique<IntegerCache>(config);
+}
+
+ResultCacheStats CalculatorEngine::getCacheStats() const {
+  return integerCache ? integerCache->getStats() : ResultCacheStats{};
+}
+
+uint32_t CalculatorEngine::cacheScope(const string& username) {
+  if (!isolateUsers) return 0;
+  lock_guard<mutex> lock(scopeMutex);
+  auto [it, inserted] =
+      scopes.emplace(username, static_cast<uint32_t>(scopes.size() + 1));
+  return it->second;
+}
+
+CalculatorEngine::IntegerResult CalculatorEngine::calculateInteger(
+    char operation, const string& a, const string& b, uint32_t scope) {
+  ScopedLatency timer(integerLatency);
+  integerCalculations.add();
+  if (!integerCache) {
+    IntegerResult result = computeInteger(operation, a, b);
+    if (!result.success) integerErrors.add();
+    return result;
+  }
+
+  // Ключ: область, операция и оба операнда (b отделён нулевым байтом)
+  string key(sizeof(scope), '\0');
+  memcpy(key.data(), &scope, sizeof(scope));
+  key += operation;
+  key += a;
+  key += '\0';
+  key += b;
+
+  IntegerResult result{true, "", ""};
+  if (integerCache->lookup(key, result.value)) {
+    integerCacheHits.add();
+    return result;
+  }
+  integerCacheMisses.add();
+  result = computeInteger(operation, a, b);
+  if (result.success) {
+    integerCache->store(key, result.value);
+  } else {
+    integerErrors.add();
+  }
+  return result;
+}
+
+CalculatorEngine::IntegerResult CalculatorEngine::computeInteger(
+    char operation, const string& a, const string& b) {
+  IntegerResult result;
 
   try {
+    string error;
+    BigInteger x, y;
+    if (!BigInteger::fromString(a, x, error)) throw runtime_error(error);
+    if (operation != '!' && !BigInteger::fromString(b, y, error))
+      throw runtime_error(error);
+
+    BigInteger value;
     switch (operation) {
       case '+':
-        result.value = num1 + num2;
+        value = x + y;
         break;
       case '-':
-        result.value = num1 - num2;
+        value = x - y;
         break;
       case '*':
-        result.value = num1 * num2;
+        value = x * y;
         break;
       case '/':
-        if (num2 == 0) throw runtime_error("Деление на ноль!");
-        result.value = num1 / num2;
+      case '%': {
+        BigInteger quotient, remainder;
+        if (!BigInteger::divide(x, y, quotient, remainder))
+          throw runtime_error("Деление на ноль!");
+        value = operation == '/' ? quotient : remainder;
         break;
-      case '^':
-        result.value = power(num1, num2);
+      }
+      case '^': {
+        if (y.isNegative())
+          throw runtime_error("Отрицательная степень не является целым!");
+        if (y.bitLength() > 32 ||
+            (x.bitLength() > 1 && x.bitLength() * static_cast<size_t>(
+                                      y.getLimbs()[0]) > MAX_INTEGER_BITS))
+          throw runtime_error("Слишком большой результат возведения в степень!");
+        uint32_t exponent = y.isZero() ? 0 : y.getLimbs()[0];
+        value = BigInteger::power(x, exponent);
         break;
-      default:
-        throw runtime_error("Неподдерживаемая операция!");
-    }
-    result.success = true;
-  } catch (const exception& e) {
-    result.success = false;
-    result.errorMessage = e.what();
-  }
-
-  return result;
-}
-
-CalculatorEngine::CalculationResult CalculatorEngine::calculateAdvanced(
-    char operation, double num) {
-  CalculationResult result;
-
-  try {
-    switch (operation) {
+      }
       case '!':
-        if (num < 0)
+        if (x.isNegative())
           throw runtime_error("Факториал отрицательного числа не определен!");
-        if (num > 20)
+        if (x.bitLength() > 32 || (!x.isZero() && x.getLimbs()[0] >
+                                                     MAX_INTEGER_FACTORIAL))
           throw runtime_error("Слишком большое число для факториала!");
-        result.value = static_cast<double>(factorial(static_cast<int>(num)));
-        break;
-      case 's':
-        if (num < 0)
-          throw runtime_error("Квадратный корень из отрицательного числа!");
-        result.value = sqrt(num);
-        break;
-      case 'l':
-        if (num <= 0)
-          throw runtime_error(
-              "Логарифм определен только для положительных чисел!");
-        result.value = log(num);
+        value = BigInteger::factorial(x.isZero() ? 0 : x.getLimbs()[0]);
         break;
       default:
         throw runtime_error("Неподдерживаемая операция!");
     }
+    result.value = value.toString();
     result.success = true;
   } catch (const exception& e) {
     result.success = false;
@@ -86,4 +190,4 @@ CalculatorEngine::CalculationResult CalculatorEngine::calculateAdvanced(
   }
 
   return result;
-}
\ No newline at end of file
+}
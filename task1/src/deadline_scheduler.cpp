@@ -0,0 +1,152 @@
+#include "deadline_scheduler.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+
+using namespace std;
+
+DeadlineScheduler::DeadlineScheduler() {
+  // CLOCK_REALTIME: дедлайны блокировок задаются как time_t
+  timerFd = timerfd_create(CLOCK_REALTIME, TFD_CLOEXEC | TFD_NONBLOCK);
+  if (timerFd < 0) throw runtime_error("Не удалось создать timerfd");
+
+  wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (wakeFd < 0) {
+    close(timerFd);
+    throw runtime_error("Не удалось создать eventfd");
+  }
+
+  worker = thread(&DeadlineScheduler::run, this);
+}
+
+DeadlineScheduler::~DeadlineScheduler() {
+  {
+    lock_guard<mutex> lock(mtx);
+    stopping = true;
+  }
+  wakeWorker();
+  if (worker.joinable()) worker.join();
+  close(timerFd);
+  close(wakeFd);
+}
+
+uint64_t DeadlineScheduler::schedule(TimePoint deadline, Callback callback) {
+  uint64_t id;
+  bool earliest;
+  {
+    lock_guard<mutex> lock(mtx);
+    if (stopping) return 0;
+    id = nextId++;
+    earliest = deadlines.empty() || deadline < deadlines.top().deadline;
+    deadlines.push({deadline, id});
+    callbacks[id] = std::move(callback);
+  }
+  // Перевзводить таймер нужно только если новый дедлайн стал ближайшим
+  if (earliest) wakeWorker();
+  return id;
+}
+
+bool DeadlineScheduler::cancel(uint64_t id) {
+  lock_guard<mutex> lock(mtx);
+  // Запись в куче удаляется лениво при следующем взводе таймера
+  return callbacks.erase(id) > 0;
+}
+
+void DeadlineScheduler::waitUntil(TimePoint deadline) {
+  if (deadline <= Clock::now()) return;
+
+  mutex waitMutex;
+  condition_variable cv;
+  bool fired = false;
+
+  uint64_t id = schedule(deadline, [&]() {
+    lock_guard<mutex> lock(waitMutex);
+    fired = true;
+    cv.notify_one();
+  });
+  if (id == 0) return;
+
+  unique_lock<mutex> lock(waitMutex);
+  cv.wait(lock, [&]() { return fired; });
+}
+
+size_t DeadlineScheduler::pendingCount() {
+  lock_guard<mutex> lock(mtx);
+  return callbacks.size();
+}
+
+void DeadlineScheduler::armTimer() {
+  // Пропускаем отменённые задачи на вершине кучи
+  while (!deadlines.empty() &&
+         callbacks.find(deadlines.top().id) == callbacks.end()) {
+    deadlines.pop();
+  }
+
+  itimerspec spec = {};
+  if (!deadlines.empty()) {
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(
+                  deadlines.top().deadline.time_since_epoch())
+                  .count();
+    if (ns <= 0) ns = 1;  // Нулевое значение означает отключение таймера
+    spec.it_value.tv_sec = ns / 1000000000;
+    spec.it_value.tv_nsec = ns % 1000000000;
+  }
+  timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+void DeadlineScheduler::wakeWorker() {
+  uint64_t one = 1;
+  ssize_t written = write(wakeFd, &one, sizeof(one));
+  (void)written;
+}
+
+void DeadlineScheduler::run() {
+  while (true) {
+    vector<Callback> due;
+    {
+      lock_guard<mutex> lock(mtx);
+      if (stopping) break;
+
+      TimePoint now = Clock::now();
+      while (!deadlines.empty() && deadlines.top().deadline <= now) {
+        auto it = callbacks.find(deadlines.top().id);
+        deadlines.pop();
+        if (it != callbacks.end()) {
+          due.push_back(std::move(it->second));
+          callbacks.erase(it);
+        }
+      }
+      armTimer();
+    }
+
+    // Обратные вызовы выполняются без удержания мьютекса
+    for (auto& callback : due) callback();
+
+    pollfd fds[2] = {{timerFd, POLLIN, 0}, {wakeFd, POLLIN, 0}};
+    if (poll(fds, 2, -1) < 0 && errno != EINTR) break;
+
+    // Сбрасываем счётчики дескрипторов (оба неблокирующие)
+    uint64_t counter;
+    if (read(timerFd, &counter, sizeof(counter)) < 0) counter = 0;
+    if (read(wakeFd, &counter, sizeof(counter)) < 0) counter = 0;
+  }
+  drainOnExit();
+}
+
+void DeadlineScheduler::drainOnExit() {
+  vector<Callback> pending;
+  {
+    lock_guard<mutex> lock(mtx);
+    // Новые задачи больше не принимаются: их некому будет выполнить
+    stopping = true;
+    for (auto& entry : callbacks) pending.push_back(std::move(entry.second));
+    callbacks.clear();
+    deadlines = {};
+  }
+  for (auto& callback : pending) callback();
+}
@@ -0,0 +1,524 @@
+#include "expression_engine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+
+using namespace std;
+
+namespace {
+
+// Символ операции в терминах CalculatorEngine::requiredRole
+char operationSymbol(ExprOpcode opcode) {
+  switch (opcode) {
+    case ExprOpcode::ADD:
+      return '+';
+    case ExprOpcode::SUB:
+    case ExprOpcode::NEG:
+      return '-';
+    case ExprOpcode::MUL:
+      return '*';
+    case ExprOpcode::DIV:
+      return '/';
+    case ExprOpcode::POW:
+      return '^';
+    case ExprOpcode::SQRT:
+      return 's';
+    case ExprOpcode::LOG:
+      return 'l';
+    case ExprOpcode::FACT:
+      return '!';
+    default:
+      return 0;
+  }
+}
+
+// Вычисление одной операции ядром из CalculatorOperations; nullptr — успех,
+// иначе текст ошибки. Используется и интерпретатором, и свёрткой констант.
+const char* apply(ExprOpcode opcode, double a, double b, double& result) {
+  if (opcode == ExprOpcode::NEG) {
+    result = -a;
+    return nullptr;
+  }
+  CalcOutcome outcome =
+      CalculatorOperations::dispatch(operationSymbol(opcode), a, b);
+  if (!outcome) return calcErrorMessage(outcome.error());
+  result = *outcome;
+  return nullptr;
+}
+
+const char* operationName(ExprOpcode opcode) {
+  switch (opcode) {
+    case ExprOpcode::POW:
+      return "возведение в степень";
+    case ExprOpcode::SQRT:
+      return "квадратный корень";
+    case ExprOpcode::LOG:
+      return "логарифм";
+    case ExprOpcode::FACT:
+      return "факториал";
+    default:
+      return "операция";
+  }
+}
+
+// Узел дерева разбора; дети — индексы в общем векторе узлов
+struct Node {
+  enum Kind { CONSTANT, VARIABLE, OPERATION } kind;
+  ExprOpcode opcode;
+  double value;
+  uint16_t slot;
+  uint16_t height;  // Высота поддерева
+  int left;
+  int right;
+};
+
+class Parser {
+ public:
+  Parser(const string& text, Role sessionRole, ExpressionEngine& owner)
+      : source(text), role(sessionRole), engine(owner) {}
+
+  bool parse(shared_ptr<const CompiledExpression>& result, string& error) {
+    int assignSlot = -1;
+
+    // Присваивание: имя '=' выражение
+    size_t save = position;
+    string name;
+    if (readIdentifier(name)) {
+      skipSpaces();
+      if (position < source.size() && source[position] == '=') {
+        position++;
+        if (isFunction(name)) {
+          return fail("нельзя присвоить значение функции " + name, error);
+        }
+        uint16_t slot;
+        if (!engine.variableSlot(name, slot)) {
+          return fail("слишком много переменных", error);
+        }
+        assignSlot = slot;
+      } else {
+        position = save;
+      }
+    } else {
+      position = save;
+    }
+
+    int root = parseSum();
+    if (root < 0) {
+      error = message;
+      return false;
+    }
+    skipSpaces();
+    if (position != source.size()) {
+      return fail("неожиданный символ '" + string(1, source[position]) + "'",
+                  error);
+    }
+
+    auto program = make_shared<CompiledExpression>();
+    if (!emit(root, 0, *program)) {
+      error = message;
+      return false;
+    }
+    if (assignSlot >= 0) {
+      program->code.push_back(instruction(ExprOpcode::STORE_VAR, 0, assignSlot));
+    }
+    program->code.push_back({ExprOpcode::RETURN, 0, 0, 0});
+    result = program;
+    return true;
+  }
+
+ private:
+  const string& source;
+  Role role;
+  ExpressionEngine& engine;
+  size_t position = 0;
+  size_t depth = 0;
+  vector<Node> nodes;
+  string message;
+
+  bool fail(const string& text, string& error) {
+    error = text;
+    return false;
+  }
+
+  int failAt(const string& text) {
+    if (message.empty()) {
+      message = text + " (позиция " + to_string(position + 1) + ")";
+    }
+    return -1;
+  }
+
+  static bool isFunction(const string& name) {
+    return name == "sqrt" || name == "log" || name == "ln" || name == "fact" ||
+           name == "pow";
+  }
+
+  static ExprInstruction instruction(ExprOpcode opcode, uint8_t dst,
+                                     uint16_t index) {
+    return {opcode, dst, static_cast<uint8_t>(index & 0xFF),
+            static_cast<uint8_t>(index >> 8)};
+  }
+
+  void skipSpaces() {
+    while (position < source.size() &&
+           isspace(static_cast<unsigned char>(source[position]))) {
+      position++;
+    }
+  }
+
+  bool match(char c) {
+    skipSpaces();
+    if (position < source.size() && source[position] == c) {
+      position++;
+      return true;
+    }
+    return false;
+  }
+
+  bool readIdentifier(string& name) {
+    skipSpaces();
+    size_t begin = position;
+    if (position >= source.size() ||
+        !(isalpha(static_cast<unsigned char>(source[position])) ||
+          source[position] == '_')) {
+      return false;
+    }
+    while (position < source.size() &&
+           (isalnum(static_cast<unsigned char>(source[position])) ||
+            source[position] == '_')) {
+      position++;
+    }
+    name = source.substr(begin, position - begin);
+    return true;
+  }
+
+  int constant(double value) {
+    nodes.push_back(
+        {Node::CONSTANT, ExprOpcode::LOAD_CONST, value, 0, 1, -1, -1});
+    return static_cast<int>(nodes.size()) - 1;
+  }
+
+  // Разбор вложенной конструкции с учётом предела вложенности
+  template <typename Parse>
+  int nested(Parse parse) {
+    if (depth >= ExpressionEngine::MAX_NESTING) {
+      return failAt("слишком глубокая вложенность");
+    }
+    depth++;
+    int result = parse();
+    depth--;
+    return result;
+  }
+
+  // Узел операции: права проверяются до свёртки, поэтому свёртка констант
+  // не позволяет обойти ограничения роли
+  int operation(ExprOpcode opcode, int left, int right = -1) {
+    if (left < 0 || (right < 0 && opcode != ExprOpcode::NEG &&
+                     opcode != ExprOpcode::SQRT && opcode != ExprOpcode::LOG &&
+                     opcode != ExprOpcode::FACT)) {
+      return -1;
+    }
+    Role required = CalculatorEngine::requiredRole(operationSymbol(opcode));
+    if (static_cast<int>(role) < static_cast<int>(required)) {
+      return failAt(string("недостаточно прав: ") + operationName(opcode) +
+                    " требует роли " + getRoleName(required));
+    }
+
+    const Node& a = nodes[left];
+    bool foldable = a.kind == Node::CONSTANT &&
+                    (right < 0 || nodes[right].kind == Node::CONSTANT);
+    if (foldable) {
+      double folded;
+      // Ошибочные подвыражения (1/0) не сворачиваются: ошибка будет
+      // сообщена при выполнении, как для любого другого выражения
+      if (!apply(opcode, a.value, right < 0 ? 0 : nodes[right].value, folded)) {
+        return constant(folded);
+      }
+    }
+    size_t height =
+        1 + max(a.height, right < 0 ? uint16_t(0) : nodes[right].height);
+    if (height > ExpressionEngine::MAX_TREE_HEIGHT) {
+      return failAt("слишком длинное выражение");
+    }
+    nodes.push_back({Node::OPERATION, opcode, 0, 0,
+                     static_cast<uint16_t>(height), left, right});
+    return static_cast<int>(nodes.size()) - 1;
+  }
+
+  int parseSum() {
+    int left = parseProduct();
+    while (left >= 0) {
+      if (match('+')) {
+        left = operation(ExprOpcode::ADD, left, parseProduct());
+      } else if (match('-')) {
+        left = operation(ExprOpcode::SUB, left, parseProduct());
+      } else {
+        break;
+      }
+    }
+    return left;
+  }
+
+  int parseProduct() {
+    int left = parseUnary();
+    while (left >= 0) {
+      if (match('*')) {
+        left = operation(ExprOpcode::MUL, left, parseUnary());
+      } else if (match('/')) {
+        left = operation(ExprOpcode::DIV, left, parseUnary());
+      } else {
+        break;
+      }
+    }
+    return left;
+  }
+
+  int parseUnary() {
+    if (match('-')) {
+      return operation(ExprOpcode::NEG, nested([&] { return parseUnary(); }));
+    }
+    if (match('+')) return nested([&] { return parseUnary(); });
+    return parsePower();
+  }
+
+  int parsePower() {
+    int base = parsePostfix();
+    if (base >= 0 && match('^')) {
+      return operation(ExprOpcode::POW, base,
+                       nested([&] { return parseUnary(); }));
+    }
+    return base;
+  }
+
+  int parsePostfix() {
+    int value = parsePrimary();
+    while (value >= 0 && match('!')) {
+      value = operation(ExprOpcode::FACT, value);
+    }
+    return value;
+  }
+
+  int parsePrimary() {
+    skipSpaces();
+    if (position >= source.size()) return failAt("неожиданный конец выражения");
+
+    char c = source[position];
+    if (isdigit(static_cast<unsigned char>(c)) || c == '.') {
+      double value;
+      auto [end, ec] = from_chars(source.data() + position,
+                                  source.data() + source.size(), value);
+      if (ec != errc()) return failAt("некорректное число");
+      position = end - source.data();
+      return constant(value);
+    }
+
+    if (match('(')) {
+      int inner = nested([&] { return parseSum(); });
+      if (inner >= 0 && !match(')')) return failAt("ожидалась ')'");
+      return inner;
+    }
+
+    string name;
+    if (!readIdentifier(name)) {
+      return failAt("неожиданный символ '" + string(1, c) + "'");
+    }
+
+    if (!isFunction(name)) {
+      uint16_t slot;
+      if (!engine.variableSlot(name, slot)) {
+        return failAt("слишком много переменных");
+      }
+      nodes.push_back(
+          {Node::VARIABLE, ExprOpcode::LOAD_VAR, 0, slot, 1, -1, -1});
+      return static_cast<int>(nodes.size()) - 1;
+    }
+
+    if (!match('(')) return failAt("ожидалась '(' после " + name);
+    int first = nested([&] { return parseSum(); });
+    int second = -1;
+    if (first >= 0 && name == "pow") {
+      if (!match(',')) return failAt("pow принимает два аргумента");
+      second = nested([&] { return parseSum(); });
+      if (second < 0) return -1;
+    }
+    if (first >= 0 && !match(')')) return failAt("ожидалась ')'");
+    if (first < 0) return -1;
+
+    if (name == "sqrt") return operation(ExprOpcode::SQRT, first);
+    if (name == "log" || name == "ln") return operation(ExprOpcode::LOG, first);
+    if (name == "fact") return operation(ExprOpcode::FACT, first);
+    return operation(ExprOpcode::POW, first, second);
+  }
+
+  // Регистр результата узла — dst; операнды считаются в dst и dst + 1,
+  // так что число регистров равно глубине дерева
+  bool emit(int index, size_t dst, CompiledExpression& program) {
+    if (dst >= ExpressionEngine::MAX_REGISTERS) {
+      message = "слишком сложное выражение";
+      return false;
+    }
+    program.registerCount =
+        max<uint16_t>(program.registerCount, static_cast<uint16_t>(dst + 1));
+    const Node& node = nodes[index];
+    uint8_t reg = static_cast<uint8_t>(dst);
+
+    switch (node.kind) {
+      case Node::CONSTANT:
+        if (program.constants.size() > 0xFFFF) {
+          message = "слишком много констант";
+          return false;
+        }
+        program.code.push_back(instruction(
+            ExprOpcode::LOAD_CONST, reg,
+            static_cast<uint16_t>(program.constants.size())));
+        program.constants.push_back(node.value);
+        return true;
+      case Node::VARIABLE:
+        program.code.push_back(instruction(ExprOpcode::LOAD_VAR, reg, node.slot));
+        return true;
+      case Node::OPERATION:
+        break;
+    }
+
+    if (!emit(node.left, dst, program)) return false;
+    if (node.right < 0) {
+      program.code.push_back({node.opcode, reg, reg, 0});
+      return true;
+    }
+    if (!emit(node.right, dst + 1, program)) return false;
+    program.code.push_back(
+        {node.opcode, reg, reg, static_cast<uint8_t>(dst + 1)});
+    return true;
+  }
+};
+
+}  // namespace
+
+ExpressionEngine::ExpressionEngine(Role sessionRole, size_t cacheCapacity)
+    : role(sessionRole), capacity(cacheCapacity) {
+  variableSlot("ans", ansSlot);
+}
+
+bool ExpressionEngine::variableSlot(const string& name, uint16_t& slot) {
+  auto it = variableSlots.find(name);
+  if (it != variableSlots.end()) {
+    slot = it->second;
+    return true;
+  }
+  if (variableNames.size() >= MAX_VARIABLES) return false;
+
+  slot = static_cast<uint16_t>(variableNames.size());
+  variableSlots[name] = slot;
+  variableNames.push_back(name);
+  variableValues.push_back(0);
+  variableDefined.push_back(0);
+  return true;
+}
+
+void ExpressionEngine::dropVariables(size_t count) {
+  while (variableNames.size() > count) {
+    variableSlots.erase(variableNames.back());
+    variableNames.pop_back();
+    variableValues.pop_back();
+    variableDefined.pop_back();
+  }
+}
+
+bool ExpressionEngine::setVariable(const string& name, double value) {
+  uint16_t slot;
+  if (!variableSlot(name, slot)) return false;
+  variableValues[slot] = value;
+  variableDefined[slot] = 1;
+  return true;
+}
+
+bool ExpressionEngine::getVariable(const string& name, double& value) const {
+  auto it = variableSlots.find(name);
+  if (it == variableSlots.end() || !variableDefined[it->second]) return false;
+  value = variableValues[it->second];
+  return true;
+}
+
+shared_ptr<const CompiledExpression> ExpressionEngine::compile(
+    const string& source, string& error) {
+  auto cached = cacheIndex.find(source);
+  if (cached != cacheIndex.end()) {
+    cacheHits++;
+    lru.splice(lru.begin(), lru, cached->second);
+    return cached->second->second;
+  }
+  cacheMisses++;
+
+  // Переменные, упомянутые в ошибочном выражении, не должны занимать
+  // слоты: ни одна скомпилированная программа на них не ссылается
+  size_t variableCount = variableNames.size();
+  shared_ptr<const CompiledExpression> program;
+  Parser parser(source, role, *this);
+  if (!parser.parse(program, error)) {
+    dropVariables(variableCount);
+    return nullptr;
+  }
+
+  if (capacity > 0) {
+    lru.emplace_front(source, program);
+    cacheIndex[source] = lru.begin();
+    if (cacheIndex.size() > capacity) {
+      cacheIndex.erase(lru.back().first);
+      lru.pop_back();
+    }
+  }
+  return program;
+}
+
+ExpressionEngine::CalculationResult ExpressionEngine::execute(
+    const CompiledExpression& program) {
+  double registers[MAX_REGISTERS];
+
+  for (const ExprInstruction& in : program.code) {
+    switch (in.opcode) {
+      case ExprOpcode::LOAD_CONST:
+        registers[in.dst] = program.constants[in.index()];
+        break;
+      case ExprOpcode::LOAD_VAR:
+        if (!variableDefined[in.index()]) {
+          return {false, 0,
+                  "Переменная '" + variableNames[in.index()] +
+                      "' не определена!"};
+        }
+        registers[in.dst] = variableValues[in.index()];
+        break;
+      case ExprOpcode::STORE_VAR:
+        variableValues[in.index()] = registers[in.dst];
+        variableDefined[in.index()] = 1;
+        break;
+      case ExprOpcode::ADD:
+        registers[in.dst] = registers[in.a] + registers[in.b];
+        break;
+      case ExprOpcode::SUB:
+        registers[in.dst] = registers[in.a] - registers[in.b];
+        break;
+      case ExprOpcode::MUL:
+        registers[in.dst] = registers[in.a] * registers[in.b];
+        break;
+      case ExprOpcode::RETURN:
+        variableValues[ansSlot] = registers[in.dst];
+        variableDefined[ansSlot] = 1;
+        return {true, registers[in.dst], ""};
+      default: {
+        const char* error = apply(in.opcode, registers[in.a],
+                                  registers[in.b], registers[in.dst]);
+        if (error) return {false, 0, error};
+      }
+    }
+  }
+  return {false, 0, "Некорректный байт-код"};
+}
+
+ExpressionEngine::CalculationResult ExpressionEngine::evaluate(
+    const string& source) {
+  string error;
+  shared_ptr<const CompiledExpression> program = compile(source, error);
+  if (!program) return {false, 0, "Ошибка в выражении: " + error};
+  return execute(*program);
+}
@@ -1,26 +1,228 @@
+#include <fcntl.h>
 #include <locale.h>
+#include <unistd.h>
 
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "auth_manager.h"
+#include "batch_processor.h"
 #include "calculator_engine.h"
 #include "database.h"
 #include "hash_generator.h"
 #include "input_validator.h"
 #include "menu_manager.h"
+#include "metrics.h"
+#include "parallel_batch.h"
 #include "password_policy.h"
+#include "policy_watcher.h"
 #include "security_logger.h"
+#include "session_manager.h"
+#include "session_recorder.h"
+#include "shared_attempt_table.h"
+#include "trace.h"
 
 using namespace std;
 
-int main() {
+namespace {
+
+// Вход для пакетного режима без диалога: логин и пароль из переменных
+// окружения. Если их нет, а операции читаются из файла, stdin свободен
+// и используется обычный интерактивный вход.
+UserSession authenticateBatch(AuthManager& authManager,
+                              SecurityLogger& securityLogger,
+                              const string& batchFile) {
+  const char* login = getenv("SECURE_CALC_LOGIN");
+  const char* password = getenv("SECURE_CALC_PASSWORD");
+  if (login && password) {
+    LoginResult result =
+        authManager.attemptLogin(login, password, "127.0.0.1");
+    if (result.status == LoginStatus::SUCCESS) return result.session;
+    cerr << "Пакетный режим: вход не выполнен." << endl;
+    return {};
+  }
+  if (!batchFile.empty()) return authManager.authenticate();
+
+  cerr << "Пакетный режим со stdin требует --token или переменных "
+          "SECURE_CALC_LOGIN и SECURE_CALC_PASSWORD."
+       << endl;
+  securityLogger.logSecurityEvent("Batch login refused", "no credentials");
+  return {};
+}
+
+void printPipelineStats(const PipelineStats& stats) {
+  cerr << "Фрагментов: " << stats.chunks << ", перехвачено: " << stats.steals
+       << ", наибольшая очередь вывода: " << stats.maxBuffered << endl;
+  cerr << "Стадии, с: разбиение " << stats.splitSeconds << ", ожидание чтения "
+       << stats.readerWaitSeconds << ", вычисление (сумма по потокам) "
+       << stats.evaluateSeconds << ", запись " << stats.writeSeconds
+       << ", ожидание записи " << stats.writerWaitSeconds << endl;
+}
+
+// threads > 0 включает параллельный конвейер; он отображает файл в память,
+// поэтому stdin всегда обрабатывается последовательно
+int runBatch(CalculatorEngine& calculatorEngine, SecurityLogger& securityLogger,
+             const UserSession& session, const string& batchFile,
+             unsigned threads) {
+  TRACE_FUNCTION();
+  bool parallel = threads > 0 && !batchFile.empty();
+  int inputFd = STDIN_FILENO;
+  if (!batchFile.empty() && !parallel) {
+    inputFd = open(batchFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (inputFd < 0) {
+      cerr << "Не удалось открыть " << batchFile << ": " << strerror(errno)
+           << endl;
+      return 1;
+    }
+  }
+  securityLogger.logSecurityEvent(
+      "Batch started",
+      "user=" + session.username +
+          " input=" + (batchFile.empty() ? "stdin" : batchFile) +
+          (parallel ? " threads=" + to_string(threads) : ""));
+
+  BatchProcessor processor(calculatorEngine, session.role);
+  BatchStats stats;
+  PipelineStats pipelineStats;
+  string error;
+  auto start = chrono::steady_clock::now();
+  bool ok;
+  if (parallel) {
+    ParallelBatchPipeline pipeline(processor, threads);
+    ok = pipeline.run(batchFile, STDOUT_FILENO, pipelineStats, error);
+    stats = pipelineStats.totals;
+  } else {
+    ok = processor.run(inputFd, STDOUT_FILENO, stats, error);
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  if (inputFd != STDIN_FILENO) close(inputFd);
+
+  if (!ok) cerr << error << endl;
+  cerr << "Операций: " << stats.lines << ", ошибок: " << stats.errors
+       << ", время: " << seconds << " с ("
+       << (seconds > 0 ? stats.lines / seconds / 1e6 : 0) << " млн/с)"
+       << endl;
+  if (parallel) printPipelineStats(pipelineStats);
+  securityLogger.logSecurityEvent(
+      ok ? "Batch finished" : "Batch failed",
+      "user=" + session.username + " operations=" + to_string(stats.lines) +
+          " errors=" + to_string(stats.errors));
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
   setlocale(LC_ALL, "Russian");
 
+  // Токен из прошлой сессии позволяет пропустить проверку пароля.
+  // --cache-mb задаёт память кэша целочисленного режима (0 — без кэша),
+  // --cache-per-user разделяет кэш между пользователями.
+  // --batch [файл] — пакетный режим: операции из файла или stdin;
+  // --threads N — файл вычисляется N потоками с выводом в исходном порядке.
+  // --history-size N и --history-file путь — размер истории вычислений
+  // сессии и файл, куда она выгружается при выходе (.csv или двоичный).
+  // --metrics-file путь [--metrics-interval с] — метрики в формате
+  // Prometheus для textfile-коллектора node_exporter.
+  // --record путь — записать ввод сеанса с отметками времени;
+  // --replay путь [--replay-paced] — взять ввод из записи вместо stdin,
+  // с полной скоростью или с исходными паузами.
+  // --trace путь — интервалы запуска и входа в формате Chrome trace event;
+  // файл пишется при выходе и по сигналу SIGUSR1.
+  string resumeToken;
+  ResultCacheConfig cacheConfig;
+  bool batchMode = false;
+  string batchFile;
+  unsigned batchThreads = 0;
+  size_t historySize = CalculationHistory::DEFAULT_CAPACITY;
+  string historyFile;
+  string metricsFile;
+  unsigned metricsInterval = 15;
+  string traceFile;
+  string recordFile;
+  string replayFile;
+  bool replayPaced = false;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--token") == 0 && i + 1 < argc) {
+      resumeToken = argv[++i];
+    } else if (strcmp(argv[i], "--cache-mb") == 0 && i + 1 < argc) {
+      cacheConfig.memoryBudget = strtoull(argv[++i], nullptr, 10) << 20;
+    } else if (strcmp(argv[i], "--cache-per-user") == 0) {
+      cacheConfig.isolateUsers = true;
+    } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+      batchThreads = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+    } else if (strcmp(argv[i], "--history-size") == 0 && i + 1 < argc) {
+      historySize = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--history-file") == 0 && i + 1 < argc) {
+      historyFile = argv[++i];
+    } else if (strcmp(argv[i], "--metrics-file") == 0 && i + 1 < argc) {
+      metricsFile = argv[++i];
+    } else if (strcmp(argv[i], "--metrics-interval") == 0 && i + 1 < argc) {
+      metricsInterval = static_cast<unsigned>(strtoul(argv[++i], nullptr, 10));
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordFile = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replayFile = argv[++i];
+    } else if (strcmp(argv[i], "--replay-paced") == 0) {
+      replayPaced = true;
+    } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+      traceFile = argv[++i];
+    } else if (strcmp(argv[i], "--batch") == 0) {
+      batchMode = true;
+      if (i + 1 < argc && strncmp(argv[i + 1], "--", 2) != 0) {
+        batchFile = argv[++i];
+      }
+    }
+  }
+
+  if (!traceFile.empty()) {
+    string traceError;
+    if (!Tracer::start(traceFile, traceError)) {
+      cerr << "Трассировка отключена: " << traceError << endl;
+    }
+  }
+
+  // Операции пакетного режима из stdin читаются в обход cin и не попали бы
+  // в запись, а при воспроизведении взялись бы с настоящего stdin
+  if (batchMode && batchFile.empty() &&
+      (!recordFile.empty() || !replayFile.empty())) {
+    cerr << "--record и --replay в пакетном режиме требуют файл операций"
+         << endl;
+    return 1;
+  }
+
+  // Буфер cin подменяется до первого чтения ввода
+  SessionRecorder sessionRecorder;
+  SessionReplayer sessionReplayer;
+  string sessionError;
+  if (!replayFile.empty()) {
+    if (!sessionReplayer.open(replayFile, replayPaced, sessionError)) {
+      cerr << sessionError << endl;
+      return 1;
+    }
+    cin.rdbuf(&sessionReplayer);
+  } else if (!recordFile.empty()) {
+    if (!sessionRecorder.open(recordFile, sessionError)) {
+      cerr << sessionError << endl;
+      return 1;
+    }
+    cin.rdbuf(&sessionRecorder);
+  }
+
+  // В пакетном режиме stdout занят результатами: сообщения — в stderr
+  if (batchMode) cout.rdbuf(cerr.rdbuf());
+
   cout << "=========================================" << endl;
   cout << "    БЕЗОПАСНЫЙ КАЛЬКУЛЯТОР" << endl;
   cout << "=========================================" << endl;
 
   // Инициализация компонентов
+  SharedAttemptTable sharedAttempts;
   UserDatabase userDB;
   SecurityLogger securityLogger;
   PasswordPolicy passwordPolicy;
@@ -28,11 +230,67 @@ int main() {
   CalculatorEngine calculatorEngine;
   MenuManager menuManager(userDB, securityLogger, passwordPolicy, authManager,
                           calculatorEngine);
+  menuManager.configureHistory(historySize, historyFile);
+
+  // Последний снимок метрик пишется при разрушении, то есть при выходе из main
+  unique_ptr<MetricsExporter> metricsExporter;
+  if (!metricsFile.empty()) {
+    metricsExporter =
+        make_unique<MetricsExporter>(metrics(), metricsFile, metricsInterval);
+  }
 
   // Логируем запуск приложения
   securityLogger.logSecurityEvent("Application started",
                                   "Modular Secure Calculator v2.0");
 
+  // Без общей таблицы параллельные процессы умножают число попыток входа,
+  // поэтому без неё программа не работает
+  string sharedError;
+  if (!sharedAttempts.open(SharedAttemptTable::nameFor(userDB.getFilename()),
+                           SharedAttemptTable::DEFAULT_CAPACITY,
+                           sharedError)) {
+    cerr << "Критическая ошибка: общие счётчики попыток недоступны: "
+         << sharedError << endl;
+    securityLogger.logSecurityEvent("Shared attempt table unavailable",
+                                    sharedError);
+    return 1;
+  }
+  authManager.attachSharedAttempts(&sharedAttempts);
+
+  // Файл политики задаёт все параметры сразу и перечитывается при изменении.
+  // Без него действуют встроенные требования и словари по умолчанию.
+  const string policyFile = "../password_policy.conf";
+  string policyError;
+  if (passwordPolicy.loadPolicyFile(policyFile, policyError)) {
+    securityLogger.logSecurityEvent("Password policy loaded", policyFile);
+  } else {
+    if (access(policyFile.c_str(), F_OK) == 0) {
+      cerr << "Ошибка в файле политики: " << policyError << endl;
+      securityLogger.logSecurityEvent("Password policy rejected", policyError);
+    }
+
+    // Словарь утёкших паролей необязателен: без него проверка пропускается
+    string filterError;
+    if (passwordPolicy.loadBreachFilter("../breached_passwords.bin",
+                                        filterError)) {
+      securityLogger.logSecurityEvent("Breach filter loaded",
+                                      "../breached_passwords.bin");
+    }
+
+    if (passwordPolicy.loadBannedFragments("../banned_fragments.txt",
+                                           filterError)) {
+      securityLogger.logSecurityEvent("Banned fragments loaded",
+                                      "../banned_fragments.txt");
+    }
+  }
+
+  PolicyWatcher policyWatcher(
+      passwordPolicy, policyFile, [&](bool ok, const string& message) {
+        securityLogger.logSecurityEvent(
+            ok ? "Password policy reloaded" : "Password policy reload failed",
+            message);
+      });
+
   // Загрузка базы данных
   if (!userDB.loadUsers()) {
     cerr << "Критическая ошибка: Не удалось загрузить базу пользователей!"
@@ -41,9 +299,45 @@ int main() {
                                     "Failed to load user database");
     return 1;
   }
+  TRACE_SINCE_START("startup");
+
+  SessionManager sessionManager(userDB);
+
+  if (cacheConfig.memoryBudget > 0) {
+    calculatorEngine.enableResultCache(cacheConfig);
+  }
 
   // Аутентификация пользователя
-  UserSession session = authManager.authenticate();
+  UserSession session;
+  if (!resumeToken.empty() &&
+      sessionManager.validateToken(resumeToken, session)) {
+    cout << "Сессия восстановлена по токену. Добро пожаловать, "
+         << session.username << "!" << endl;
+    securityLogger.logSecurityEvent("Session resumed",
+                                    "user=" + session.username);
+    menuManager.attachSessionToken(sessionManager, resumeToken);
+  } else {
+    if (!resumeToken.empty()) {
+      cout << "Токен недействителен или истёк." << endl;
+      securityLogger.logSecurityEvent("Invalid session token", "");
+    }
+    if (batchMode) {
+      session = authenticateBatch(authManager, securityLogger, batchFile);
+    } else {
+      session = authManager.authenticate();
+      if (!session.username.empty()) {
+        string token = sessionManager.issueToken(session);
+        cout << "Токен сессии (действует " << SessionManager::DEFAULT_LIFETIME
+             << " секунд): " << token << endl;
+        menuManager.attachSessionToken(sessionManager, token);
+      }
+    }
+  }
+
+  if (batchMode && !session.username.empty()) {
+    return runBatch(calculatorEngine, securityLogger, session, batchFile,
+                    batchThreads);
+  }
 
   if (!session.username.empty()) {
     menuManager.showUserMenu(session);
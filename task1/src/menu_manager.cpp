@@ -1,12 +1,16 @@
 #include "menu_manager.h"
 
+#include <cmath>
+#include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "database.h"
 #include "input_validator.h"
+#include "metrics.h"
 
 using namespace std;
 
@@ -28,6 +32,48 @@ string getRoleName(Role role) {
   }
 }
 
+namespace {
+
+// "#3 [12:30:01] 2 + 3 = 5"
+string describeRecord(const HistoryRecord& record) {
+  ostringstream text;
+  time_t timestamp = static_cast<time_t>(record.timestamp);
+  tm local{};
+  localtime_r(&timestamp, &local);
+  text << "#" << record.sequence << " [" << put_time(&local, "%H:%M:%S")
+       << "] ";
+
+  if (record.arity == 2) {
+    text << record.operand1 << " " << record.operation << " "
+         << record.operand2;
+  } else if (record.arity == 1) {
+    switch (record.operation) {
+      case '!':
+        text << record.operand1 << "!";
+        break;
+      case 's':
+        text << "√" << record.operand1;
+        break;
+      case 'l':
+        text << "ln(" << record.operand1 << ")";
+        break;
+      default:
+        text << record.operation << "(" << record.operand1 << ")";
+    }
+  } else {
+    text << "выражение";
+  }
+
+  if (record.status == HISTORY_OK) {
+    text << " = " << record.result;
+  } else {
+    text << ": ОШИБКА: " << historyStatusMessage(record.status);
+  }
+  return text.str();
+}
+
+}  // namespace
+
 MenuManager::MenuManager(UserDatabase& db, SecurityLogger& logger,
                          PasswordPolicy& policy, AuthManager& auth,
                          CalculatorEngine& calc)
@@ -35,13 +81,23 @@ MenuManager::MenuManager(UserDatabase& db, SecurityLogger& logger,
       securityLogger(logger),
       passwordPolicy(policy),
       authManager(auth),
-      calculatorEngine(calc) {}
+      calculatorEngine(calc),
+      history(make_unique<CalculationHistory>()) {}
+
+void MenuManager::configureHistory(size_t capacity, const string& exportPath) {
+  history = make_unique<CalculationHistory>(capacity);
+  historyExportPath = exportPath;
+}
+
+void MenuManager::attachSessionToken(SessionManager& manager,
+                                     const string& token) {
+  sessionManager = &manager;
+  sessionToken = token;
+}
 
 bool MenuManager::validatePermission(const UserSession& session,
                                      char operation) {
-  if ((operation == '!' && !hasPermission(session.role, Role::USER)) ||
-      ((operation == '^' || operation == 's' || operation == 'l') &&
-       !hasPermission(session.role, Role::ADMIN))) {
+  if (!hasPermission(session.role, CalculatorEngine::requiredRole(operation))) {
     cout << "ОШИБКА: Недостаточно прав для выполнения этой операции!" << endl;
     return false;
   }
@@ -55,21 +111,15 @@ void MenuManager::displayCalculatorMenu(const UserSession& session) {
   cout << string(50, '=') << endl;
 
   cout << "Поддерживаемые операции:" << endl;
-  cout << "  +  - Сложение" << endl;
-  cout << "  -  - Вычитание" << endl;
-  cout << "  *  - Умножение" << endl;
-  cout << "  /  - Деление" << endl;
-
-  if (hasPermission(session.role, Role::USER)) {
-    cout << "  !  - Факториал (только целые числа)" << endl;
-  }
-
-  if (hasPermission(session.role, Role::ADMIN)) {
-    cout << "  ^  - Возведение в степень" << endl;
-    cout << "  s  - Квадратный корень" << endl;
-    cout << "  l  - Логарифм (натуральный)" << endl;
+  for (const auto& entry : CalculatorOperations::entries) {
+    if (hasPermission(session.role, entry.role)) {
+      cout << "  " << entry.symbol << "  - " << entry.label << endl;
+    }
   }
 
+  cout << "  e  - Выражение (например: x = (2 + 3) * 4, затем sqrt(x))" << endl;
+  cout << "  i  - Целые произвольной длины (например, 1000!)" << endl;
+  cout << "  h  - История вычислений и повтор по номеру" << endl;
   cout << "  q  - Выход" << endl;
   cout << string(50, '=') << endl;
 }
@@ -83,6 +133,8 @@ void MenuManager::handleBasicOperations(char op, const UserSession& session) {
   cout << "\nВычисление: " << num1 << " " << op << " " << num2 << " = ";
 
   auto result = calculatorEngine.calculate(op, num1, num2);
+  history->append(op, 2, num1, num2, result.success ? result.value : NAN,
+                  result.success ? HISTORY_OK : historyStatus(result.error));
   if (result.success) {
     cout << result.value << endl;
   } else {
@@ -100,6 +152,8 @@ void MenuManager::handleAdvancedOperations(char op,
 
     auto result =
         calculatorEngine.calculateAdvanced(op, static_cast<double>(num));
+    history->append(op, 1, num, 0, result.success ? result.value : NAN,
+                    result.success ? HISTORY_OK : historyStatus(result.error));
     if (result.success) {
       cout << result.value << endl;
     } else {
@@ -114,6 +168,8 @@ void MenuManager::handleAdvancedOperations(char op,
     cout << "\nВычисление: " << operationName << " = ";
 
     auto result = calculatorEngine.calculateAdvanced(op, num);
+    history->append(op, 1, num, 0, result.success ? result.value : NAN,
+                    result.success ? HISTORY_OK : historyStatus(result.error));
     if (result.success) {
       cout << result.value << endl;
     } else {
@@ -122,8 +178,114 @@ void MenuManager::handleAdvancedOperations(char op,
   }
 }
 
+void MenuManager::handleExpression(ExpressionEngine& expressions) {
+  string source;
+  InputValidator::clearInputBuffer();
+  cout << "Введите выражение: ";
+  getline(cin, source);
+
+  auto result = expressions.evaluate(source);
+  history->append('e', 0, 0, 0, result.success ? result.value : NAN,
+                  result.success ? HISTORY_OK : HISTORY_EXPRESSION_ERROR);
+  if (result.success) {
+    cout << "= " << result.value << endl;
+  } else {
+    cout << "ОШИБКА: " << result.errorMessage << endl;
+  }
+}
+
+void MenuManager::handleHistory(ExpressionEngine& expressions) {
+  const size_t SHOWN_RECORDS = 20;
+  if (history->size() == 0) {
+    cout << "История пуста." << endl;
+    return;
+  }
+
+  uint32_t last = history->lastSequence();
+  uint32_t first = max<uint32_t>(history->firstSequence(),
+                                 last - min<size_t>(last, SHOWN_RECORDS) + 1);
+  cout << "\nИстория (записей: " << history->size() << " из "
+       << history->getCapacity() << "):" << endl;
+  for (uint32_t sequence = first; sequence <= last; ++sequence) {
+    cout << "  " << describeRecord(*history->find(sequence)) << endl;
+  }
+
+  int sequence =
+      InputValidator::getValidatedInt("Номер записи для повтора (0 — назад): ");
+  if (sequence <= 0) return;
+  const HistoryRecord* record = history->find(static_cast<uint32_t>(sequence));
+  if (!record) {
+    cout << "Записи с таким номером нет (или она вытеснена)." << endl;
+    return;
+  }
+  cout << describeRecord(*record) << endl;
+  if (record->status == HISTORY_OK) {
+    expressions.setVariable("ans", record->result);
+    cout << "Результат доступен в выражениях как ans." << endl;
+  }
+}
+
+void MenuManager::finishSession(const UserSession& session) {
+  // Выход отзывает токен этой сессии, но не другие сессии пользователя;
+  // база сохраняется следом
+  if (sessionManager && !sessionToken.empty() &&
+      sessionManager->revokeToken(sessionToken)) {
+    securityLogger.logSecurityEvent("Session token revoked",
+                                    "user=" + session.username);
+  }
+  if (!historyExportPath.empty() && history->size() > 0) {
+    string error;
+    if (history->exportFile(historyExportPath, error)) {
+      cout << "История вычислений сохранена в " << historyExportPath << endl;
+      securityLogger.logSecurityEvent(
+          "History exported", "user=" + session.username + " records=" +
+                                  to_string(history->size()) +
+                                  " file=" + historyExportPath);
+    } else {
+      cout << "Не удалось сохранить историю: " << error << endl;
+      securityLogger.logSecurityEvent("History export failed", error);
+    }
+  }
+  history->clear();
+}
+
+void MenuManager::handleIntegerOperations(const UserSession& session) {
+  char op;
+  cout << "Операция (+ - * / % ^ !): ";
+  cin >> op;
+  if (!validatePermission(session, op)) return;
+
+  string a, b;
+  cout << (op == '!' ? "Введите целое число: " : "Введите первое число: ");
+  cin >> a;
+  if (op != '!') {
+    cout << "Введите второе число: ";
+    cin >> b;
+  }
+
+  auto result = calculatorEngine.calculateInteger(
+      op, a, b, calculatorEngine.cacheScope(session.username));
+  if (!result.success) {
+    cout << "ОШИБКА: " << result.errorMessage << endl;
+    return;
+  }
+
+  // Длинные результаты выводятся сокращённо: начало, конец и число цифр
+  const size_t MAX_PRINTED_DIGITS = 200;
+  const string& value = result.value;
+  if (value.size() <= MAX_PRINTED_DIGITS) {
+    cout << "= " << value << endl;
+  } else {
+    cout << "= " << value.substr(0, MAX_PRINTED_DIGITS / 2) << "..."
+         << value.substr(value.size() - MAX_PRINTED_DIGITS / 4) << endl;
+    cout << "(цифр: " << value.size() - (value[0] == '-') << ")" << endl;
+  }
+}
+
 void MenuManager::showCalculator(const UserSession& session) {
   char op;
+  // Переменные и скомпилированные выражения живут до выхода из калькулятора
+  ExpressionEngine expressions(session.role);
 
   while (true) {
     displayCalculatorMenu(session);
@@ -136,18 +298,25 @@ void MenuManager::showCalculator(const UserSession& session) {
     }
 
     try {
-      switch (op) {
-        case '+':
-        case '-':
-        case '*':
-        case '/':
-        case '^':
+      // Операции калькулятора — из реестра, остальное — пункты меню
+      if (const auto* entry = CalculatorOperations::find(op)) {
+        if (entry->arity == 2) {
           handleBasicOperations(op, session);
-          break;
-        case '!':
-        case 's':
-        case 'l':
+        } else {
           handleAdvancedOperations(op, session);
+        }
+        continue;
+      }
+
+      switch (op) {
+        case 'e':
+          handleExpression(expressions);
+          break;
+        case 'i':
+          handleIntegerOperations(session);
+          break;
+        case 'h':
+          handleHistory(expressions);
           break;
         default:
           throw runtime_error("Неподдерживаемая операция!");
@@ -170,9 +339,10 @@ void MenuManager::showAdminPanel(UserSession& session) {
     cout << "7. Сохранить базу данных" << endl;
     cout << "8. Показать логи безопасности" << endl;
     cout << "9. Вернуться в калькулятор" << endl;
+    cout << "10. Показать метрики" << endl;
     cout << "0. Выход" << endl;
 
-    int choice = InputValidator::getMenuChoice(0, 9);
+    int choice = InputValidator::getMenuChoice(0, 10);
     InputValidator::clearInputBuffer();
 
     switch (choice) {
@@ -190,6 +360,8 @@ void MenuManager::showAdminPanel(UserSession& session) {
           auto validation = passwordPolicy.validatePassword(password);
           if (validation.isValid) {
             passwordValid = true;
+            cout << "Оценка стойкости пароля: " << validation.score << " из 4"
+                 << endl;
           } else {
             cout << "Ошибка пароля: " << validation.message << endl;
           }
@@ -211,10 +383,11 @@ void MenuManager::showAdminPanel(UserSession& session) {
              << "Статус" << endl;
         cout << string(55, '-') << endl;
 
-        for (const auto& user : userDB.getAllUsers()) {
-          cout << left << setw(15) << user.first << setw(20)
-               << getRoleName(user.second.role) << setw(15)
-               << (user.second.isActive ? "Активен" : "Заблокирован") << endl;
+        for (const string& login : userDB.getLogins()) {
+          optional<UserInfo> user = userDB.getUser(login);
+          cout << left << setw(15) << login << setw(20)
+               << getRoleName(user->role) << setw(15)
+               << (user->isActive ? "Активен" : "Заблокирован") << endl;
         }
         break;
       }
@@ -224,7 +397,7 @@ void MenuManager::showAdminPanel(UserSession& session) {
         cout << "Введите логин пользователя: ";
         cin >> login;
 
-        UserInfo* userInfo = userDB.getUser(login);
+        optional<UserInfo> userInfo = userDB.getUser(login);
         if (userInfo) {
           cout << "Текущая роль: " << getRoleName(userInfo->role) << endl;
           cout << "Новая роль (0 - Гость, 1 - Пользователь, 2 - Админ): ";
@@ -254,8 +427,7 @@ void MenuManager::showAdminPanel(UserSession& session) {
         cout << "Введите логин пользователя: ";
         cin >> login;
 
-        UserInfo* userInfo = userDB.getUser(login);
-        if (userInfo) {
+        if (userDB.userExists(login)) {
           if (userDB.toggleUserActive(login)) {
             bool newStatus = userDB.getUser(login)->isActive;
             cout << "Пользователь " << login << " теперь "
@@ -299,6 +471,26 @@ void MenuManager::showAdminPanel(UserSession& session) {
         } else {
           cout << "Статус: АКТИВЕН" << endl;
         }
+
+        // Показывается только таблица, в которой действительно ведётся
+        // учёт: при общей таблице собственная процесса пуста
+        const SharedAttemptTable* shared = authManager.getSharedAttempts();
+        if (shared) {
+          SharedAttemptTable::Stats sharedStats = shared->getStats();
+          cout << "Общая таблица попыток (все процессы): "
+               << sharedStats.occupied << "/" << sharedStats.capacity
+               << " записей, вытеснений: " << sharedStats.evictions
+               << " (с активной блокировкой: " << sharedStats.lockedEvictions
+               << "), восстановлений после сбоя: " << sharedStats.recoveries
+               << endl;
+        } else {
+          AttemptTable::Stats stats = authManager.getAttemptTableStats();
+          cout << "Таблица попыток входа (только этот процесс): "
+               << stats.occupied << "/" << stats.capacity
+               << " записей, вытеснений: " << stats.evictions
+               << " (с активной блокировкой: " << stats.lockedEvictions << ")"
+               << endl;
+        }
         break;
       }
       case 7: {
@@ -321,8 +513,15 @@ void MenuManager::showAdminPanel(UserSession& session) {
         showCalculator(session);
         break;
       }
+      case 10: {
+        cout << "\n=== МЕТРИКИ ===" << endl;
+        cout << metrics().renderSummary();
+        securityLogger.logAdminAction(session.username, "view_metrics", "");
+        break;
+      }
       case 0: {
         cout << "Выход из системы..." << endl;
+        finishSession(session);
         if (userDB.saveUsers()) {
           cout << "Изменения сохранены." << endl;
         } else {
@@ -345,7 +544,7 @@ void MenuManager::showChangePassword(const UserSession& session) {
   cout << "Текущий пароль: ";
   cin >> currentPassword;
 
-  UserInfo* userInfo = userDB.getUser(session.username);
+  optional<UserInfo> userInfo = userDB.getUser(session.username);
   if (userInfo && SecurePasswordHasher::verifyPassword(
                       currentPassword, userInfo->passwordHash)) {
     bool passwordValid = false;
@@ -356,6 +555,8 @@ void MenuManager::showChangePassword(const UserSession& session) {
       auto validation = passwordPolicy.validatePassword(newPassword);
       if (validation.isValid) {
         passwordValid = true;
+        cout << "Оценка стойкости пароля: " << validation.score << " из 4"
+             << endl;
       } else {
         cout << "Ошибка пароля: " << validation.message << endl;
       }
@@ -365,7 +566,7 @@ void MenuManager::showChangePassword(const UserSession& session) {
     cin >> confirmPassword;
 
     if (newPassword == confirmPassword) {
-      userInfo->passwordHash = SecurePasswordHasher::hashPassword(newPassword);
+      userDB.changePassword(session.username, newPassword);
       cout << "Пароль успешно изменен!" << endl;
       securityLogger.logPasswordChange(session.username, true);
     } else {
@@ -405,11 +606,13 @@ void MenuManager::showUserMenu(UserSession& session) {
           showAdminPanel(session);
         } else {
           cout << "Выход из системы..." << endl;
+          finishSession(session);
           return;
         }
         break;
       case 4:
         cout << "Выход из системы..." << endl;
+        finishSession(session);
         return;
     }
   }
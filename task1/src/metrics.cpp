@@ -0,0 +1,206 @@
+#include "metrics.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+
+uint64_t LatencyHistogram::Snapshot::quantileNs(double q) const {
+  if (count == 0) return 0;
+  uint64_t target =
+      max<uint64_t>(1, static_cast<uint64_t>(ceil(q * double(count))));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= target) return bucketUpperBound(i);
+  }
+  return bucketUpperBound(counts.size() - 1);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+  Snapshot result;
+  result.counts.assign(BUCKETS, 0);
+  for (const Shard& shard : shards) {
+    for (size_t i = 0; i < BUCKETS; ++i) {
+      uint64_t count = shard.counts[i].load(memory_order_relaxed);
+      result.counts[i] += count;
+      result.count += count;
+    }
+    result.sumNs += shard.sumNs.load(memory_order_relaxed);
+  }
+  return result;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+  static MetricsRegistry registry;
+  return registry;
+}
+
+Counter& MetricsRegistry::counter(const string& name, const string& help,
+                                  const string& labels) {
+  lock_guard<mutex> guard(lock);
+  Family& family = families[name];
+  family.help = help;
+  auto& slot = family.counters[labels];
+  if (!slot) slot = make_unique<Counter>();
+  return *slot;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(const string& name,
+                                             const string& help,
+                                             const string& labels) {
+  lock_guard<mutex> guard(lock);
+  Family& family = families[name];
+  family.help = help;
+  family.isHistogram = true;
+  auto& slot = family.histograms[labels];
+  if (!slot) slot = make_unique<LatencyHistogram>();
+  return *slot;
+}
+
+namespace {
+
+string withLabels(const string& name, const string& labels,
+                  const string& extra = "") {
+  if (labels.empty() && extra.empty()) return name;
+  string joined = labels;
+  if (!labels.empty() && !extra.empty()) joined += ",";
+  return name + "{" + joined + extra + "}";
+}
+
+// Граница корзины в секундах без потери точности: 2^10 нс = 1.024e-06
+string secondsLabel(uint64_t ns) {
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), "le=\"%.9g\"", double(ns) / 1e9);
+  return buffer;
+}
+
+}  // namespace
+
+string MetricsRegistry::renderPrometheus() const {
+  ostringstream out;
+  out.precision(9);
+  lock_guard<mutex> guard(lock);
+  for (const auto& [name, family] : families) {
+    out << "# HELP " << name << " " << family.help << "\n";
+    out << "# TYPE " << name << " "
+        << (family.isHistogram ? "histogram" : "counter") << "\n";
+    for (const auto& [labels, counter] : family.counters) {
+      out << withLabels(name, labels) << " " << counter->value() << "\n";
+    }
+
+    // Корзины Prometheus — по степеням двойки от ~1 мкс: границы наших
+    // корзин с ними совпадают, поэтому накопленные суммы точные
+    for (const auto& [labels, histogram] : family.histograms) {
+      LatencyHistogram::Snapshot snapshot = histogram->snapshot();
+      uint64_t cumulative = 0;
+      size_t index = 0;
+      for (int exponent = 10; exponent <= LatencyHistogram::MAX_EXPONENT;
+           ++exponent) {
+        uint64_t bound = uint64_t(1) << exponent;
+        while (index < LatencyHistogram::BUCKETS - 1 &&
+               LatencyHistogram::bucketUpperBound(index) <= bound) {
+          cumulative += snapshot.counts[index++];
+        }
+        out << withLabels(name + "_bucket", labels, secondsLabel(bound))
+            << " " << cumulative << "\n";
+      }
+      out << withLabels(name + "_bucket", labels, "le=\"+Inf\"") << " "
+          << snapshot.count << "\n";
+      out << withLabels(name + "_sum", labels) << " "
+          << double(snapshot.sumNs) / 1e9 << "\n";
+      out << withLabels(name + "_count", labels) << " " << snapshot.count
+          << "\n";
+    }
+  }
+  return out.str();
+}
+
+string MetricsRegistry::renderSummary() const {
+  ostringstream out;
+  out.precision(3);
+  out << fixed;
+  lock_guard<mutex> guard(lock);
+  for (const auto& [name, family] : families) {
+    for (const auto& [labels, counter] : family.counters) {
+      out << "  " << withLabels(name, labels) << " = " << counter->value()
+          << "\n";
+    }
+    for (const auto& [labels, histogram] : family.histograms) {
+      LatencyHistogram::Snapshot snapshot = histogram->snapshot();
+      out << "  " << withLabels(name, labels) << ": " << snapshot.count
+          << " замеров";
+      if (snapshot.count > 0) {
+        out << ", среднее " << double(snapshot.sumNs) / snapshot.count / 1e6
+            << " мс, p50 " << snapshot.quantileNs(0.5) / 1e6 << " мс, p99 "
+            << snapshot.quantileNs(0.99) / 1e6 << " мс, max "
+            << snapshot.quantileNs(1.0) / 1e6 << " мс";
+      }
+      out << "\n";
+    }
+  }
+  return out.str();
+}
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry, const string& path,
+                                 unsigned intervalSeconds)
+    : registry(registry),
+      path(path),
+      intervalSeconds(max(1u, intervalSeconds)) {
+  stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (stopFd >= 0) worker = thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+  if (worker.joinable()) {
+    uint64_t one = 1;
+    ssize_t written = write(stopFd, &one, sizeof(one));
+    (void)written;
+    worker.join();
+  }
+  if (stopFd >= 0) close(stopFd);
+}
+
+bool MetricsExporter::writeSnapshot(string& error) {
+  string temporary = path + ".tmp";
+  {
+    ofstream out(temporary, ios::trunc);
+    out << registry.renderPrometheus();
+    out.flush();
+    if (!out) {
+      error = "Не удалось записать " + temporary;
+      return false;
+    }
+  }
+  if (rename(temporary.c_str(), path.c_str()) != 0) {
+    error = "Не удалось переименовать " + temporary + ": " + strerror(errno);
+    return false;
+  }
+  return true;
+}
+
+void MetricsExporter::run() {
+  static Counter& failures = metrics().counter(
+      "secure_calc_metrics_export_failures_total",
+      "Неудачные записи файла метрик");
+  pollfd stop = {stopFd, POLLIN, 0};
+  string error;
+
+  // Первый снимок сразу, чтобы файл существовал с момента запуска
+  if (!writeSnapshot(error)) failures.add();
+  while (true) {
+    int ready = poll(&stop, 1, static_cast<int>(intervalSeconds * 1000));
+    if (ready < 0 && errno == EINTR) continue;
+    if (!writeSnapshot(error)) failures.add();
+    if (ready != 0) return;
+  }
+}
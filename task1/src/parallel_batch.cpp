@@ -0,0 +1,275 @@
+#include "parallel_batch.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "trace.h"
+
+using namespace std;
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Task {
+  size_t index;
+  const char* begin;
+  const char* end;
+};
+
+struct WorkerQueue {
+  mutex lock;
+  deque<Task> tasks;
+};
+
+// Буфер вывода фрагмента. Переиспользуется фрагментом index + maxInFlight,
+// поэтому ёмкость строки сохраняется между фрагментами.
+struct Slot {
+  string output;
+  BatchStats stats;
+  bool ready = false;  // Под orderMutex
+};
+
+// Файл, отображённый в память только для чтения
+class MappedInput {
+ public:
+  ~MappedInput() {
+    if (data && size > 0) munmap(const_cast<char*>(data), size);
+  }
+
+  bool open(const string& path, string& error) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      error = "Не удалось открыть " + path + ": " + strerror(errno);
+      return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      error = "Ошибка fstat: " + string(strerror(errno));
+      close(fd);
+      return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size > 0) {
+      void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        error = "Ошибка mmap: " + string(strerror(errno));
+        size = 0;
+        close(fd);
+        return false;
+      }
+      madvise(mapped, size, MADV_SEQUENTIAL);
+      data = static_cast<const char*>(mapped);
+    }
+    close(fd);
+    return true;
+  }
+
+  const char* data = nullptr;
+  size_t size = 0;
+};
+
+}  // namespace
+
+ParallelBatchPipeline::ParallelBatchPipeline(const BatchProcessor& processor,
+                                             unsigned threads,
+                                             size_t chunkSize,
+                                             size_t maxInFlight)
+    : processor(processor),
+      threadCount(threads > 0 ? threads
+                              : max(1u, thread::hardware_concurrency())),
+      chunkSize(max<size_t>(chunkSize, 1)),
+      maxInFlight(maxInFlight > 0 ? maxInFlight : 4 * size_t(threadCount)) {}
+
+bool ParallelBatchPipeline::run(const string& path, int outputFd,
+                                PipelineStats& stats, string& error) {
+  auto wallStart = Clock::now();
+  MappedInput input;
+  if (!input.open(path, error)) return false;
+  stats.totals.bytesIn += input.size;
+  const char* const inputEnd = input.data + input.size;
+
+  vector<unique_ptr<WorkerQueue>> queues;
+  for (unsigned i = 0; i < threadCount; ++i) {
+    queues.push_back(make_unique<WorkerQueue>());
+  }
+
+  // pending — фрагменты в очередях, ещё не занятые ни одним потоком
+  mutex idleMutex;
+  condition_variable idleCv;
+  size_t pending = 0;
+  bool readerDone = false;
+
+  // Чтение опережает запись не больше чем на maxInFlight фрагментов
+  mutex orderMutex;
+  condition_variable readyCv;
+  condition_variable spaceCv;
+  vector<Slot> slots(maxInFlight);
+  size_t written = 0;
+  size_t totalChunks = 0;
+  bool splitFinished = false;
+
+  atomic<size_t> steals{0};
+  vector<double> busySeconds(threadCount, 0);
+
+  // Чтение: режет отображение по границам строк и раздаёт фрагменты по кругу
+  thread reader([&] {
+    const char* start = input.data;
+    size_t index = 0;
+    while (start < inputEnd) {
+      auto splitStart = Clock::now();
+      const char* end = inputEnd;
+      if (size_t(inputEnd - start) > chunkSize) {
+        const char* newline = static_cast<const char*>(
+            memchr(start + chunkSize, '\n', inputEnd - start - chunkSize));
+        end = newline ? newline + 1 : inputEnd;
+      }
+      stats.splitSeconds += secondsSince(splitStart);
+
+      {
+        auto waitStart = Clock::now();
+        unique_lock<mutex> lock(orderMutex);
+        spaceCv.wait(lock, [&] { return index - written < maxInFlight; });
+        stats.readerWaitSeconds += secondsSince(waitStart);
+        stats.maxBuffered = max(stats.maxBuffered, index - written + 1);
+      }
+
+      WorkerQueue& queue = *queues[index % threadCount];
+      {
+        lock_guard<mutex> lock(queue.lock);
+        queue.tasks.push_back({index, start, end});
+      }
+      {
+        lock_guard<mutex> lock(idleMutex);
+        ++pending;
+      }
+      idleCv.notify_one();
+      ++index;
+      start = end;
+    }
+
+    {
+      lock_guard<mutex> lock(idleMutex);
+      readerDone = true;
+    }
+    idleCv.notify_all();
+    {
+      lock_guard<mutex> lock(orderMutex);
+      totalChunks = index;
+      splitFinished = true;
+    }
+    readyCv.notify_one();
+  });
+
+  // Свою очередь поток берёт с головы (в порядке входа), чужую — с хвоста,
+  // чтобы не мешать владельцу и забирать фрагменты, которые нужны позже
+  auto takeTask = [&](unsigned self, Task& task) {
+    for (unsigned offset = 0; offset < threadCount; ++offset) {
+      WorkerQueue& queue = *queues[(self + offset) % threadCount];
+      lock_guard<mutex> lock(queue.lock);
+      if (queue.tasks.empty()) continue;
+      if (offset == 0) {
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+      } else {
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        steals.fetch_add(1, memory_order_relaxed);
+      }
+      return true;
+    }
+    return false;
+  };
+
+  vector<thread> workers;
+  for (unsigned self = 0; self < threadCount; ++self) {
+    workers.emplace_back([&, self] {
+      while (true) {
+        {
+          unique_lock<mutex> lock(idleMutex);
+          idleCv.wait(lock, [&] { return pending > 0 || readerDone; });
+          if (pending == 0) return;
+          --pending;
+        }
+        // Фрагмент зарезервирован и уже лежит в одной из очередей
+        Task task;
+        while (!takeTask(self, task)) this_thread::yield();
+
+        TRACE_SPAN("batch: evaluate chunk");
+        auto evaluateStart = Clock::now();
+        Slot& slot = slots[task.index % maxInFlight];
+        slot.output.clear();
+        slot.stats = {};
+        processor.evaluateLines(task.begin, task.end, slot.output, slot.stats);
+        busySeconds[self] += secondsSince(evaluateStart);
+
+        {
+          lock_guard<mutex> lock(orderMutex);
+          slot.ready = true;
+        }
+        readyCv.notify_one();
+      }
+    });
+  }
+
+  // Запись в вызывающем потоке: строго по порядку фрагментов. После ошибки
+  // записи фрагменты продолжают забираться, чтобы остальные стадии дошли
+  // до конца и потоки завершились.
+  bool ok = true;
+  for (size_t next = 0;; ++next) {
+    Slot& slot = slots[next % maxInFlight];
+    {
+      auto waitStart = Clock::now();
+      unique_lock<mutex> lock(orderMutex);
+      readyCv.wait(lock, [&] {
+        return slot.ready || (splitFinished && next == totalChunks);
+      });
+      stats.writerWaitSeconds += secondsSince(waitStart);
+      if (!slot.ready) break;
+    }
+
+    auto writeStart = Clock::now();
+    if (ok) {
+      ok = BatchProcessor::writeAll(outputFd, slot.output.data(),
+                                    slot.output.size(), error);
+    }
+    stats.writeSeconds += secondsSince(writeStart);
+    stats.totals.lines += slot.stats.lines;
+    stats.totals.errors += slot.stats.errors;
+    stats.totals.bytesOut += slot.output.size();
+
+    {
+      lock_guard<mutex> lock(orderMutex);
+      slot.ready = false;
+      ++written;
+    }
+    spaceCv.notify_one();
+  }
+
+  reader.join();
+  for (auto& worker : workers) worker.join();
+
+  stats.chunks += totalChunks;
+  stats.steals += steals.load();
+  for (double seconds : busySeconds) stats.evaluateSeconds += seconds;
+  stats.wallSeconds += secondsSince(wallStart);
+  return ok;
+}
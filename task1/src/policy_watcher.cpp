@@ -0,0 +1,86 @@
+#include "policy_watcher.h"
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+
+using namespace std;
+
+PolicyWatcher::PolicyWatcher(PasswordPolicy& policy, const string& path,
+                             ReloadCallback callback)
+    : passwordPolicy(policy), policyPath(path), onReload(std::move(callback)) {
+  size_t slash = policyPath.rfind('/');
+  string directory = slash == string::npos ? string(".")
+                     : slash == 0             ? string("/")
+                                              : policyPath.substr(0, slash);
+  fileName = slash == string::npos ? policyPath : policyPath.substr(slash + 1);
+
+  inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+  stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (inotifyFd >= 0) {
+    watchFd = inotify_add_watch(inotifyFd, directory.c_str(),
+                                IN_CLOSE_WRITE | IN_MOVED_TO);
+  }
+
+  // Без inotify политика просто остаётся той, что загружена при запуске
+  if (watchFd >= 0 && stopFd >= 0) {
+    worker = thread(&PolicyWatcher::run, this);
+  } else {
+    watchFd = -1;
+  }
+}
+
+PolicyWatcher::~PolicyWatcher() {
+  if (worker.joinable()) {
+    uint64_t one = 1;
+    ssize_t written = write(stopFd, &one, sizeof(one));
+    (void)written;
+    worker.join();
+  }
+  if (inotifyFd >= 0) close(inotifyFd);
+  if (stopFd >= 0) close(stopFd);
+}
+
+void PolicyWatcher::run() {
+  pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+
+  while (true) {
+    if (poll(fds, 2, -1) < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    if (fds[1].revents & POLLIN) return;
+    if ((fds[0].revents & POLLIN) && drainEvents()) reload();
+  }
+}
+
+// Вычитывает все накопившиеся события; true, если среди них есть наш файл.
+// Пачка событий (запись + переименование) даёт одну перезагрузку.
+bool PolicyWatcher::drainEvents() {
+  alignas(inotify_event) char buffer[4096];
+  bool changed = false;
+
+  while (true) {
+    ssize_t length = read(inotifyFd, buffer, sizeof(buffer));
+    if (length <= 0) break;
+
+    for (char* ptr = buffer; ptr < buffer + length;) {
+      const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+      if (event->len > 0 && fileName == event->name) changed = true;
+      ptr += sizeof(inotify_event) + event->len;
+    }
+  }
+  return changed;
+}
+
+void PolicyWatcher::reload() {
+  string error;
+  if (passwordPolicy.loadPolicyFile(policyPath, error)) {
+    onReload(true, "version=" + to_string(passwordPolicy.getVersion()));
+  } else {
+    onReload(false, error);
+  }
+}
@@ -0,0 +1,242 @@
+#include "session_manager.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "hmac_sha256.h"
+
+using namespace std;
+
+namespace {
+
+const size_t KEY_SIZE = 32;
+const size_t NONCE_SIZE = 16;
+
+string toHex(const string& data) {
+  static const char digits[] = "0123456789abcdef";
+  string hex;
+  hex.reserve(data.size() * 2);
+  for (unsigned char c : data) {
+    hex += digits[c >> 4];
+    hex += digits[c & 0x0f];
+  }
+  return hex;
+}
+
+bool fromHex(const string& hex, string& data) {
+  if (hex.size() % 2 != 0) return false;
+  data.clear();
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    int value = 0;
+    for (size_t j = i; j < i + 2; ++j) {
+      char c = hex[j];
+      value <<= 4;
+      if (c >= '0' && c <= '9')
+        value |= c - '0';
+      else if (c >= 'a' && c <= 'f')
+        value |= c - 'a' + 10;
+      else
+        return false;
+    }
+    data += static_cast<char>(value);
+  }
+  return true;
+}
+
+// Ключ из файла; false, если файла нет или он повреждён
+bool readKeyFile(const string& path, string& key) {
+  int fd = ::open(path.c_str(), O_RDONLY | O_NOFOLLOW | O_CLOEXEC);
+  if (fd < 0) return false;
+  char buffer[KEY_SIZE + 1];
+  ssize_t count = read(fd, buffer, sizeof(buffer));
+  close(fd);
+  if (count != static_cast<ssize_t>(KEY_SIZE)) return false;
+  key.assign(buffer, KEY_SIZE);
+  return true;
+}
+
+string randomBytes(size_t length) {
+  random_device rd;
+  string bytes(length, '\0');
+  for (size_t i = 0; i < length; ++i) {
+    bytes[i] = static_cast<char>(rd() & 0xff);
+  }
+  return bytes;
+}
+
+vector<string> splitToken(const string& token) {
+  vector<string> parts;
+  string part;
+  stringstream ss(token);
+  while (getline(ss, part, '.')) parts.push_back(part);
+  return parts;
+}
+
+}  // namespace
+
+SessionManager::SessionManager(UserDatabase& db, const string& keyFile,
+                               size_t cacheCapacity, int lifetime)
+    : userDB(db),
+      keyFilename(keyFile),
+      capacity(cacheCapacity),
+      tokenLifetime(lifetime) {
+  loadOrCreateKey();
+}
+
+void SessionManager::loadOrCreateKey() {
+  if (readKeyFile(keyFilename, signingKey)) return;
+
+  // Ключ создаётся один раз и переживает перезапуск процесса. Он пишется во
+  // временный файл, закрытый для других пользователей с момента создания,
+  // и появляется под своим именем атомарно через link: процесс, запущенный
+  // одновременно, получит EEXIST и прочитает уже целиком записанный ключ,
+  // а не перезапишет его и не обесценит выданные по нему токены
+  signingKey = randomBytes(KEY_SIZE);
+  string temporary = keyFilename + "." + to_string(getpid()) + ".tmp";
+  int fd = ::open(temporary.c_str(),
+                  O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR);
+  bool written = false;
+  if (fd >= 0) {
+    written = write(fd, signingKey.data(), signingKey.size()) ==
+                  static_cast<ssize_t>(signingKey.size()) &&
+              fsync(fd) == 0;
+    close(fd);
+  }
+
+  bool stored = false;
+  if (written) {
+    if (link(temporary.c_str(), keyFilename.c_str()) == 0) {
+      stored = true;
+    } else if (errno == EEXIST) {
+      string existing;
+      if (readKeyFile(keyFilename, existing)) {
+        signingKey = existing;
+        stored = true;
+      } else {
+        // Файл ключа повреждён: заменяется новым
+        stored = rename(temporary.c_str(), keyFilename.c_str()) == 0;
+      }
+    }
+  }
+  int savedErrno = errno;
+  unlink(temporary.c_str());
+  if (!stored) {
+    cerr << "Предупреждение: не удалось сохранить ключ сессий в "
+         << keyFilename << ": " << strerror(savedErrno)
+         << "; токены действительны только в этом процессе" << endl;
+  }
+}
+
+string SessionManager::issueToken(const UserSession& session) {
+  uint32_t generation = 0;
+  userDB.getUserGeneration(session.username, generation);
+  time_t expiresAt = time(nullptr) + tokenLifetime;
+
+  string nonce = toHex(randomBytes(NONCE_SIZE));
+  string payload = "v1." + toHex(session.username) + "." +
+                   toHex(session.ipAddress) + "." +
+                   to_string(static_cast<int>(session.role)) + "." +
+                   to_string(generation) + "." + to_string(expiresAt) + "." +
+                   nonce;
+  string token = payload + "." + toHex(HmacSha256::sign(signingKey, payload));
+
+  cacheSession({token, session, nonce, generation, expiresAt});
+  return token;
+}
+
+bool SessionManager::parseToken(const string& token,
+                                CachedSession& parsed) const {
+  vector<string> parts = splitToken(token);
+  if (parts.size() != 8 || parts[0] != "v1") return false;
+
+  size_t signatureStart = token.rfind('.');
+  string payload = token.substr(0, signatureStart);
+  string expected = toHex(HmacSha256::sign(signingKey, payload));
+  if (!HmacSha256::constantTimeEquals(expected, parts[7])) return false;
+
+  // Подпись верна, значит поля сформированы нами и разбор не должен падать
+  try {
+    string login, ip;
+    if (!fromHex(parts[1], login) || !fromHex(parts[2], ip)) return false;
+    int role = stoi(parts[3]);
+    if (role < 0 || role > 2) return false;
+
+    parsed.token = token;
+    parsed.session = {login, static_cast<Role>(role), ip};
+    parsed.nonce = parts[6];
+    parsed.generation = static_cast<uint32_t>(stoul(parts[4]));
+    parsed.expiresAt = static_cast<time_t>(stoll(parts[5]));
+  } catch (const exception&) {
+    return false;
+  }
+  return true;
+}
+
+bool SessionManager::isSessionCurrent(const CachedSession& cached) const {
+  if (time(nullptr) >= cached.expiresAt) return false;
+  if (userDB.isTokenRevoked(cached.nonce)) return false;
+
+  optional<UserInfo> userInfo = userDB.getUser(cached.session.username);
+  return userInfo && userInfo->isActive &&
+         userInfo->role == cached.session.role &&
+         userInfo->generation == cached.generation;
+}
+
+void SessionManager::cacheSession(CachedSession&& cached) {
+  auto existing = sessionIndex.find(cached.token);
+  if (existing != sessionIndex.end()) {
+    lruList.erase(existing->second);
+    sessionIndex.erase(existing);
+  }
+
+  lruList.push_front(std::move(cached));
+  sessionIndex[lruList.front().token] = lruList.begin();
+
+  while (sessionIndex.size() > capacity) {
+    sessionIndex.erase(lruList.back().token);
+    lruList.pop_back();
+  }
+}
+
+bool SessionManager::validateToken(const string& token, UserSession& session) {
+  auto it = sessionIndex.find(token);
+  if (it != sessionIndex.end()) {
+    if (!isSessionCurrent(*it->second)) {
+      lruList.erase(it->second);
+      sessionIndex.erase(it);
+      return false;
+    }
+    lruList.splice(lruList.begin(), lruList, it->second);
+    session = it->second->session;
+    return true;
+  }
+
+  CachedSession parsed;
+  if (!parseToken(token, parsed) || !isSessionCurrent(parsed)) return false;
+
+  session = parsed.session;
+  cacheSession(std::move(parsed));
+  return true;
+}
+
+bool SessionManager::revokeToken(const string& token) {
+  CachedSession parsed;
+  if (!parseToken(token, parsed)) return false;
+
+  userDB.revokeToken(parsed.nonce, parsed.expiresAt);
+  auto it = sessionIndex.find(token);
+  if (it != sessionIndex.end()) {
+    lruList.erase(it->second);
+    sessionIndex.erase(it);
+  }
+  return true;
+}
@@ -0,0 +1,148 @@
+#include "session_recorder.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+SessionRecorder::~SessionRecorder() {
+  if (fd >= 0) close(fd);
+}
+
+bool SessionRecorder::open(const string& path, string& error) {
+  // Права 0600 задаются при создании: между созданием файла и chmod пароли
+  // были бы доступны по umask. O_NOFOLLOW не даёт подменить путь ссылкой.
+  fd = ::open(path.c_str(),
+              O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC,
+              S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    error = "Не удалось открыть " + path + ": " + strerror(errno);
+    return false;
+  }
+  // Уже существовавший файл сохраняет прежние права
+  if (fchmod(fd, S_IRUSR | S_IWUSR) != 0 ||
+      !writeAll(SESSION_RECORD_MAGIC + "\n")) {
+    error = "Не удалось записать " + path + ": " + strerror(errno);
+    close(fd);
+    fd = -1;
+    return false;
+  }
+  start = chrono::steady_clock::now();
+  return true;
+}
+
+bool SessionRecorder::writeAll(const string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t count = write(fd, data.data() + written, data.size() - written);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) return false;
+    written += count;
+  }
+  return true;
+}
+
+SessionRecorder::int_type SessionRecorder::underflow() {
+  if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+  // read отдаёт то, что уже введено: с терминала — строку целиком
+  ssize_t count;
+  do {
+    count = read(STDIN_FILENO, buffer, sizeof(buffer));
+  } while (count < 0 && errno == EINTR);
+  if (count <= 0) return traits_type::eof();
+
+  auto offset = chrono::duration_cast<chrono::microseconds>(
+      chrono::steady_clock::now() - start);
+  // Пишется сразу: сеанс может закончиться через exit в меню
+  string chunk = to_string(offset.count()) + " " + to_string(count) + "\n";
+  chunk.append(buffer, count);
+  chunk += '\n';
+  if (!writeAll(chunk)) {
+    cerr << "Запись сеанса прервана: " << strerror(errno) << endl;
+  }
+
+  setg(buffer, buffer, buffer + count);
+  return traits_type::to_int_type(*gptr());
+}
+
+bool SessionReplayer::parseChunkHeader(const char* begin, const char* end,
+                                       Chunk& chunk) {
+  // Беззнаковый from_chars не принимает знак, так что "-1" не станет
+  // SIZE_MAX
+  auto [afterOffset, offsetError] = from_chars(begin, end, chunk.offsetUs);
+  if (offsetError != errc() || afterOffset == end || *afterOffset != ' ') {
+    return false;
+  }
+  auto [afterLength, lengthError] =
+      from_chars(afterOffset + 1, end, chunk.length);
+  return lengthError == errc() && afterLength == end;
+}
+
+bool SessionReplayer::open(const string& path, bool pacedReplay,
+                           string& error) {
+  ifstream file(path, ios::binary);
+  if (!file.is_open()) {
+    error = "Не удалось открыть " + path + ": " + strerror(errno);
+    return false;
+  }
+  data.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+
+  size_t position = data.find('\n');
+  if (position == string::npos ||
+      data.compare(0, position, SESSION_RECORD_MAGIC) != 0) {
+    error = path + ": не является записью сеанса";
+    return false;
+  }
+  ++position;
+
+  chunks.clear();
+  while (position < data.size()) {
+    size_t lineEnd = data.find('\n', position);
+    Chunk chunk;
+    // Длина сравнивается с остатком файла до сложения: иначе огромное
+    // значение переполнило бы lineEnd + 1 + length и прошло проверку
+    if (lineEnd == string::npos || lineEnd + 2 > data.size() ||
+        !parseChunkHeader(data.data() + position, data.data() + lineEnd,
+                          chunk) ||
+        chunk.length > data.size() - (lineEnd + 2) ||
+        data[lineEnd + 1 + chunk.length] != '\n') {
+      error = path + ": повреждена порция " + to_string(chunks.size() + 1);
+      return false;
+    }
+    chunk.begin = lineEnd + 1;
+    chunks.push_back(chunk);
+    position = chunk.begin + chunk.length + 1;
+  }
+
+  next = 0;
+  paced = pacedReplay;
+  start = chrono::steady_clock::now();
+  return true;
+}
+
+SessionReplayer::int_type SessionReplayer::underflow() {
+  if (gptr() < egptr()) return traits_type::to_int_type(*gptr());
+
+  if (next == chunks.size()) {
+    cout.flush();
+    cerr << "\nЗапись сеанса закончилась" << endl;
+    exit(EXHAUSTED_EXIT_CODE);
+  }
+
+  const Chunk& chunk = chunks[next++];
+  if (paced) {
+    this_thread::sleep_until(start + chrono::microseconds(chunk.offsetUs));
+  }
+  char* begin = data.data() + chunk.begin;
+  setg(begin, begin, begin + chunk.length);
+  return traits_type::to_int_type(*gptr());
+}
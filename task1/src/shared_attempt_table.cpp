@@ -0,0 +1,352 @@
+#include "shared_attempt_table.h"
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <thread>
+
+#include "metrics.h"
+
+using namespace std;
+
+namespace {
+
+constexpr uint64_t SEGMENT_MAGIC = 0x5343415454424c31ULL;  // "SCATTBL1"
+constexpr uint32_t SEGMENT_VERSION = 1;
+
+// Сколько ждать, пока другой процесс допишет заголовок нового сегмента
+constexpr int INIT_WAIT_STEPS = 100;
+constexpr auto INIT_WAIT_STEP = chrono::milliseconds(10);
+
+uint64_t mix(uint64_t x) {
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+}  // namespace
+
+// Поля заголовка, кроме атомарных, пишутся один раз до публикации magic
+struct SharedAttemptTable::Header {
+  atomic<uint64_t> magic;  // Пишется последним: сегмент готов
+  uint32_t version;
+  uint32_t capacity;
+  uint64_t seed;  // Общий для всех процессов, иначе ключи не совпадут
+  pthread_mutex_t claimLock;
+  atomic<uint64_t> occupied;
+  atomic<uint64_t> evictions;
+  atomic<uint64_t> lockedEvictions;
+  atomic<uint64_t> recoveries;
+};
+
+namespace {
+
+// Атомарные поля работают между процессами, только если они без блокировок
+static_assert(atomic<uint64_t>::is_always_lock_free);
+static_assert(atomic<uint32_t>::is_always_lock_free);
+
+constexpr size_t slotsOffset(size_t headerSize) {
+  return (headerSize + 63) / 64 * 64;
+}
+
+}  // namespace
+
+SharedAttemptTable::~SharedAttemptTable() {
+  if (mapping) munmap(mapping, mappingSize);
+}
+
+string SharedAttemptTable::nameFor(const string& databasePath) {
+  error_code ignored;
+  string path = filesystem::weakly_canonical(
+                    filesystem::absolute(databasePath, ignored), ignored)
+                    .string();
+  // Как и в hashKey, FNV-1a: имя не должно зависеть от компилятора
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : path) hash = (hash ^ c) * 0x100000001b3ULL;
+  char digest[17];
+  snprintf(digest, sizeof(digest), "%016llx",
+           static_cast<unsigned long long>(mix(hash)));
+  return "/secure_calc_attempts." + to_string(geteuid()) + "." + digest;
+}
+
+bool SharedAttemptTable::open(const string& name, size_t capacity,
+                              string& error) {
+  // Вторая попытка — после удаления сегмента, брошенного при создании
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC,
+                      S_IRUSR | S_IWUSR);
+    bool created = fd >= 0;
+    if (!created) {
+      if (errno != EEXIST) {
+        error = "Не удалось создать " + name + ": " + strerror(errno);
+        return false;
+      }
+      fd = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+      if (fd < 0) {
+        if (errno == ENOENT) continue;  // Сегмент только что удалили
+        error = "Не удалось открыть " + name + ": " + strerror(errno);
+        return false;
+      }
+    }
+
+    bool uninitialized = false;
+    bool ok = attach(fd, created, capacity, uninitialized, error);
+    close(fd);
+    if (ok) return true;
+    if (created || uninitialized) shm_unlink(name.c_str());
+    if (!uninitialized) return false;
+  }
+  return false;
+}
+
+bool SharedAttemptTable::attach(int fd, bool created, size_t capacity,
+                                bool& uninitialized, string& error) {
+  const size_t offset = slotsOffset(sizeof(Header));
+  size_t slotCount = 1;
+  size_t size;
+
+  if (created) {
+    while (slotCount < capacity) slotCount <<= 1;
+    size = offset + slotCount * sizeof(Slot);
+    // Новый сегмент заполнен нулями: все слоты свободны
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      error = string("Не удалось задать размер сегмента: ") + strerror(errno);
+      return false;
+    }
+  } else {
+    struct stat st;
+    for (int step = 0;; ++step) {
+      if (fstat(fd, &st) != 0) {
+        error = string("Ошибка fstat: ") + strerror(errno);
+        return false;
+      }
+      // Имя сегмента предсказуемо, а создать его в /dev/shm может любой.
+      // Чужой или доступный другим сегмент позволил бы обнулять счётчики
+      // и блокировать учётные записи, поэтому он не используется
+      if (st.st_uid != geteuid() || (st.st_mode & 077) != 0) {
+        error = "Сегмент принадлежит другому пользователю или доступен "
+                "другим пользователям";
+        return false;
+      }
+      if (static_cast<size_t>(st.st_size) >= offset) break;
+      if (step == INIT_WAIT_STEPS) {
+        uninitialized = true;
+        error = "Сегмент не инициализирован";
+        return false;
+      }
+      this_thread::sleep_for(INIT_WAIT_STEP);
+    }
+    size = static_cast<size_t>(st.st_size);
+  }
+
+  void* memory =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (memory == MAP_FAILED) {
+    error = string("Ошибка mmap: ") + strerror(errno);
+    return false;
+  }
+  Header* shared = static_cast<Header*>(memory);
+
+  if (created) {
+    shared = new (memory) Header();
+    shared->version = SEGMENT_VERSION;
+    shared->capacity = static_cast<uint32_t>(slotCount);
+    random_device rd;
+    shared->seed = (uint64_t(rd()) << 32) | rd();
+
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+    int rc = pthread_mutex_init(&shared->claimLock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+    if (rc != 0) {
+      munmap(memory, size);
+      error = string("Не удалось создать мьютекс: ") + strerror(rc);
+      return false;
+    }
+    shared->magic.store(SEGMENT_MAGIC, memory_order_release);
+  } else {
+    int step = 0;
+    while (shared->magic.load(memory_order_acquire) != SEGMENT_MAGIC) {
+      if (++step > INIT_WAIT_STEPS) {
+        munmap(memory, size);
+        uninitialized = true;
+        error = "Сегмент не инициализирован";
+        return false;
+      }
+      this_thread::sleep_for(INIT_WAIT_STEP);
+    }
+    slotCount = shared->capacity;
+    if (shared->version != SEGMENT_VERSION || slotCount == 0 ||
+        (slotCount & (slotCount - 1)) != 0 ||
+        size < offset + slotCount * sizeof(Slot)) {
+      munmap(memory, size);
+      error = "Несовместимый формат сегмента";
+      return false;
+    }
+  }
+
+  header = shared;
+  slots = reinterpret_cast<Slot*>(static_cast<char*>(memory) + offset);
+  mask = slotCount - 1;
+  mapping = memory;
+  mappingSize = size;
+  return true;
+}
+
+// FNV-1a не зависит от реализации std::hash, поэтому ключи совпадают и у
+// процессов, собранных разными компиляторами
+uint64_t SharedAttemptTable::hashKey(Kind kind, const string& key) const {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  hash = (hash ^ static_cast<uint8_t>(kind)) * 0x100000001b3ULL;
+  for (unsigned char c : key) hash = (hash ^ c) * 0x100000001b3ULL;
+  hash = mix(hash ^ header->seed);
+  return hash ? hash : 1;
+}
+
+SharedAttemptTable::Slot* SharedAttemptTable::find(uint64_t keyHash) const {
+  for (size_t i = 0; i < MAX_PROBES; ++i) {
+    Slot& slot = slots[(keyHash + i) & mask];
+    uint64_t stored = slot.keyHash.load(memory_order_acquire);
+    if (stored == keyHash) return &slot;
+    if (stored == 0) return nullptr;  // Дальше по цепочке ключа нет
+  }
+  return nullptr;
+}
+
+bool SharedAttemptTable::lockClaims() {
+  static Counter& recovered = metrics().counter(
+      "secure_calc_shared_state_recoveries_total",
+      "Восстановления мьютекса общей таблицы попыток после падения процесса");
+  int rc = pthread_mutex_lock(&header->claimLock);
+  if (rc == EOWNERDEAD) {
+    pthread_mutex_consistent(&header->claimLock);
+    header->recoveries.fetch_add(1, memory_order_relaxed);
+    recovered.add();
+    return true;
+  }
+  return rc == 0;
+}
+
+SharedAttemptTable::Slot* SharedAttemptTable::findOrClaim(uint64_t keyHash,
+                                                          time_t now) {
+  if (Slot* slot = find(keyHash)) return slot;
+  if (!lockClaims()) return nullptr;
+  // Пока ждали мьютекс, ключ мог вставить другой процесс
+  Slot* slot = find(keyHash);
+  if (!slot) slot = chooseSlot(keyHash, now);
+  pthread_mutex_unlock(&header->claimLock);
+  return slot;
+}
+
+// Вызывается под мьютексом: ключи слотов меняются только здесь
+SharedAttemptTable::Slot* SharedAttemptTable::chooseSlot(uint64_t keyHash,
+                                                         time_t now) {
+  auto claim = [&](Slot& slot) {
+    slot.attempts.store(0, memory_order_relaxed);
+    slot.unlockTime.store(0, memory_order_relaxed);
+    slot.lastAttempt.store(static_cast<uint32_t>(now), memory_order_relaxed);
+    slot.keyHash.store(keyHash, memory_order_release);
+    return &slot;
+  };
+
+  Slot* victim = nullptr;
+  bool victimLocked = true;
+  uint32_t victimLast = 0;
+  for (size_t i = 0; i < MAX_PROBES; ++i) {
+    Slot& slot = slots[(keyHash + i) & mask];
+    if (slot.keyHash.load(memory_order_relaxed) == 0) {
+      header->occupied.fetch_add(1, memory_order_relaxed);
+      return claim(slot);
+    }
+    uint32_t last = slot.lastAttempt.load(memory_order_relaxed);
+    bool locked = slot.unlockTime.load(memory_order_relaxed) > now;
+    if (!locked && uint64_t(last) + STALE_SECONDS < uint64_t(now)) {
+      return claim(slot);
+    }
+    if (!victim || (victimLocked && !locked) ||
+        (victimLocked == locked && last < victimLast)) {
+      victim = &slot;
+      victimLocked = locked;
+      victimLast = last;
+    }
+  }
+
+  header->evictions.fetch_add(1, memory_order_relaxed);
+  if (victimLocked) header->lockedEvictions.fetch_add(1, memory_order_relaxed);
+  return claim(*victim);
+}
+
+bool SharedAttemptTable::isLocked(Kind kind, const string& key,
+                                  uint32_t threshold, time_t now,
+                                  int& remaining) {
+  Slot* slot = find(hashKey(kind, key));
+  if (!slot) return false;
+  uint32_t attempts = slot->attempts.load(memory_order_acquire);
+  if (attempts < threshold) return false;
+  uint32_t unlockTime = slot->unlockTime.load(memory_order_acquire);
+  if (now < unlockTime) {
+    remaining = static_cast<int>(unlockTime - now);
+    return true;
+  }
+  // Блокировка истекла: счёт начинается заново, если никто не успел
+  // добавить неудачу
+  slot->attempts.compare_exchange_strong(attempts, 0, memory_order_acq_rel);
+  return false;
+}
+
+uint32_t SharedAttemptTable::registerFailure(Kind kind, const string& key,
+                                             uint32_t threshold,
+                                             uint32_t lockSeconds,
+                                             time_t now) {
+  Slot* slot = findOrClaim(hashKey(kind, key), now);
+  if (!slot) return threshold;
+  slot->lastAttempt.store(static_cast<uint32_t>(now), memory_order_relaxed);
+
+  // Срок блокировки публикуется раньше счётчика: тот, кто увидит порог,
+  // увидит и срок и не сочтёт блокировку истёкшей
+  uint32_t attempts = slot->attempts.load(memory_order_relaxed);
+  do {
+    if (attempts + 1 >= threshold) {
+      slot->unlockTime.store(static_cast<uint32_t>(now + lockSeconds),
+                             memory_order_relaxed);
+    }
+  } while (!slot->attempts.compare_exchange_weak(attempts, attempts + 1,
+                                                 memory_order_acq_rel));
+  return attempts + 1;
+}
+
+void SharedAttemptTable::reset(Kind kind, const string& key) {
+  Slot* slot = find(hashKey(kind, key));
+  if (slot) slot->attempts.store(0, memory_order_release);
+}
+
+bool SharedAttemptTable::lookup(Kind kind, const string& key,
+                                Entry& entry) const {
+  Slot* slot = find(hashKey(kind, key));
+  if (!slot) return false;
+  entry.attempts = slot->attempts.load(memory_order_acquire);
+  entry.unlockTime = slot->unlockTime.load(memory_order_acquire);
+  entry.lastAttempt = slot->lastAttempt.load(memory_order_relaxed);
+  return true;
+}
+
+SharedAttemptTable::Stats SharedAttemptTable::getStats() const {
+  if (!header) return {};
+  return {mask + 1, header->occupied.load(memory_order_relaxed),
+          header->evictions.load(memory_order_relaxed),
+          header->lockedEvictions.load(memory_order_relaxed),
+          header->recoveries.load(memory_order_relaxed)};
+}
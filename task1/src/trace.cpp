@@ -0,0 +1,204 @@
+#include "trace.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+atomic<bool> Tracer::enabled{false};
+
+namespace {
+
+// Пишет только поток-владелец; count публикуется с release, поэтому
+// читатель видит все события ниже count вместе с их блоками
+struct ThreadBuffer {
+  pid_t tid = 0;
+  array<unique_ptr<Tracer::Event[]>, Tracer::MAX_CHUNKS> chunks;
+  atomic<size_t> count{0};
+  atomic<size_t> dropped{0};
+};
+
+struct TraceState {
+  mutex lock;  // Список буферов и запись файла
+  vector<unique_ptr<ThreadBuffer>> buffers;
+  string path;
+  uint64_t originNs = 0;
+  pid_t mainTid = 0;
+  int signalFd = -1;
+};
+
+// Не разрушается: потоки могут писать события и во время завершения
+TraceState& state() {
+  static TraceState* instance = new TraceState;
+  return *instance;
+}
+
+thread_local ThreadBuffer* threadBuffer = nullptr;
+
+ThreadBuffer* currentBuffer() {
+  if (!threadBuffer) {
+    auto buffer = make_unique<ThreadBuffer>();
+    buffer->tid = gettid();
+    TraceState& trace = state();
+    lock_guard<mutex> guard(trace.lock);
+    threadBuffer = buffer.get();
+    trace.buffers.push_back(std::move(buffer));
+  }
+  return threadBuffer;
+}
+
+void appendEscaped(string& out, const char* text) {
+  for (; *text; ++text) {
+    if (*text == '"' || *text == '\\') out += '\\';
+    out += *text;
+  }
+}
+
+void onDumpSignal(int) {
+  uint64_t one = 1;
+  ssize_t written = write(state().signalFd, &one, sizeof(one));
+  (void)written;
+}
+
+// Файл пишется в отдельном потоке: в обработчике сигнала это небезопасно
+void dumpOnSignal() {
+  pollfd signal = {state().signalFd, POLLIN, 0};
+  while (true) {
+    if (poll(&signal, 1, -1) < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+    uint64_t value;
+    ssize_t count = read(state().signalFd, &value, sizeof(value));
+    (void)count;
+    string error;
+    if (!Tracer::dump(error)) cerr << error << endl;
+  }
+}
+
+void dumpAtExit() {
+  string error;
+  if (!Tracer::dump(error)) cerr << error << endl;
+}
+
+}  // namespace
+
+void Tracer::record(const char* name, uint64_t startNs,
+                    uint64_t endNs) noexcept {
+  try {
+    ThreadBuffer* buffer = currentBuffer();
+    size_t index = buffer->count.load(memory_order_relaxed);
+    size_t chunk = index / CHUNK_EVENTS;
+    if (chunk >= MAX_CHUNKS) {
+      buffer->dropped.fetch_add(1, memory_order_relaxed);
+      return;
+    }
+    if (!buffer->chunks[chunk]) {
+      buffer->chunks[chunk] = make_unique<Event[]>(CHUNK_EVENTS);
+    }
+    buffer->chunks[chunk][index % CHUNK_EVENTS] = {name, startNs,
+                                                   endNs - startNs};
+    buffer->count.store(index + 1, memory_order_release);
+  } catch (const bad_alloc&) {
+    // Без памяти событие теряется; работа программы важнее трассы
+  }
+}
+
+void Tracer::recordSinceStart(const char* name) noexcept {
+  if (isEnabled()) record(name, state().originNs, nowNs());
+}
+
+bool Tracer::start(const string& path, string& error) {
+  TraceState& trace = state();
+  {
+    lock_guard<mutex> guard(trace.lock);
+    if (isEnabled()) return true;
+    if (!ofstream(path, ios::trunc)) {
+      error = "Не удалось открыть " + path + ": " + strerror(errno);
+      return false;
+    }
+    trace.path = path;
+    trace.originNs = nowNs();
+    trace.mainTid = gettid();
+    trace.signalFd = eventfd(0, EFD_CLOEXEC);
+  }
+
+  if (trace.signalFd >= 0) {
+    struct sigaction action {};
+    action.sa_handler = onDumpSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGUSR1, &action, nullptr);
+    thread(dumpOnSignal).detach();
+  }
+  atexit(dumpAtExit);
+  enabled.store(true, memory_order_relaxed);
+  return true;
+}
+
+bool Tracer::dump(string& error) {
+  TraceState& trace = state();
+  lock_guard<mutex> guard(trace.lock);
+  if (trace.path.empty()) return true;
+
+  string out = "{\"traceEvents\":[\n";
+  string pid = to_string(getpid());
+  char number[64];
+  size_t dropped = 0;
+  bool first = true;
+  for (const auto& buffer : trace.buffers) {
+    out += first ? "" : ",\n";
+    first = false;
+    out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + pid +
+           ",\"tid\":" + to_string(buffer->tid) + ",\"args\":{\"name\":\"" +
+           (buffer->tid == trace.mainTid ? "main" : "worker") + "\"}}";
+
+    size_t count = buffer->count.load(memory_order_acquire);
+    dropped += buffer->dropped.load(memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+      const Event& event = buffer->chunks[i / CHUNK_EVENTS][i % CHUNK_EVENTS];
+      out += ",\n{\"name\":\"";
+      appendEscaped(out, event.name);
+      // Chrome ожидает микросекунды; дробная часть сохраняет точность
+      snprintf(number, sizeof(number), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f",
+               double(event.startNs - trace.originNs) / 1e3,
+               double(event.durationNs) / 1e3);
+      out += number;
+      out += ",\"pid\":" + pid + ",\"tid\":" + to_string(buffer->tid) + "}";
+    }
+  }
+  out += "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" +
+         to_string(dropped) + "}}\n";
+
+  // Замена переименованием: просмотрщик не увидит файл наполовину
+  string temporary = trace.path + ".tmp";
+  {
+    ofstream file(temporary, ios::trunc);
+    file << out;
+    file.flush();
+    if (!file) {
+      error = "Не удалось записать трассу в " + temporary;
+      return false;
+    }
+  }
+  if (rename(temporary.c_str(), trace.path.c_str()) != 0) {
+    error = "Не удалось переименовать " + temporary + ": " + strerror(errno);
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,269 @@
+#include "user_store.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+
+constexpr size_t PACKED_HASH_BYTES = 24;  // 16 байт соли и 8 байт значения
+constexpr size_t CANONICAL_HASH_LENGTH = 49;
+constexpr size_t HASH_DELIMITER = 32;
+const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Позиция старшей hex-цифры байта b в каноническом хэше (после соли
+// пропускается разделитель)
+constexpr size_t hexPosition(size_t b) { return 2 * b + (b >= 16 ? 1 : 0); }
+
+void appendVarint(vector<char>& out, size_t value) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+size_t readVarint(const char*& p) {
+  size_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    uint8_t byte = static_cast<uint8_t>(*p++);
+    value |= size_t(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) return value;
+  }
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Только строчные hex: иначе распакованный хэш не совпал бы с исходным
+bool isCanonicalHash(string_view hash) {
+  if (hash.size() != CANONICAL_HASH_LENGTH || hash[HASH_DELIMITER] != '|') {
+    return false;
+  }
+  for (size_t i = 0; i < hash.size(); ++i) {
+    if (i != HASH_DELIMITER && hexValue(hash[i]) < 0) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+uint32_t UserStore::hashLogin(string_view login) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (unsigned char c : login) hash = (hash ^ c) * 0x100000001b3ULL;
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  return static_cast<uint32_t>(hash);
+}
+
+uint32_t UserStore::find(string_view login) const {
+  if (index.empty()) return NOT_FOUND;
+  uint32_t hash = hashLogin(login);
+  size_t mask = index.size() - 1;
+  for (size_t i = hash & mask;; i = (i + 1) & mask) {
+    uint32_t cell = index[i];
+    if (cell == EMPTY) return NOT_FOUND;
+    if (cell == TOMBSTONE) continue;
+    uint32_t id = cell - 2;
+    if (loginHashes[id] == hash && this->login(id) == login) return id;
+  }
+}
+
+uint32_t UserStore::appendRecord(string_view login, string_view passwordHash,
+                                 bool& packed) {
+  packed = isCanonicalHash(passwordHash);
+  size_t needed = login.size() + 2 * sizeof(uint64_t) +
+                  (packed ? PACKED_HASH_BYTES : passwordHash.size());
+  if (arena.size() + needed > UINT32_MAX) {
+    throw length_error("Арена учётных записей превысила 4 ГиБ");
+  }
+
+  uint32_t offset = static_cast<uint32_t>(arena.size());
+  appendVarint(arena, login.size());
+  arena.insert(arena.end(), login.begin(), login.end());
+  if (packed) {
+    for (size_t b = 0; b < PACKED_HASH_BYTES; ++b) {
+      size_t i = hexPosition(b);
+      arena.push_back(static_cast<char>(hexValue(passwordHash[i]) << 4 |
+                                        hexValue(passwordHash[i + 1])));
+    }
+  } else {
+    appendVarint(arena, passwordHash.size());
+    arena.insert(arena.end(), passwordHash.begin(), passwordHash.end());
+  }
+  return offset;
+}
+
+size_t UserStore::recordSize(uint32_t id) const {
+  const char* begin = arena.data() + offsets[id];
+  const char* p = begin;
+  p += readVarint(p);
+  p += (flags[id] & PACKED_HASH) ? PACKED_HASH_BYTES : readVarint(p);
+  return static_cast<size_t>(p - begin);
+}
+
+string_view UserStore::login(uint32_t id) const {
+  const char* p = arena.data() + offsets[id];
+  size_t length = readVarint(p);
+  return string_view(p, length);
+}
+
+string UserStore::passwordHash(uint32_t id) const {
+  const char* p = arena.data() + offsets[id];
+  p += readVarint(p);
+  if (!(flags[id] & PACKED_HASH)) {
+    size_t length = readVarint(p);
+    return string(p, length);
+  }
+
+  string hash(CANONICAL_HASH_LENGTH, '|');
+  for (size_t b = 0; b < PACKED_HASH_BYTES; ++b) {
+    uint8_t value = static_cast<uint8_t>(p[b]);
+    hash[hexPosition(b)] = HEX_DIGITS[value >> 4];
+    hash[hexPosition(b) + 1] = HEX_DIGITS[value & 15];
+  }
+  return hash;
+}
+
+uint32_t UserStore::insert(string_view login, string_view passwordHash,
+                           uint8_t role, bool isActive, uint32_t generation) {
+  // Заполнение индекса вместе с надгробиями не выше 3/4
+  if ((live + tombstones + 1) * 4 > index.size() * 3) {
+    rebuildIndex(max<size_t>(16, bit_ceil((live + 1) * 2)));
+  }
+  if (offsets.size() >= NOT_FOUND - 2) {
+    throw length_error("Слишком много учётных записей");
+  }
+
+  bool packed;
+  uint32_t offset = appendRecord(login, passwordHash, packed);
+  uint32_t id = static_cast<uint32_t>(offsets.size());
+  uint32_t hash = hashLogin(login);
+  offsets.push_back(offset);
+  loginHashes.push_back(hash);
+  generations.push_back(generation);
+  flags.push_back(static_cast<uint8_t>((role & ROLE_MASK) |
+                                       (isActive ? ACTIVE : 0) |
+                                       (packed ? PACKED_HASH : 0)));
+
+  size_t mask = index.size() - 1;
+  size_t i = hash & mask;
+  while (index[i] > TOMBSTONE) i = (i + 1) & mask;
+  if (index[i] == TOMBSTONE) --tombstones;
+  index[i] = id + 2;
+  ++live;
+  return id;
+}
+
+size_t UserStore::findSlot(uint32_t id) const {
+  size_t mask = index.size() - 1;
+  size_t i = loginHashes[id] & mask;
+  while (index[i] != id + 2) i = (i + 1) & mask;
+  return i;
+}
+
+void UserStore::erase(uint32_t id) {
+  index[findSlot(id)] = TOMBSTONE;
+  ++tombstones;
+  garbageBytes += recordSize(id);
+  flags[id] |= DELETED;
+  --live;
+  compactIfSparse();
+}
+
+void UserStore::setPasswordHash(uint32_t id, string_view passwordHash) {
+  garbageBytes += recordSize(id);
+  // Логин копируется: арена может переехать при добавлении
+  string loginCopy(login(id));
+  bool packed;
+  offsets[id] = appendRecord(loginCopy, passwordHash, packed);
+  flags[id] = static_cast<uint8_t>((flags[id] & ~PACKED_HASH) |
+                                   (packed ? PACKED_HASH : 0));
+  compactIfSparse();
+}
+
+void UserStore::clear() {
+  arena.clear();
+  offsets.clear();
+  loginHashes.clear();
+  generations.clear();
+  flags.clear();
+  index.clear();
+  live = tombstones = garbageBytes = 0;
+}
+
+void UserStore::reserve(size_t users, size_t arenaBytes) {
+  arena.reserve(arenaBytes);
+  offsets.reserve(users);
+  loginHashes.reserve(users);
+  generations.reserve(users);
+  flags.reserve(users);
+  size_t capacity = bit_ceil(max<size_t>(16, (users * 4 + 2) / 3 + 1));
+  if (capacity > index.size()) rebuildIndex(capacity);
+}
+
+void UserStore::shrinkToFit() {
+  arena.shrink_to_fit();
+  offsets.shrink_to_fit();
+  loginHashes.shrink_to_fit();
+  generations.shrink_to_fit();
+  flags.shrink_to_fit();
+}
+
+void UserStore::rebuildIndex(size_t capacity) {
+  index.assign(capacity, EMPTY);
+  size_t mask = capacity - 1;
+  forEach([&](uint32_t id) {
+    size_t i = loginHashes[id] & mask;
+    while (index[i] != EMPTY) i = (i + 1) & mask;
+    index[i] = id + 2;
+  });
+  tombstones = 0;
+}
+
+// Больше половины арены занято мёртвыми записями: живые переписываются
+// подряд и получают новые номера
+void UserStore::compactIfSparse() {
+  if (garbageBytes * 2 <= arena.size()) return;
+
+  vector<char> compactArena;
+  vector<uint32_t> compactOffsets, compactHashes, compactGenerations;
+  vector<uint8_t> compactFlags;
+  compactArena.reserve(arena.size() - garbageBytes);
+  compactOffsets.reserve(live);
+  compactHashes.reserve(live);
+  compactGenerations.reserve(live);
+  compactFlags.reserve(live);
+
+  forEach([&](uint32_t id) {
+    const char* begin = arena.data() + offsets[id];
+    compactOffsets.push_back(static_cast<uint32_t>(compactArena.size()));
+    compactArena.insert(compactArena.end(), begin, begin + recordSize(id));
+    compactHashes.push_back(loginHashes[id]);
+    compactGenerations.push_back(generations[id]);
+    compactFlags.push_back(flags[id]);
+  });
+
+  arena.swap(compactArena);
+  offsets.swap(compactOffsets);
+  loginHashes.swap(compactHashes);
+  generations.swap(compactGenerations);
+  flags.swap(compactFlags);
+  garbageBytes = 0;
+  rebuildIndex(index.size());
+}
+
+size_t UserStore::memoryBytes() const {
+  return arena.capacity() +
+         (offsets.capacity() + loginHashes.capacity() +
+          generations.capacity() + index.capacity()) *
+             sizeof(uint32_t) +
+         flags.capacity();
+}
@@ -0,0 +1,69 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "breach_filter.h"
+
+using namespace std;
+
+// Сборка фильтра утёкших паролей из текстового списка (по паролю в строке).
+// Использование: breach_filter_builder <список.txt> <фильтр.bin>
+int main(int argc, char* argv[]) {
+  if (argc != 3) {
+    cerr << "Использование: " << argv[0] << " <список.txt> <фильтр.bin>"
+         << endl;
+    return 1;
+  }
+
+  ifstream input(argv[1], ios::binary);
+  if (!input.is_open()) {
+    cerr << "Не удалось открыть " << argv[1] << endl;
+    return 1;
+  }
+
+  auto start = chrono::steady_clock::now();
+  vector<uint64_t> hashes;
+  string line;
+  size_t lines = 0;
+  while (getline(input, line)) {
+    if (line.empty()) continue;
+    hashes.push_back(BreachFilterFormat::hashPassword(line));
+    lines++;
+  }
+
+  string error;
+  if (!BreachFilterBuilder::build(hashes, argv[2], error)) {
+    cerr << "Ошибка: " << error << endl;
+    return 1;
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  BreachFilter filter;
+  if (!filter.open(argv[2], error)) {
+    cerr << "Ошибка проверки результата: " << error << endl;
+    return 1;
+  }
+
+  // Эмпирическая оценка доли ложных срабатываний на случайных строках
+  mt19937_64 rng(1);
+  const size_t PROBES = 1000000;
+  size_t falsePositives = 0;
+  for (size_t i = 0; i < PROBES; ++i) {
+    falsePositives += filter.contains("probe-" + to_string(rng()));
+  }
+
+  cout << "Строк: " << lines << ", уникальных паролей: "
+       << filter.entryCount() << endl;
+  cout << "Размер фильтра: " << filter.sizeBytes() << " байт ("
+       << double(filter.sizeBytes()) / max<uint64_t>(filter.entryCount(), 1)
+       << " байт на пароль)" << endl;
+  cout << "Время сборки: " << seconds << " с" << endl;
+  cout << "Ложные срабатывания: " << falsePositives << " из " << PROBES << " ("
+       << 100.0 * falsePositives / PROBES << "%, теоретически 0.0015%)"
+       << endl;
+  return 0;
+}
@@ -0,0 +1,239 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "session_recorder.h"
+#include "shared_attempt_table.h"
+
+using namespace std;
+
+// Массовое воспроизведение записанных сеансов (SecureCalculator --record)
+// для замера пропускной способности меню. Каждый сеанс — отдельный процесс
+// SecureCalculator с --replay на свежей копии базы в своём каталоге, так
+// что сеансы не видят изменений друг друга и не трогают рабочую базу.
+// Общая таблица попыток привязана к пути базы, так что у каждого слота она
+// своя; перед сеансом она удаляется, и счётчики начинаются с нуля.
+//
+// Использование:
+//   session_replay --binary SecureCalculator --db users.dat [--jobs N]
+//                  [--repeat K] [--paced] [--output F] запись...
+// --jobs — сколько сеансов идёт одновременно, --repeat — сколько раз
+// проигрывается каждая запись, --paced — с исходными паузами.
+
+namespace {
+
+using Clock = chrono::steady_clock;
+
+struct Config {
+  string binary;
+  string database;
+  size_t jobs = 16;
+  size_t repeat = 1;
+  bool paced = false;
+  string output = "session_replay.json";
+  vector<string> recordings;
+};
+
+struct Slot {
+  string directory;  // База и журнал; процесс работает в directory/sub
+  pid_t pid = 0;
+  Clock::time_point started;
+};
+
+bool parseArgs(int argc, char* argv[], Config& config) {
+  for (int i = 1; i < argc; ++i) {
+    bool hasValue = i + 1 < argc;
+    if (strcmp(argv[i], "--binary") == 0 && hasValue) {
+      config.binary = argv[++i];
+    } else if (strcmp(argv[i], "--db") == 0 && hasValue) {
+      config.database = argv[++i];
+    } else if (strcmp(argv[i], "--jobs") == 0 && hasValue) {
+      config.jobs = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--repeat") == 0 && hasValue) {
+      config.repeat = strtoull(argv[++i], nullptr, 10);
+    } else if (strcmp(argv[i], "--output") == 0 && hasValue) {
+      config.output = argv[++i];
+    } else if (strcmp(argv[i], "--paced") == 0) {
+      config.paced = true;
+    } else if (strncmp(argv[i], "--", 2) == 0) {
+      return false;
+    } else {
+      config.recordings.push_back(argv[i]);
+    }
+  }
+  return !config.binary.empty() && !config.database.empty() &&
+         config.jobs > 0 && config.repeat > 0 && !config.recordings.empty();
+}
+
+bool isRecording(const string& path) {
+  ifstream file(path, ios::binary);
+  string header;
+  return getline(file, header) && header == SESSION_RECORD_MAGIC;
+}
+
+// Запускает сеанс в каталоге слота; база копируется заново
+pid_t launch(const Config& config, const Slot& slot, const string& recording) {
+  string database = slot.directory + "/users.dat";
+  shm_unlink(SharedAttemptTable::nameFor(database).c_str());
+  error_code copyError;
+  filesystem::copy_file(config.database, database,
+                        filesystem::copy_options::overwrite_existing,
+                        copyError);
+  if (copyError) return -1;
+
+  pid_t pid = fork();
+  if (pid != 0) return pid;
+
+  // Дочерний процесс: вывод меню никому не нужен
+  int null = open("/dev/null", O_RDWR);
+  if (null < 0 || chdir((slot.directory + "/sub").c_str()) != 0) _exit(127);
+  dup2(null, STDIN_FILENO);
+  dup2(null, STDOUT_FILENO);
+  dup2(null, STDERR_FILENO);
+  vector<const char*> args = {config.binary.c_str(), "--replay",
+                              recording.c_str()};
+  if (config.paced) args.push_back("--replay-paced");
+  args.push_back(nullptr);
+  execv(config.binary.c_str(), const_cast<char* const*>(args.data()));
+  _exit(127);
+}
+
+double percentile(const vector<double>& sorted, double q) {
+  if (sorted.empty()) return 0;
+  size_t index = static_cast<size_t>(q * (sorted.size() - 1));
+  return sorted[index];
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Config config;
+  if (!parseArgs(argc, argv, config)) {
+    cerr << "Использование: session_replay --binary SecureCalculator "
+            "--db users.dat [--jobs N] [--repeat K] [--paced] [--output F] "
+            "запись..."
+         << endl;
+    return 1;
+  }
+
+  // Процессы сеансов работают в своих каталогах: нужны абсолютные пути
+  config.binary = filesystem::absolute(config.binary);
+  for (string& recording : config.recordings) {
+    if (!isRecording(recording)) {
+      cerr << recording << ": не является записью сеанса" << endl;
+      return 1;
+    }
+    recording = filesystem::absolute(recording);
+  }
+
+  char rootTemplate[] = "/tmp/session_replay_XXXXXX";
+  if (!mkdtemp(rootTemplate)) {
+    cerr << "Не удалось создать временный каталог" << endl;
+    return 1;
+  }
+  string root = rootTemplate;
+  vector<Slot> slots(config.jobs);
+  for (size_t i = 0; i < slots.size(); ++i) {
+    slots[i].directory = root + "/" + to_string(i);
+    filesystem::create_directories(slots[i].directory + "/sub");
+  }
+
+  size_t total = config.recordings.size() * config.repeat;
+  size_t launched = 0;
+  size_t running = 0;
+  map<string, size_t> outcomes;
+  vector<double> latencies;  // Миллисекунды на сеанс
+  latencies.reserve(total);
+
+  auto start = Clock::now();
+  while (launched < total || running > 0) {
+    for (Slot& slot : slots) {
+      if (slot.pid != 0 || launched == total) continue;
+      const string& recording =
+          config.recordings[launched % config.recordings.size()];
+      ++launched;
+      slot.pid = launch(config, slot, recording);
+      if (slot.pid <= 0) {
+        slot.pid = 0;
+        outcomes["launch_failed"]++;
+        continue;
+      }
+      slot.started = Clock::now();
+      ++running;
+    }
+    if (running == 0) continue;
+
+    int status = 0;
+    pid_t finished = wait(&status);
+    if (finished < 0) break;
+    auto now = Clock::now();
+    for (Slot& slot : slots) {
+      if (slot.pid != finished) continue;
+      slot.pid = 0;
+      --running;
+      latencies.push_back(
+          chrono::duration<double, milli>(now - slot.started).count());
+      if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        outcomes["completed"]++;
+      } else if (WIFEXITED(status) &&
+                 WEXITSTATUS(status) == SessionReplayer::EXHAUSTED_EXIT_CODE) {
+        outcomes["recording_exhausted"]++;
+      } else {
+        outcomes["failed"]++;
+      }
+    }
+  }
+  double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+  sort(latencies.begin(), latencies.end());
+  double throughput = seconds > 0 ? latencies.size() / seconds : 0;
+  cout << "Сеансов: " << latencies.size() << " за " << seconds << " с ("
+       << throughput << " сеансов/с, параллельно " << config.jobs << ")"
+       << endl;
+  cout << "Время сеанса, мс: p50=" << percentile(latencies, 0.50)
+       << " p90=" << percentile(latencies, 0.90)
+       << " p99=" << percentile(latencies, 0.99)
+       << " max=" << (latencies.empty() ? 0 : latencies.back()) << endl;
+  for (const auto& [outcome, count] : outcomes) {
+    cout << "  " << outcome << ": " << count << endl;
+  }
+
+  ofstream out(config.output);
+  out << "{\n  \"sessions\": " << latencies.size()
+      << ",\n  \"jobs\": " << config.jobs
+      << ",\n  \"paced\": " << (config.paced ? "true" : "false")
+      << ",\n  \"seconds\": " << seconds
+      << ",\n  \"sessions_per_second\": " << throughput
+      << ",\n  \"latency_ms\": {\"p50\": " << percentile(latencies, 0.50)
+      << ", \"p90\": " << percentile(latencies, 0.90)
+      << ", \"p99\": " << percentile(latencies, 0.99)
+      << ", \"max\": " << (latencies.empty() ? 0 : latencies.back())
+      << "},\n  \"outcomes\": {";
+  bool first = true;
+  for (const auto& [outcome, count] : outcomes) {
+    out << (first ? "" : ", ") << "\"" << outcome << "\": " << count;
+    first = false;
+  }
+  out << "}\n}\n";
+  cout << "Результаты записаны в " << config.output << endl;
+
+  error_code ignored;
+  for (const Slot& slot : slots) {
+    shm_unlink(
+        SharedAttemptTable::nameFor(slot.directory + "/users.dat").c_str());
+  }
+  filesystem::remove_all(root, ignored);
+  return outcomes.count("failed") || outcomes.count("launch_failed") ? 1 : 0;
+}
@@ -0,0 +1,73 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "strength_estimator.h"
+
+using namespace std;
+
+// Сборка таблицы частот для оценки стойкости паролей.
+// Каждый список — слова по убыванию частоты, по одному в строке (всё после
+// первого пробела игнорируется, так что подходят и списки «слово частота»).
+// Использование: strength_table_builder <таблица.bin> <список.txt>...
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    cerr << "Использование: " << argv[0]
+         << " <таблица.bin> <список.txt> [<список.txt>...]" << endl;
+    return 1;
+  }
+
+  auto start = chrono::steady_clock::now();
+  vector<vector<string>> lists;
+  size_t lines = 0;
+  for (int i = 2; i < argc; ++i) {
+    ifstream input(argv[i]);
+    if (!input.is_open()) {
+      cerr << "Не удалось открыть " << argv[i] << endl;
+      return 1;
+    }
+    vector<string> words;
+    string line;
+    while (getline(input, line)) {
+      size_t end = line.find_first_of(" \t\r");
+      if (end != string::npos) line.resize(end);
+      if (line.empty()) continue;
+      words.push_back(line);
+      lines++;
+    }
+    lists.push_back(std::move(words));
+  }
+
+  StrengthTableHeader header;
+  vector<StrengthTableSlot> slots;
+  StrengthTable::buildSlots(lists, header, slots);
+
+  ofstream out(argv[1], ios::binary | ios::trunc);
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(reinterpret_cast<const char*>(slots.data()),
+            slots.size() * sizeof(StrengthTableSlot));
+  out.close();
+  if (!out.good()) {
+    cerr << "Ошибка записи в файл: " << argv[1] << endl;
+    return 1;
+  }
+  double seconds =
+      chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  StrengthTable table;
+  string error;
+  if (!table.open(argv[1], error)) {
+    cerr << "Ошибка проверки результата: " << error << endl;
+    return 1;
+  }
+
+  cout << "Списков: " << lists.size() << ", строк: " << lines
+       << ", уникальных слов: " << table.entryCount() << endl;
+  cout << "Размер таблицы: "
+       << sizeof(header) + slots.size() * sizeof(StrengthTableSlot)
+       << " байт, самое длинное слово: " << table.maxWordLength() << endl;
+  cout << "Время сборки: " << seconds << " с" << endl;
+  return 0;
+}